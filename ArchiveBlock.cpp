@@ -0,0 +1,519 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "ArchiveBlock.h"
+
+#include <cmath>
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+using namespace std;
+
+// integers up to this magnitude are exact as double
+constexpr static double MAX_EXACT_INTEGER = 9007199254740992.0;
+
+/// @brief Writes bits to a byte array, the most significant bit first.
+class BitWriter
+{
+public:
+    /// @brief Constructor.
+    /// @param data The byte array the bits are appended to.
+    BitWriter(ArchiveBlock::byte_array_type & data) : _data(data) { }
+
+    /// @brief Writes the lowest bits of a value.
+    /// @param value The value.
+    /// @param numberOfBits The number of bits (0 ... 64).
+    void WriteBits(uint64_t value, int numberOfBits)
+    {
+        for (int bit = numberOfBits - 1; bit >= 0; bit--)
+        {
+            if (_bitPosition == 0)
+                _data.push_back(0);
+
+            if ((value >> bit) & 1)
+                _data.back() |= (uint8_t)(0x80 >> _bitPosition);
+
+            _bitPosition = (_bitPosition + 1) % 8;
+        }
+    }
+
+    /// @brief Writes an unsigned integer with 7 bits per byte, small values need less bytes.
+    /// @param value The value.
+    void WriteVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            WriteBits((value & 0x7F) | 0x80, 8);
+            value >>= 7;
+        }
+
+        WriteBits(value, 8);
+    }
+
+private:
+    ArchiveBlock::byte_array_type & _data;
+    int _bitPosition = 0;
+};
+
+/// @brief Reads bits from a byte array, the most significant bit first.
+class BitReader
+{
+public:
+    /// @brief Constructor.
+    /// @param data The byte array.
+    /// @param size The size of the byte array.
+    BitReader(const uint8_t * data, size_t size) : _data(data), _size(size) { }
+
+    /// @brief Reads bits.
+    /// @param numberOfBits The number of bits (0 ... 64).
+    /// @return The bits as the lowest bits of the value.
+    uint64_t ReadBits(int numberOfBits)
+    {
+        uint64_t value = 0;
+
+        for (int bit = 0; bit < numberOfBits; bit++)
+        {
+            if (_bytePosition >= _size)
+                throw ArchiveBlock::Error("the block is truncated");
+
+            value = (value << 1) | ((_data[_bytePosition] >> (7 - _bitPosition)) & 1);
+
+            if (++_bitPosition == 8)
+            {
+                _bitPosition = 0;
+                _bytePosition++;
+            }
+        }
+
+        return value;
+    }
+
+    /// @brief Reads a bit.
+    /// @return True if the bit is set.
+    bool ReadBit() { return ReadBits(1) != 0; }
+
+    /// @brief Reads an unsigned integer written by BitWriter::WriteVarint.
+    /// @return The value.
+    uint64_t ReadVarint()
+    {
+        uint64_t value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            uint64_t byte = ReadBits(8);
+            value |= (byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+
+        throw ArchiveBlock::Error("invalid varint");
+    }
+
+private:
+    const uint8_t * _data;
+    size_t _size;
+    size_t _bytePosition = 0;
+    int _bitPosition = 0;
+};
+
+/// @brief Maps a signed integer to an unsigned integer, so small negative values are small too (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...).
+/// @param value The signed integer.
+/// @return The unsigned integer.
+static uint64_t ZigZagEncode(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+/// @brief Reverses ZigZagEncode.
+/// @param value The unsigned integer.
+/// @return The signed integer.
+static int64_t ZigZagDecode(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/// @brief Writes the difference of two consecutive time deltas, 1 bit if the period is regular.
+/// @param writer The bit writer.
+/// @param deltaOfDelta The difference of the time deltas.
+static void WriteDeltaOfDelta(BitWriter & writer, int64_t deltaOfDelta)
+{
+    uint64_t value = ZigZagEncode(deltaOfDelta);
+
+    if (value == 0)
+    {
+        writer.WriteBits(0b0, 1);
+    }
+    else if (value < (1 << 7))
+    {
+        writer.WriteBits(0b10, 2);
+        writer.WriteBits(value, 7);
+    }
+    else if (value < (1 << 12))
+    {
+        writer.WriteBits(0b110, 3);
+        writer.WriteBits(value, 12);
+    }
+    else
+    {
+        writer.WriteBits(0b111, 3);
+        writer.WriteVarint(value);
+    }
+}
+
+/// @brief Reads a difference of time deltas written by WriteDeltaOfDelta.
+/// @param reader The bit reader.
+/// @return The difference of the time deltas.
+static int64_t ReadDeltaOfDelta(BitReader & reader)
+{
+    if (!reader.ReadBit())
+        return 0;
+
+    if (!reader.ReadBit())
+        return ZigZagDecode(reader.ReadBits(7));
+
+    if (!reader.ReadBit())
+        return ZigZagDecode(reader.ReadBits(12));
+
+    return ZigZagDecode(reader.ReadVarint());
+}
+
+ArchiveBlock::ArchiveBlock(const std::vector<std::string> & columns, const std::vector<double> & unitsPerValue)
+: _columns(columns)
+, _unitsPerValue(unitsPerValue)
+, _values(columns.size())
+{
+}
+
+void ArchiveBlock::AddRow(time_t time, const std::vector<double> & values)
+{
+    if (values.size() != _columns.size())
+        throw Error(format("{} values for {} columns", values.size(), _columns.size()));
+
+    if (!_times.empty() && (time <= _times.back()))
+        throw Error(format("the rows are not ordered by time ({} after {})", time, _times.back()));
+
+    _times.push_back(time);
+
+    for (size_t column = 0; column < values.size(); column++)
+        _values[column].push_back(values[column]);
+}
+
+ArchiveBlock::ColumnEncoding ArchiveBlock::SelectColumnEncoding(size_t column, double & resolution) const
+{
+    double unitsPerValue = (column < _unitsPerValue.size()) ? _unitsPerValue[column] : 0.0;
+    bool isNull = true;
+
+    // the readings are computed either as raw value / units (e.g. the inverter and the meter) or as raw value * resolution
+    bool isUnitsDivided = unitsPerValue > 0.0;
+    bool isUnitsMultiplied = unitsPerValue > 0.0;
+    resolution = isUnitsMultiplied ? 1.0 / unitsPerValue : 0.0;
+
+    for (double value : _values[column])
+    {
+        if (isnan(value))
+            continue;
+
+        isNull = false;
+
+        if (!isUnitsDivided && !isUnitsMultiplied)
+            break;
+
+        double units = value * unitsPerValue;
+
+        if (!(fabs(units) < MAX_EXACT_INTEGER))
+        {
+            isUnitsDivided = isUnitsMultiplied = false;
+            continue;
+        }
+
+        double integer = (double)llround(units);
+
+        // -0.0 equals 0.0, but the integer 0 restores +0.0
+        if ((integer == 0.0) && signbit(value))
+        {
+            isUnitsDivided = isUnitsMultiplied = false;
+            continue;
+        }
+
+        isUnitsDivided = isUnitsDivided && (integer / unitsPerValue == value);
+        isUnitsMultiplied = isUnitsMultiplied && (integer * resolution == value);
+    }
+
+    if (isNull)
+        return CE_NULL;
+
+    if (isUnitsDivided)
+        return CE_UNITS_DIVIDED;
+
+    if (isUnitsMultiplied)
+        return CE_UNITS_MULTIPLIED;
+
+    return CE_XOR;
+}
+
+ArchiveBlock::byte_array_type ArchiveBlock::Encode() const
+{
+    byte_array_type data;
+    BitWriter writer(data);
+
+    writer.WriteBits(VERSION, 8);
+
+    writer.WriteVarint(_columns.size());
+    for (const auto & column : _columns)
+    {
+        writer.WriteVarint(column.size());
+        for (char c : column)
+            writer.WriteBits((uint8_t)c, 8);
+    }
+
+    size_t numberOfRows = _times.size();
+    writer.WriteVarint(numberOfRows);
+
+    // the first time, the first delta and then the change of the delta
+    uint64_t previousTime = 0;
+    uint64_t previousDelta = 0;
+
+    for (size_t row = 0; row < numberOfRows; row++)
+    {
+        uint64_t time = (uint64_t)_times[row];
+        uint64_t delta = time - previousTime;
+
+        if (row < 2)
+            writer.WriteVarint(ZigZagEncode((int64_t)delta));
+        else
+            WriteDeltaOfDelta(writer, (int64_t)(delta - previousDelta));
+
+        previousTime = time;
+        previousDelta = delta;
+    }
+
+    for (size_t column = 0; column < _columns.size(); column++)
+    {
+        const auto & values = _values[column];
+
+        double resolution;
+        ColumnEncoding encoding = SelectColumnEncoding(column, resolution);
+
+        writer.WriteBits(encoding, 2);
+        if (encoding == CE_NULL)
+            continue;
+
+        // the factor to restore the readings from the integers
+        if (encoding == CE_UNITS_DIVIDED)
+            writer.WriteBits(bit_cast<uint64_t>(_unitsPerValue[column]), 64);
+        else if (encoding == CE_UNITS_MULTIPLIED)
+            writer.WriteBits(bit_cast<uint64_t>(resolution), 64);
+
+        // a bit per row if the column has NULL readings
+        bool hasNull = any_of(values.begin(), values.end(), [](double value) { return isnan(value); });
+        writer.WriteBits(hasNull, 1);
+
+        if (hasNull)
+        {
+            for (double value : values)
+                writer.WriteBits(!isnan(value), 1);
+        }
+
+        bool isFirst = true;
+        int64_t previousInteger = 0;
+        uint64_t previousBits = 0;
+        int previousLeadingZeros = -1;
+        int previousTrailingZeros = 0;
+
+        for (double value : values)
+        {
+            if (isnan(value))
+                continue;
+
+            if (encoding != CE_XOR)
+            {
+                // energy counters change slowly, the difference to the previous reading needs few bytes
+                int64_t integer = llround(value * _unitsPerValue[column]);
+                uint64_t delta = (uint64_t)integer - (uint64_t)previousInteger;
+
+                if (isFirst)
+                {
+                    writer.WriteVarint(ZigZagEncode(integer));
+                }
+                else if (delta == 0)
+                {
+                    writer.WriteBits(0b0, 1);
+                }
+                else
+                {
+                    writer.WriteBits(0b1, 1);
+                    writer.WriteVarint(ZigZagEncode((int64_t)delta));
+                }
+
+                previousInteger = integer;
+                isFirst = false;
+                continue;
+            }
+
+            // the XOR of similar floating point values has many leading and trailing zeros, only the bits between are written
+            uint64_t bits = bit_cast<uint64_t>(value);
+            uint64_t xorBits = bits ^ previousBits;
+
+            if (isFirst)
+            {
+                writer.WriteBits(bits, 64);
+            }
+            else if (xorBits == 0)
+            {
+                writer.WriteBits(0b0, 1);
+            }
+            else
+            {
+                int leadingZeros = min(countl_zero(xorBits), 31);
+                int trailingZeros = countr_zero(xorBits);
+
+                if ((previousLeadingZeros >= 0) && (leadingZeros >= previousLeadingZeros) && (trailingZeros >= previousTrailingZeros))
+                {
+                    // the bits fit into the window of the previous value
+                    writer.WriteBits(0b10, 2);
+                    writer.WriteBits(xorBits >> previousTrailingZeros, 64 - previousLeadingZeros - previousTrailingZeros);
+                }
+                else
+                {
+                    int numberOfBits = 64 - leadingZeros - trailingZeros;
+
+                    writer.WriteBits(0b11, 2);
+                    writer.WriteBits(leadingZeros, 5);
+                    writer.WriteBits(numberOfBits - 1, 6);
+                    writer.WriteBits(xorBits >> trailingZeros, numberOfBits);
+
+                    previousLeadingZeros = leadingZeros;
+                    previousTrailingZeros = trailingZeros;
+                }
+            }
+
+            previousBits = bits;
+            isFirst = false;
+        }
+    }
+
+    return data;
+}
+
+ArchiveBlock ArchiveBlock::Decode(const uint8_t * data, size_t size)
+{
+    BitReader reader(data, size);
+
+    uint64_t version = reader.ReadBits(8);
+    if (version != VERSION)
+        throw Error(format("unsupported version {}", version));
+
+    vector<string> columns(reader.ReadVarint());
+    for (auto & column : columns)
+    {
+        column.resize(reader.ReadVarint());
+        for (char & c : column)
+            c = (char)reader.ReadBits(8);
+    }
+
+    ArchiveBlock block(columns);
+
+    size_t numberOfRows = reader.ReadVarint();
+    block._times.resize(numberOfRows);
+
+    uint64_t previousTime = 0;
+    uint64_t previousDelta = 0;
+
+    for (size_t row = 0; row < numberOfRows; row++)
+    {
+        uint64_t delta = (row < 2) ? (uint64_t)ZigZagDecode(reader.ReadVarint()) : previousDelta + (uint64_t)ReadDeltaOfDelta(reader);
+
+        previousTime += delta;
+        previousDelta = delta;
+        block._times[row] = (time_t)previousTime;
+    }
+
+    for (auto & values : block._values)
+    {
+        values.assign(numberOfRows, numeric_limits<double>::quiet_NaN());
+
+        auto encoding = (ColumnEncoding)reader.ReadBits(2);
+        if (encoding == CE_NULL)
+            continue;
+
+        double factor = (encoding != CE_XOR) ? bit_cast<double>(reader.ReadBits(64)) : 0.0;
+
+        vector<bool> isPresent(numberOfRows, true);
+        if (reader.ReadBit())
+        {
+            for (size_t row = 0; row < numberOfRows; row++)
+                isPresent[row] = reader.ReadBit();
+        }
+
+        bool isFirst = true;
+        int64_t previousInteger = 0;
+        uint64_t previousBits = 0;
+        int previousLeadingZeros = 0;
+        int previousTrailingZeros = 0;
+
+        for (size_t row = 0; row < numberOfRows; row++)
+        {
+            if (!isPresent[row])
+                continue;
+
+            if (encoding != CE_XOR)
+            {
+                if (isFirst)
+                    previousInteger = ZigZagDecode(reader.ReadVarint());
+                else if (reader.ReadBit())
+                    previousInteger = (int64_t)((uint64_t)previousInteger + (uint64_t)ZigZagDecode(reader.ReadVarint()));
+
+                values[row] = (encoding == CE_UNITS_DIVIDED) ? previousInteger / factor : previousInteger * factor;
+                isFirst = false;
+                continue;
+            }
+
+            if (isFirst)
+            {
+                previousBits = reader.ReadBits(64);
+            }
+            else if (reader.ReadBit())
+            {
+                if (reader.ReadBit())
+                {
+                    previousLeadingZeros = (int)reader.ReadBits(5);
+                    int numberOfBits = (int)reader.ReadBits(6) + 1;
+                    previousTrailingZeros = 64 - previousLeadingZeros - numberOfBits;
+
+                    if (previousTrailingZeros < 0)
+                        throw Error("invalid floating point value");
+                }
+
+                previousBits ^= reader.ReadBits(64 - previousLeadingZeros - previousTrailingZeros) << previousTrailingZeros;
+            }
+
+            values[row] = bit_cast<double>(previousBits);
+            isFirst = false;
+        }
+    }
+
+    return block;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <format>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+
+/// @brief A compressed block of readings (e.g. one day of a readings table).
+/// The times are encoded as delta of delta (one bit for a regular period), the readings column by column:
+/// readings that are integers of a resolution (e.g. energy counters) as varint of the difference to the previous reading,
+/// the other readings as XOR of the previous floating point value. The encoding is lossless.
+class ArchiveBlock
+{
+public:
+
+    typedef std::vector<uint8_t> byte_array_type;
+
+    /// @brief Archive block error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("Archive block error: {}", errorMessage)) { }
+    };
+
+    /// @brief Creates an empty block.
+    /// @param columns The column names.
+    /// @param unitsPerValue Optional, the resolution of the columns as units per value (e.g. 10 for 0.1 V, 0 if unknown).
+    /// A column is encoded as integers if all its readings are integer multiples of the resolution.
+    ArchiveBlock(const std::vector<std::string> & columns, const std::vector<double> & unitsPerValue = {});
+
+    /// @brief Decodes a block.
+    /// @param data The encoded block.
+    /// @param size The size of the encoded block in bytes.
+    /// @return The block.
+    static ArchiveBlock Decode(const uint8_t * data, size_t size);
+
+    /// @brief Encodes the block.
+    /// @return The encoded block.
+    byte_array_type Encode() const;
+
+    /// @brief Adds a row. The rows must be added in the order of the time.
+    /// @param time The time of the readings.
+    /// @param values The readings in the order of the columns (NaN if NULL).
+    void AddRow(time_t time, const std::vector<double> & values);
+
+    /// @brief Returns the column names.
+    /// @return The column names.
+    const std::vector<std::string> & GetColumns() const { return _columns; }
+
+    /// @brief Returns the number of rows.
+    /// @return The number of rows.
+    size_t GetNumberOfRows() const { return _times.size(); }
+
+    /// @brief Returns the time of a row.
+    /// @param row The row index.
+    /// @return The time.
+    time_t GetTime(size_t row) const { return _times[row]; }
+
+    /// @brief Returns a reading.
+    /// @param row The row index.
+    /// @param column The column index.
+    /// @return The reading (NaN if NULL).
+    double GetValue(size_t row, size_t column) const { return _values[column][row]; }
+
+private:
+
+    // the version of the encoding, stored in the first byte
+    constexpr static uint8_t VERSION = 1;
+
+    /// @brief The encoding of a column.
+    enum ColumnEncoding
+    {
+        CE_NULL = 0,                // all readings are NULL
+        CE_XOR = 1,                 // XOR of the previous floating point value
+        CE_UNITS_DIVIDED = 2,       // integers, reading = integer / units per value
+        CE_UNITS_MULTIPLIED = 3     // integers, reading = integer * resolution
+    };
+
+    std::vector<std::string> _columns;
+    std::vector<double> _unitsPerValue;
+
+    std::vector<time_t> _times;
+
+    // the readings column by column
+    std::vector<std::vector<double>> _values;
+
+    /// @brief Selects the encoding of a column.
+    /// @param column The column index.
+    /// @param resolution Returns the resolution for CE_UNITS_MULTIPLIED.
+    /// @return The encoding.
+    ColumnEncoding SelectColumnEncoding(size_t column, double & resolution) const;
+};
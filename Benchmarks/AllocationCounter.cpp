@@ -0,0 +1,74 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "AllocationCounter.h"
+
+#include <new>
+#include <cstdlib>
+#include <atomic>
+
+using namespace std;
+
+static atomic<size_t> AllocationCount = 0;
+
+void * operator new(size_t size)
+{
+    AllocationCount.fetch_add(1, memory_order_relaxed);
+
+    void * pointer = malloc(size > 0 ? size : 1);
+    if (pointer == nullptr)
+        throw bad_alloc();
+
+    return pointer;
+}
+
+void * operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void * pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void * pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void * pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+size_t AllocationCounter::GetAllocationCount()
+{
+    return AllocationCount.load(memory_order_relaxed);
+}
@@ -0,0 +1,208 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+// Checks the table driven checksums against a bitwise reference implementation and
+// compares the throughput of the bitwise, slice-by-1, slice-by-4 and slice-by-8 variants.
+// Usage: BenchmarkChecksum [megabytes]
+// Returns 1 if a table driven or an incremental checksum differs from the reference.
+
+#include "Checksum.h"
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+using namespace std;
+
+/// @brief Receives the checksums, so that the compiler cannot remove the measured calculations.
+static volatile unsigned ChecksumSink = 0;
+
+/// @brief Bitwise reference of a non reflected 8 bit CRC.
+static uint8_t BitwiseCrc8(uint8_t polynomial, uint8_t crc, span<const uint8_t> data)
+{
+    for (uint8_t b : data)
+    {
+        crc ^= b;
+
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ polynomial) : static_cast<uint8_t>(crc << 1);
+    }
+
+    return crc;
+}
+
+/// @brief Bitwise reference of a reflected 16 bit CRC.
+static uint16_t BitwiseReflectedCrc16(uint16_t polynomial, uint16_t crc, span<const uint8_t> data)
+{
+    for (uint8_t b : data)
+    {
+        crc ^= b;
+
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ polynomial) : static_cast<uint16_t>(crc >> 1);
+    }
+
+    return crc;
+}
+
+/// @brief One checksum with its reference and the table driven variants.
+template <typename T>
+struct Algorithm
+{
+    const char * Name;
+    T StartValue;
+    T (*Bitwise)(T crc, span<const uint8_t> data);
+    T (*Slice1)(T crc, span<const uint8_t> data);
+    T (*Slice4)(T crc, span<const uint8_t> data);
+    T (*Slice8)(T crc, span<const uint8_t> data);
+};
+
+static const Algorithm<uint8_t> CRC8_HOYMILES =
+{
+    "CRC8 Hoymiles", Checksum::CRC8_HOYMILES_START_VALUE,
+    [](uint8_t crc, span<const uint8_t> data) { return BitwiseCrc8(0x01, crc, data); },
+    Checksum::UpdateCrc8Hoymiles<1>, Checksum::UpdateCrc8Hoymiles<4>, Checksum::UpdateCrc8Hoymiles<8>
+};
+
+static const Algorithm<uint16_t> CRC16_MODBUS =
+{
+    "CRC16 Modbus", Checksum::CRC16_MODBUS_START_VALUE,
+    [](uint16_t crc, span<const uint8_t> data) { return BitwiseReflectedCrc16(0xA001, crc, data); },
+    Checksum::UpdateCrc16Modbus<1>, Checksum::UpdateCrc16Modbus<4>, Checksum::UpdateCrc16Modbus<8>
+};
+
+static const Algorithm<uint16_t> CRC16_X25 =
+{
+    "CRC16 X25", Checksum::CRC16_X25_START_VALUE,
+    [](uint16_t crc, span<const uint8_t> data) { return BitwiseReflectedCrc16(0x8408, crc, data); },
+    Checksum::UpdateCrc16X25<1>, Checksum::UpdateCrc16X25<4>, Checksum::UpdateCrc16X25<8>
+};
+
+/// @brief Compares all variants with the reference for every length up to 300 bytes,
+/// in one piece and incrementally in random chunks.
+/// @return The number of mismatches.
+template <typename T>
+static size_t CheckAlgorithm(const Algorithm<T> & algorithm, const vector<uint8_t> & data, mt19937 & random)
+{
+    size_t mismatches = 0;
+
+    for (size_t size = 0; size <= 300; size++)
+    {
+        span<const uint8_t> message(data.data(), size);
+        T expected = algorithm.Bitwise(algorithm.StartValue, message);
+
+        for (auto update : { algorithm.Slice1, algorithm.Slice4, algorithm.Slice8 })
+        {
+            if (update(algorithm.StartValue, message) != expected)
+                mismatches++;
+
+            // incremental update in chunks of 0 to 20 bytes
+            T crc = algorithm.StartValue;
+            for (size_t position = 0; position < size; )
+            {
+                size_t chunkSize = min<size_t>(random() % 21, size - position);
+                crc = update(crc, message.subspan(position, chunkSize));
+                position += chunkSize;
+            }
+
+            if (crc != expected)
+                mismatches++;
+        }
+    }
+
+    if (mismatches > 0)
+        cerr << "error: " << algorithm.Name << ": " << mismatches << " mismatches" << endl;
+
+    return mismatches;
+}
+
+/// @brief Prints the throughput of one variant in MB/s for small (Hoymiles), medium (SML) and large messages.
+template <typename T>
+static void MeasureVariant(const char * name, T (*update)(T crc, span<const uint8_t> data), T startValue,
+    const vector<uint8_t> & data, size_t megabytes)
+{
+    cout << "    " << name << ":";
+
+    for (size_t messageSize : { 27, 400, 4096 })
+    {
+        size_t iterations = megabytes * 1000000 / messageSize;
+        unsigned sum = 0;
+
+        auto startTime = chrono::steady_clock::now();
+
+        for (size_t iteration = 0; iteration < iterations; iteration++)
+            sum += update(startValue, span<const uint8_t>(data.data() + (iteration % 64), messageSize));
+
+        chrono::duration<double> duration = chrono::steady_clock::now() - startTime;
+
+        ChecksumSink = ChecksumSink + sum;
+
+        cout << " " << messageSize << " B " << (iterations * messageSize / 1E6) / duration.count() << " MB/s";
+    }
+
+    cout << endl;
+}
+
+/// @brief Prints the throughput of all variants of one checksum.
+template <typename T>
+static void MeasureAlgorithm(const Algorithm<T> & algorithm, const vector<uint8_t> & data, size_t megabytes)
+{
+    cout << algorithm.Name << endl;
+
+    MeasureVariant("bitwise   ", algorithm.Bitwise, algorithm.StartValue, data, megabytes);
+    MeasureVariant("slice-by-1", algorithm.Slice1, algorithm.StartValue, data, megabytes);
+    MeasureVariant("slice-by-4", algorithm.Slice4, algorithm.StartValue, data, megabytes);
+    MeasureVariant("slice-by-8", algorithm.Slice8, algorithm.StartValue, data, megabytes);
+}
+
+int main(int argc, char * argv[])
+{
+    size_t megabytes = (argc > 1) ? stoul(argv[1]) : 20;
+
+    mt19937 random(1);
+    vector<uint8_t> data(4096 + 64);
+    for (uint8_t & b : data)
+        b = static_cast<uint8_t>(random());
+
+    size_t mismatches = CheckAlgorithm(CRC8_HOYMILES, data, random)
+        + CheckAlgorithm(CRC16_MODBUS, data, random)
+        + CheckAlgorithm(CRC16_X25, data, random);
+
+    if (mismatches > 0)
+        return EXIT_FAILURE;
+
+    cout << "all variants match the bitwise reference" << endl;
+
+    if (megabytes > 0)
+    {
+        MeasureAlgorithm(CRC8_HOYMILES, data, megabytes);
+        MeasureAlgorithm(CRC16_MODBUS, data, megabytes);
+        MeasureAlgorithm(CRC16_X25, data, megabytes);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,347 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+// Measures the CPU time per insert, including the commits of the batched transactions:
+// - the former insert: SQL text formatted with an ostringstream and executed with sqlite3_exec,
+// - a prepared insert statement without the rollup updates,
+// - the Database class with the rollup updates, for REAL and for compact (scaled integer) storage.
+// Usage: BenchmarkDatabaseInsert [samples] [samples per transaction] [database file]
+// Every sample inserts one row per electricity meter and one inverter row. The database file is overwritten.
+
+#include "Database.h"
+#include "ReadingsRecord.h"
+#include "ObisRegistry.h"
+#include "OnScopeExit.h"
+
+#include <sqlite3.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+using namespace std;
+
+constexpr static int NUMBER_OF_INVERTER_CHANNELS = 2;
+
+/// @brief Returns the CPU time of the process.
+/// @return The CPU time in s.
+static double GetCpuTime()
+{
+    timespec cpuTime;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuTime);
+
+    return cpuTime.tv_sec + cpuTime.tv_nsec / 1E9;
+}
+
+/// @brief Creates meter readings like the eBZ DD3 sends them (energy in 1E-8 kWh, power in 0.01 W).
+static void CreateMeterReadings(ReadingsRecord & readings, size_t sample)
+{
+    readings.Clear();
+
+    double energy = (1234567890123.0 + sample * 2345.0) / 1E8;
+
+    readings.Values[ObisRegistry::BR_PLUS_A] = energy;
+    readings.Values[ObisRegistry::BR_PLUS_A_T1] = energy;
+    readings.Values[ObisRegistry::BR_PLUS_A_T2] = 0.0;
+    readings.Values[ObisRegistry::BR_MINUS_A] = (987654321.0 + sample * 17.0) / 1E8;
+    readings.Values[ObisRegistry::BR_POWER] = (123456.0 + sample % 1000) / 1E2;
+    readings.Values[ObisRegistry::BR_POWER_L1] = (41152.0 + sample % 100) / 1E2;
+    readings.Values[ObisRegistry::BR_POWER_L2] = 41152.0 / 1E2;
+    readings.Values[ObisRegistry::BR_POWER_L3] = -(41152.0 + sample % 10) / 1E2;
+}
+
+/// @brief Creates inverter readings like the Hoymiles HM-600 sends them.
+static void CreateInverterReadings(ReadingsRecord & readings, size_t sample)
+{
+    readings.Clear();
+
+    for (int channel = 0; channel < NUMBER_OF_INVERTER_CHANNELS; channel++)
+    {
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_VOLTAGE)] = 312 / 10.0;
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_CURRENT)] = (700 + sample % 50) / 100.0;
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_POWER)] = (2200 + sample % 500) / 10.0;
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_ENERGY_DAY)] = (double)(sample / 10);
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_ENERGY_TOTAL)] = (1234567 + sample / 10) / 1000.0;
+    }
+
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_VOLTAGE)] = 2301 / 10.0;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_CURRENT)] = (190 + sample % 10) / 100.0;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_FREQUENCY)] = 5001 / 100.0;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_POWER)] = (4300 + sample % 900) / 10.0;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_REACTIVE_POWER)] = 0.0;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_POWER_FACTOR)] = 1000 / 1000.0;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_TEMPERATURE)] = 351 / 10.0;
+}
+
+/// @brief How the readings are inserted without the Database class.
+enum InsertMethod
+{
+    // SQL text formatted with an ostringstream, executed with sqlite3_exec (the former Database insert)
+    IM_SQL_TEXT,
+
+    // a prepared insert statement, bound, stepped and reset
+    IM_PREPARED
+};
+
+/// @brief A readings table for the inserts without the Database class.
+struct ReadingsTable
+{
+    std::string Name;
+
+    // the columns (without "time") and the indices of their readings in the readings record
+    std::vector <std::string> Columns;
+    std::vector <size_t> RecordIndices;
+
+    sqlite3_stmt * InsertStatement = nullptr;
+};
+
+/// @brief Removes the database file and the write ahead log.
+static void RemoveDatabase(const string & fileName)
+{
+    remove(fileName.c_str());
+    remove((fileName + "-wal").c_str());
+    remove((fileName + "-shm").c_str());
+}
+
+/// @brief Executes an SQL command and throws an exception on error.
+static void Execute(sqlite3 * database, const string & sql)
+{
+    char * errorMessage = nullptr;
+
+    if (sqlite3_exec(database, sql.c_str(), nullptr, nullptr, &errorMessage) != SQLITE_OK)
+    {
+        string message = errorMessage ? errorMessage : "unknown error";
+        sqlite3_free(errorMessage);
+        throw runtime_error(message);
+    }
+}
+
+/// @brief Returns the readings tables with the columns in the order the Database class creates them.
+static vector <ReadingsTable> GetReadingsTables()
+{
+    vector <ReadingsTable> tables(3);
+    tables[0].Name = "ElectricityMeter0";
+    tables[1].Name = "ElectricityMeter1";
+    tables[2].Name = "Inverter";
+
+    for (size_t idx = 0; idx < ObisRegistry::NUMBER_OF_BUILTIN_READINGS; idx++)
+    {
+        for (size_t tableIdx = 0; tableIdx < 2; tableIdx++)
+        {
+            tables[tableIdx].Columns.push_back(string(ObisRegistry::BUILTIN_ENTRIES[idx].Name));
+            tables[tableIdx].RecordIndices.push_back(idx);
+        }
+    }
+
+    for (int channel = 0; channel < NUMBER_OF_INVERTER_CHANNELS; channel++)
+    {
+        for (int reading = 0; reading < ReadingsRecord::NUMBER_OF_INVERTER_CHANNEL_READINGS; reading++)
+        {
+            tables[2].Columns.push_back("CH" + to_string(channel) + " " + ReadingsRecord::INVERTER_CHANNEL_READING_NAMES[reading]);
+            tables[2].RecordIndices.push_back(ReadingsRecord::InverterChannelIndex(channel, (ReadingsRecord::InverterChannelReading)reading));
+        }
+    }
+
+    for (int reading = 0; reading < ReadingsRecord::NUMBER_OF_INVERTER_READINGS; reading++)
+    {
+        tables[2].Columns.push_back(ReadingsRecord::INVERTER_READING_NAMES[reading]);
+        tables[2].RecordIndices.push_back(ReadingsRecord::InverterIndex((ReadingsRecord::InverterReading)reading));
+    }
+
+    return tables;
+}
+
+/// @brief Inserts the readings like the former Database insert: the SQL text is parsed and planned for every row.
+static void InsertSqlText(sqlite3 * database, const ReadingsTable & table, const ReadingsRecord & readings, time_t time)
+{
+    ostringstream os;
+    os << "INSERT INTO " << table.Name << " (\"time\"";
+
+    for (const auto & column : table.Columns)
+        os << ",\"" << column << "\"";
+
+    os << ") VALUES (" << time;
+
+    for (size_t recordIndex : table.RecordIndices)
+        os << "," << readings.Values[recordIndex];
+
+    os << ");";
+
+    Execute(database, os.str());
+}
+
+/// @brief Inserts the readings with the prepared insert statement of the table.
+static void InsertPrepared(sqlite3 * database, const ReadingsTable & table, const ReadingsRecord & readings, time_t time)
+{
+    sqlite3_bind_int64(table.InsertStatement, 1, time);
+
+    for (size_t idx = 0; idx < table.RecordIndices.size(); idx++)
+        sqlite3_bind_double(table.InsertStatement, (int)idx + 2, readings.Values[table.RecordIndices[idx]]);
+
+    int resultCode = sqlite3_step(table.InsertStatement);
+    sqlite3_reset(table.InsertStatement);
+
+    if (resultCode != SQLITE_DONE)
+        throw runtime_error(sqlite3_errmsg(database));
+}
+
+/// @brief Inserts the samples into the readings tables of a new database without the Database class
+/// (no rollup updates) and prints the CPU time per insert.
+static void MeasureInsertsWithoutRollups(const string & fileName, InsertMethod insertMethod, size_t numberOfSamples, size_t samplesPerTransaction)
+{
+    RemoveDatabase(fileName);
+
+    // the Database class creates the tables, they are filled with a connection of their own
+    {
+        Database database(fileName, NUMBER_OF_INVERTER_CHANNELS);
+    }
+
+    sqlite3 * database = nullptr;
+    OnScopeExit close([&] { sqlite3_close(database); });
+
+    if (sqlite3_open(fileName.c_str(), &database) != SQLITE_OK)
+        throw runtime_error("Can not open database " + fileName);
+
+    Execute(database, "PRAGMA journal_mode=WAL;");
+    Execute(database, "PRAGMA synchronous=NORMAL;");
+
+    vector <ReadingsTable> tables = GetReadingsTables();
+    OnScopeExit finalize([&] { for (auto & table : tables) sqlite3_finalize(table.InsertStatement); });
+
+    if (insertMethod == IM_PREPARED)
+    {
+        for (auto & table : tables)
+        {
+            string sql = "INSERT INTO " + table.Name + " (\"time\"";
+            string parameters = "?";
+
+            for (const auto & column : table.Columns)
+            {
+                sql += ",\"" + column + "\"";
+                parameters += ",?";
+            }
+
+            sql += ") VALUES (" + parameters + ");";
+
+            if (sqlite3_prepare_v3(database, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &table.InsertStatement, nullptr) != SQLITE_OK)
+                throw runtime_error(sqlite3_errmsg(database));
+        }
+    }
+
+    auto insert = (insertMethod == IM_PREPARED) ? InsertPrepared : InsertSqlText;
+
+    ReadingsRecord meterReadings, inverterReadings;
+    time_t startTime = 1760000000;
+
+    double cpuTime = GetCpuTime();
+
+    for (size_t sample = 0; sample < numberOfSamples; )
+    {
+        Execute(database, "BEGIN;");
+
+        for (size_t batchIndex = 0; (batchIndex < samplesPerTransaction) && (sample < numberOfSamples); batchIndex++, sample++)
+        {
+            time_t time = startTime + (time_t)sample * 30;
+
+            CreateMeterReadings(meterReadings, sample);
+            insert(database, tables[0], meterReadings, time);
+            insert(database, tables[1], meterReadings, time);
+
+            CreateInverterReadings(inverterReadings, sample);
+            insert(database, tables[2], inverterReadings, time);
+        }
+
+        Execute(database, "COMMIT;");
+    }
+
+    cpuTime = GetCpuTime() - cpuTime;
+
+    cout << ((insertMethod == IM_PREPARED) ? "prepared, no rollups:         " : "ostringstream + sqlite3_exec: ")
+        << cpuTime / (3.0 * numberOfSamples) * 1E6 << " us CPU per insert (" << 3 * numberOfSamples << " inserts)" << endl;
+}
+
+/// @brief Inserts the samples into a new database and prints the CPU time per insert.
+static void MeasureInserts(const string & fileName, bool isCompactStorage, size_t numberOfSamples, size_t samplesPerTransaction)
+{
+    RemoveDatabase(fileName);
+
+    Database database(fileName, NUMBER_OF_INVERTER_CHANNELS, {}, isCompactStorage);
+
+    ReadingsRecord meterReadings, inverterReadings;
+    time_t startTime = 1760000000;
+
+    double cpuTime = GetCpuTime();
+
+    for (size_t sample = 0; sample < numberOfSamples; )
+    {
+        database.BeginTransaction();
+
+        for (size_t batchIndex = 0; (batchIndex < samplesPerTransaction) && (sample < numberOfSamples); batchIndex++, sample++)
+        {
+            time_t time = startTime + (time_t)sample * 30;
+
+            CreateMeterReadings(meterReadings, sample);
+            database.InsertReadingsElectricityMeter(0, meterReadings, time);
+            database.InsertReadingsElectricityMeter(1, meterReadings, time);
+
+            CreateInverterReadings(inverterReadings, sample);
+            database.InsertReadingsInverter(inverterReadings, time);
+        }
+
+        database.CommitTransaction();
+    }
+
+    cpuTime = GetCpuTime() - cpuTime;
+
+    cout << (isCompactStorage ? "Database, compact storage:    " : "Database, REAL storage:       ")
+        << cpuTime / (3.0 * numberOfSamples) * 1E6 << " us CPU per insert ("
+        << 3 * numberOfSamples << " inserts, " << database.GetStatistics().ToString() << ")" << endl;
+}
+
+int main(int argc, char * argv[])
+{
+    size_t numberOfSamples = (argc > 1) ? stoul(argv[1]) : 10000;
+    size_t samplesPerTransaction = (argc > 2) ? max(stoul(argv[2]), (size_t)1) : 10;
+    string fileName = (argc > 3) ? argv[3] : "BenchmarkDatabaseInsert.db";
+
+    try
+    {
+        MeasureInsertsWithoutRollups(fileName, IM_SQL_TEXT, numberOfSamples, samplesPerTransaction);
+        MeasureInsertsWithoutRollups(fileName, IM_PREPARED, numberOfSamples, samplesPerTransaction);
+        MeasureInserts(fileName, false, numberOfSamples, samplesPerTransaction);
+        MeasureInserts(fileName, true, numberOfSamples, samplesPerTransaction);
+    }
+    catch (const exception & exc)
+    {
+        cerr << "error: " << exc.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+// Compares the decoding of one eBZ DD3 SML frame into the SmlData tree (DecodeSmlMessages)
+// with the non-allocating SmlFrameView / SmlView.
+// Usage: BenchmarkSml [iterations]
+// Returns 1 if both decoders disagree or if the view allocates heap memory.
+
+#include "AllocationCounter.h"
+#include "SmlDecoder.h"
+
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+
+using namespace std;
+
+/// @brief A GetList response frame of an eBZ DD3 (open, get list, close) with 10 values.
+static const SmlData::byte_array_type SML_FRAME =
+{
+    0x1B, 0x1B, 0x1B, 0x1B, 0x01, 0x01, 0x01, 0x01, 0x76, 0x03, 0x00, 0x01, 0x62, 0x00, 0x62, 0x00,
+    0x72, 0x63, 0x01, 0x01, 0x76, 0x01, 0x01, 0x06, 0x0A, 0x01, 0x45, 0x42, 0x5A, 0x0C, 0x0A, 0x01,
+    0x45, 0x42, 0x5A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x63, 0x12, 0x34, 0x00, 0x76,
+    0x03, 0x00, 0x02, 0x62, 0x00, 0x62, 0x00, 0x72, 0x63, 0x07, 0x01, 0x77, 0x01, 0x0C, 0x0A, 0x01,
+    0x45, 0x42, 0x5A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x72, 0x62, 0x01, 0x65, 0x00, 0x00,
+    0x30, 0x39, 0x7A, 0x77, 0x07, 0x81, 0x81, 0xC7, 0x82, 0x03, 0xFF, 0x01, 0x01, 0x62, 0x00, 0x52,
+    0x00, 0x04, 0x45, 0x42, 0x5A, 0x01, 0x77, 0x07, 0x01, 0x00, 0x00, 0x00, 0x09, 0xFF, 0x01, 0x01,
+    0x62, 0x00, 0x52, 0x00, 0x0C, 0x0A, 0x01, 0x45, 0x42, 0x5A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x77, 0x07, 0x01, 0x00, 0x01, 0x08, 0x00, 0xFF, 0x01, 0x01, 0x62, 0x1E, 0x52, 0xF8, 0x69,
+    0x00, 0x00, 0x01, 0x1F, 0x71, 0xFB, 0x04, 0xCB, 0x01, 0x77, 0x07, 0x01, 0x00, 0x01, 0x08, 0x01,
+    0xFF, 0x01, 0x01, 0x62, 0x1E, 0x52, 0xF8, 0x69, 0x00, 0x00, 0x00, 0x8F, 0xB8, 0xFD, 0x82, 0x65,
+    0x01, 0x77, 0x07, 0x01, 0x00, 0x01, 0x08, 0x02, 0xFF, 0x01, 0x01, 0x62, 0x1E, 0x52, 0xF8, 0x69,
+    0x00, 0x00, 0x00, 0x5F, 0xD0, 0xA9, 0x01, 0x99, 0x01, 0x77, 0x07, 0x01, 0x00, 0x02, 0x08, 0x00,
+    0xFF, 0x01, 0x01, 0x62, 0x1E, 0x52, 0xF8, 0x69, 0x00, 0x00, 0x00, 0x00, 0x3A, 0xDE, 0x68, 0xB1,
+    0x01, 0x77, 0x07, 0x01, 0x00, 0x10, 0x07, 0x00, 0xFF, 0x01, 0x01, 0x62, 0x1B, 0x52, 0xFE, 0x59,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xCF, 0xC7, 0x01, 0x77, 0x07, 0x01, 0x00, 0x24, 0x07, 0x00,
+    0xFF, 0x01, 0x01, 0x62, 0x1B, 0x52, 0xFE, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x13, 0x88,
+    0x01, 0x77, 0x07, 0x01, 0x00, 0x38, 0x07, 0x00, 0xFF, 0x01, 0x01, 0x62, 0x1B, 0x52, 0xFE, 0x59,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x38, 0x01, 0x77, 0x07, 0x01, 0x00, 0x4C, 0x07, 0x00,
+    0xFF, 0x01, 0x01, 0x62, 0x1B, 0x52, 0xFE, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07,
+    0x01, 0x01, 0x01, 0x63, 0x12, 0x34, 0x00, 0x76, 0x03, 0x00, 0x03, 0x62, 0x00, 0x62, 0x00, 0x72,
+    0x63, 0x02, 0x01, 0x71, 0x01, 0x63, 0x12, 0x34, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x1B, 0x1B, 0x1B,
+    0x1A, 0x03, 0x3C, 0x79,
+};
+
+constexpr static SmlPath VALUE_LIST_PATH("3.1.4");
+constexpr static size_t VALUE_INDEX = 5;
+
+/// @brief Decodes the frame into the SmlData tree and sums up all numeric values.
+static double SumValuesTree(const SmlData::byte_array_type & data)
+{
+    auto messages = DecodeSmlMessages(data);
+    const SmlData & valueList = messages.at(1).GetListItem(3).GetListItem(1).GetListItem(4);
+
+    double sum = 0;
+    for (const SmlData & dataSet : valueList.GetList())
+    {
+        const SmlData & value = dataSet.GetListItem(VALUE_INDEX);
+
+        if (value.IsUnsigned())
+            sum += static_cast<double>(value.GetUnsigned());
+        else if (value.IsInteger())
+            sum += static_cast<double>(value.GetInteger());
+    }
+
+    return sum;
+}
+
+/// @brief Walks the frame with the views and sums up all numeric values.
+static double SumValuesView(const SmlData::byte_array_type & data)
+{
+    SmlFrameView frame(data);
+    SmlView valueList = frame.FindMessage(SmlFrameView::GET_LIST_RESPONSE).Select(VALUE_LIST_PATH);
+
+    double sum = 0;
+    for (const SmlView & dataSet : valueList)
+    {
+        SmlView value = dataSet.GetListItem(VALUE_INDEX);
+
+        if (value.IsUnsigned())
+            sum += static_cast<double>(value.GetUnsigned());
+        else if (value.IsInteger())
+            sum += static_cast<double>(value.GetInteger());
+    }
+
+    return sum;
+}
+
+/// @brief Runs a decoder and prints the time and the heap allocations per frame.
+/// @return The number of heap allocations per frame.
+template <typename Decoder>
+static double Measure(const char * name, size_t iterations, Decoder decoder, double & checkSum)
+{
+    checkSum = decoder(SML_FRAME);
+
+    size_t allocations = AllocationCounter::GetAllocationCount();
+    auto startTime = chrono::steady_clock::now();
+
+    double sum = 0;
+    for (size_t iteration = 0; iteration < iterations; iteration++)
+        sum += decoder(SML_FRAME);
+
+    auto duration = chrono::duration<double, micro>(chrono::steady_clock::now() - startTime);
+    double allocationsPerFrame = static_cast<double>(AllocationCounter::GetAllocationCount() - allocations) / iterations;
+
+    cout << name << ": " << duration.count() / iterations << " us/frame, "
+        << allocationsPerFrame << " allocations/frame (sum " << sum << ")" << endl;
+
+    return allocationsPerFrame;
+}
+
+int main(int argc, char * argv[])
+{
+    size_t iterations = (argc > 1) ? stoul(argv[1]) : 20000;
+    if (iterations == 0)
+        iterations = 1;
+
+    double sumTree, sumView;
+    Measure("DecodeSmlMessages", iterations, SumValuesTree, sumTree);
+    double allocationsView = Measure("SmlFrameView     ", iterations, SumValuesView, sumView);
+
+    if (sumTree != sumView)
+    {
+        cerr << "error: the decoders disagree (" << sumTree << " != " << sumView << ")" << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (allocationsView != 0)
+    {
+        cerr << "error: SmlFrameView allocates heap memory" << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,260 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+// Checks that an archive block restores every row bit for bit after encoding and decoding.
+// The blocks have NULL readings, regular and irregular time gaps, columns with and without units per value
+// and random floating point values.
+// Usage: TestArchiveBlock [blocks]
+// Returns 1 if a decoded block differs from the encoded block.
+
+#include "ArchiveBlock.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <cstdlib>
+#include <cstdint>
+
+using namespace std;
+
+constexpr static double NaN = numeric_limits<double>::quiet_NaN();
+
+/// @brief The kind of the readings of a test column.
+enum ColumnKind
+{
+    CK_ENERGY_COUNTER,      // increasing integers / units per value, like the meter
+    CK_POWER,               // positive and negative integers / units per value
+    CK_RESOLUTION,          // integers * resolution, like values computed from a raw value
+    CK_MEASURED,            // similar values without units per value
+    CK_RANDOM_BITS,         // random bit patterns including infinity, denormals and -0.0
+    CK_SIGNED_ZERO,         // 0.0 and -0.0 in a column with units per value
+    CK_NULL                 // only NULL readings
+};
+
+/// @brief A test column.
+struct TestColumn
+{
+    const char * Name;
+    ColumnKind Kind;
+    double UnitsPerValue;
+
+    // the probability of a NULL reading
+    double NullProbability;
+};
+
+const static vector<TestColumn> TEST_COLUMNS {
+    { "+A", CK_ENERGY_COUNTER, 1E8, 0.0 },
+    { "+A T1", CK_ENERGY_COUNTER, 1E8, 0.05 },
+    { "P", CK_POWER, 100.0, 0.1 },
+    { "AC V", CK_RESOLUTION, 10.0, 0.0 },
+    { "AC PF", CK_MEASURED, 1000.0, 0.0 },
+    { "Additional", CK_MEASURED, 0.0, 0.3 },
+    { "Random", CK_RANDOM_BITS, 0.0, 0.1 },
+    { "Random units", CK_RANDOM_BITS, 100.0, 0.0 },
+    { "Zero", CK_SIGNED_ZERO, 100.0, 0.2 },
+    { "Null", CK_NULL, 10.0, 1.0 }
+};
+
+/// @brief Creates the next time of a block.
+static time_t NextTime(mt19937_64 & random, time_t time, bool isFirstRow)
+{
+    if (isFirstRow)
+        return (time_t)(random() % 4000000000) - 100000;
+
+    switch (random() % 10)
+    {
+    case 0:  return time + 1 + (time_t)(random() % 100);             // a short gap
+    case 1:  return time + 1 + (time_t)(random() % 10000);           // a longer gap
+    case 2:  return time + 1 + (time_t)(random() % 100000000000);    // a huge gap
+    default: return time + 30;                                       // the regular period
+    }
+}
+
+/// @brief Creates the next reading of a column.
+static double NextValue(mt19937_64 & random, const TestColumn & column, double previousValue)
+{
+    uniform_real_distribution<double> probability(0.0, 1.0);
+
+    if (probability(random) < column.NullProbability)
+        return NaN;
+
+    if (isnan(previousValue))
+        previousValue = 0.0;
+
+    switch (column.Kind)
+    {
+    case CK_ENERGY_COUNTER:
+        return (double)(llround(previousValue * column.UnitsPerValue) + (int64_t)(random() % 3000)) / column.UnitsPerValue;
+
+    case CK_POWER:
+        return (double)((int64_t)(random() % 2000001) - 1000000) / column.UnitsPerValue;
+
+    case CK_RESOLUTION:
+        return (double)(2200 + (int64_t)(random() % 200)) * (1.0 / column.UnitsPerValue);
+
+    case CK_MEASURED:
+        return previousValue + normal_distribution<double>(0.0, 0.7)(random);
+
+    case CK_RANDOM_BITS:
+        {
+            double value = bit_cast<double>((uint64_t)random());
+            return isnan(value) ? -0.0 : value;
+        }
+
+    case CK_SIGNED_ZERO:
+        return (random() % 2) ? -0.0 : 0.0;
+
+    default:
+        return NaN;
+    }
+}
+
+/// @brief Checks if two readings are equal bit for bit (or both NULL).
+static bool IsSameValue(double value1, double value2)
+{
+    if (isnan(value1) || isnan(value2))
+        return isnan(value1) && isnan(value2);
+
+    return bit_cast<uint64_t>(value1) == bit_cast<uint64_t>(value2);
+}
+
+/// @brief Creates a random block, encodes and decodes it and compares the rows.
+/// @param random The random number generator.
+/// @param numberOfRows The number of rows of the block.
+/// @param encodedSize Returns the size of the encoded block in bytes.
+/// @return True if the decoded block equals the block.
+static bool TestBlock(mt19937_64 & random, size_t numberOfRows, size_t & encodedSize)
+{
+    vector<string> columns;
+    vector<double> unitsPerValue;
+
+    for (const auto & column : TEST_COLUMNS)
+    {
+        columns.push_back(column.Name);
+        unitsPerValue.push_back(column.UnitsPerValue);
+    }
+
+    ArchiveBlock block(columns, unitsPerValue);
+
+    time_t time = 0;
+    vector<double> values(TEST_COLUMNS.size(), NaN);
+
+    // the last reading that was not NULL, the readings continue from it
+    vector<double> previousValues(TEST_COLUMNS.size(), NaN);
+
+    for (size_t row = 0; row < numberOfRows; row++)
+    {
+        time = NextTime(random, time, row == 0);
+
+        for (size_t column = 0; column < TEST_COLUMNS.size(); column++)
+        {
+            values[column] = NextValue(random, TEST_COLUMNS[column], previousValues[column]);
+
+            if (!isnan(values[column]))
+                previousValues[column] = values[column];
+        }
+
+        block.AddRow(time, values);
+    }
+
+    auto data = block.Encode();
+    encodedSize = data.size();
+
+    auto decodedBlock = ArchiveBlock::Decode(data.data(), data.size());
+
+    if ((decodedBlock.GetColumns() != block.GetColumns()) || (decodedBlock.GetNumberOfRows() != block.GetNumberOfRows()))
+    {
+        cout << "the columns or the number of rows differ (" << numberOfRows << " rows)" << endl;
+        return false;
+    }
+
+    for (size_t row = 0; row < numberOfRows; row++)
+    {
+        if (decodedBlock.GetTime(row) != block.GetTime(row))
+        {
+            cout << "row " << row << ": time " << decodedBlock.GetTime(row) << " instead of " << block.GetTime(row) << endl;
+            return false;
+        }
+
+        for (size_t column = 0; column < TEST_COLUMNS.size(); column++)
+        {
+            double value = block.GetValue(row, column);
+            double decodedValue = decodedBlock.GetValue(row, column);
+
+            if (!IsSameValue(decodedValue, value))
+            {
+                cout.precision(17);
+                cout << "row " << row << ", column \"" << TEST_COLUMNS[column].Name << "\": "
+                    << decodedValue << " instead of " << value << endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    size_t numberOfBlocks = (argc > 1) ? stoul(argv[1]) : 1000;
+
+    // a fixed seed, so a failure can be repeated
+    mt19937_64 random(20251016);
+
+    size_t numberOfRows = 0;
+    size_t encodedSize = 0;
+
+    try
+    {
+        for (size_t blockIdx = 0; blockIdx < numberOfBlocks; blockIdx++)
+        {
+            // the first blocks are empty or have a few rows, the others up to a day of 30 s samples
+            size_t rows = (blockIdx < 4) ? blockIdx : 1 + random() % 2880;
+            size_t size = 0;
+
+            if (!TestBlock(random, rows, size))
+            {
+                cout << "block " << blockIdx << " failed" << endl;
+                return EXIT_FAILURE;
+            }
+
+            numberOfRows += rows;
+            encodedSize += size;
+        }
+    }
+    catch (const exception & exc)
+    {
+        cout << "error: " << exc.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << numberOfBlocks << " blocks with " << numberOfRows << " rows restored, "
+        << (numberOfRows ? (double)encodedSize / numberOfRows : 0.0) << " bytes per row" << endl;
+
+    return EXIT_SUCCESS;
+}
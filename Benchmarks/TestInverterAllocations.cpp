@@ -0,0 +1,90 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+// Checks that querying the inverter does not allocate heap memory once the buffers are warmed up.
+// The inverter is simulated by the SimulatedInverterRadio, with and without packet loss.
+// Usage: TestInverterAllocations [queries]
+// Returns 1 if a query allocated heap memory or if a query without packet loss failed.
+
+#include "AllocationCounter.h"
+#include "HoymilesHmDtu.h"
+#include "SimulatedInverterRadio.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cstdlib>
+
+using namespace std;
+
+constexpr static int WARM_UP_QUERIES = 5;
+
+/// @brief Queries the simulated inverter and counts the heap allocations after the warm-up.
+/// @return True if no query allocated heap memory (and all queries succeeded if requireSuccess is set).
+static bool TestQueries(const char * name, const SimulatedInverterRadio::Parameters & parameters, int numberOfQueries,
+    bool requireSuccess)
+{
+    HoymilesHmDtu dtu("114184020874", make_shared<SimulatedInverterRadio>(parameters));
+    dtu.InitializeCommunication();
+
+    HoymilesHmDtu::Readings readings;
+
+    for (int query = 0; query < WARM_UP_QUERIES; query++)
+        dtu.QueryInverterInfo(readings, Deadline(5.0));
+
+    int numberOfSuccesses = 0;
+    size_t allocations = AllocationCounter::GetAllocationCount();
+
+    for (int query = 0; query < numberOfQueries; query++)
+    {
+        if (dtu.QueryInverterInfo(readings, Deadline(5.0)))
+            numberOfSuccesses++;
+    }
+
+    allocations = AllocationCounter::GetAllocationCount() - allocations;
+
+    cout << name << ": " << numberOfSuccesses << "/" << numberOfQueries << " queries successful, "
+        << allocations << " heap allocations" << endl;
+
+    return (allocations == 0) && (!requireSuccess || (numberOfSuccesses == numberOfQueries));
+}
+
+int main(int argc, char * argv[])
+{
+    int numberOfQueries = (argc > 1) ? stoi(argv[1]) : 10;
+
+    SimulatedInverterRadio::Parameters parameters;
+    parameters.ResponseLatencyMs = 1.0;
+    parameters.PacketGapMs = 0.5;
+
+    bool success = TestQueries("no packet loss", parameters, numberOfQueries, true);
+
+    // lost packets take the retry and retransmit paths, a query may fail
+    parameters.PacketLossProbability = 0.2;
+    parameters.PacketDuplicationProbability = 0.1;
+
+    success = TestQueries("20% packet loss", parameters, numberOfQueries, false) && success;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -24,11 +24,24 @@ IN THE SOFTWARE.
 
 #include "CancellationToken.h"
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
 using namespace std;
 
 CancellationToken::CancellationToken()
 : _cancel(false)
 {
+    _eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_eventFd < 0)
+        throw Error(format("can not create event: error {} {}", errno, strerror(errno)));
+}
+
+CancellationToken::~CancellationToken()
+{
+    close(_eventFd);
 }
 
 bool CancellationToken::IsCancel() const
@@ -38,11 +51,70 @@ bool CancellationToken::IsCancel() const
 
 void CancellationToken::Cancel()
 {
-    _cancel = true;
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        if (_cancel)
+            return;
+
+        _cancel = true;
+
+        uint64_t value = 1;
+        if (write(_eventFd, &value, sizeof(value)) != sizeof(value))
+            throw Error(format("can not signal event: error {} {}", errno, strerror(errno)));
+    }
+
+    _cancelRequested.notify_all();
+
+    lock_guard<mutex> lock(_callbackMutex);
+
+    for (auto & [callbackId, callback] : _callbacks)
+        callback();
 }
 
 void CancellationToken::Reset()
 {
+    lock_guard<mutex> lock(_mutex);
+
     _cancel = false;
+
+    // the event stays readable until the counter is read
+    uint64_t value;
+    if ((read(_eventFd, &value, sizeof(value)) < 0) && (errno != EAGAIN))
+        throw Error(format("can not reset event: error {} {}", errno, strerror(errno)));
 }
 
+bool CancellationToken::WaitFor(double seconds) const
+{
+    return WaitUntil(chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(max(seconds, 0.0))));
+}
+
+bool CancellationToken::WaitUntil(const time_point_type & timePoint) const
+{
+    unique_lock<mutex> lock(_mutex);
+    return _cancelRequested.wait_until(lock, timePoint, [this] { return _cancel.load(); });
+}
+
+CancellationToken::callback_id_type CancellationToken::RegisterCallback(const std::function<void()> & callback) const
+{
+    callback_id_type callbackId;
+
+    {
+        lock_guard<mutex> lock(_callbackMutex);
+
+        callbackId = _nextCallbackId++;
+        _callbacks[callbackId] = callback;
+    }
+
+    // a cancellation before the registration is not missed, a concurrent one may call the function twice
+    if (IsCancel())
+        callback();
+
+    return callbackId;
+}
+
+void CancellationToken::UnregisterCallback(callback_id_type callbackId) const
+{
+    lock_guard<mutex> lock(_callbackMutex);
+    _callbacks.erase(callbackId);
+}
@@ -25,13 +25,34 @@ IN THE SOFTWARE.
 */
 
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <format>
+#include <string>
 
-/// @brief Used to cancel something.
+/// @brief Used to cancel something. Waits can be interrupted by the cancellation: threads wait with WaitFor()/WaitUntil(),
+/// poll() loops wait for the event file descriptor and other waits are woken up by a registered callback.
+/// All functions are thread safe.
 class CancellationToken
 {
 public:
+    typedef std::chrono::steady_clock::time_point time_point_type;
+    typedef size_t callback_id_type;
+
+    /// @brief Cancellation token error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("Cancellation token error: {}", errorMessage)) { }
+    };
+
     /// @brief Constructor.
     CancellationToken();
+    ~CancellationToken();
 
     CancellationToken(const CancellationToken &) = delete;
     CancellationToken & operator=(const CancellationToken &) = delete;
@@ -40,13 +61,46 @@ public:
     /// @return True if cancellation is requested.
     bool IsCancel() const;
 
-    /// @brief Cancel.
+    /// @brief Cancel. Wakes up all waiting threads and calls the registered callbacks (in the calling thread).
     void Cancel();
 
     /// @brief Reset to "not cancel" state.
     void Reset();
 
+    /// @brief Waits until cancellation is requested or the time is over.
+    /// @param seconds The time to wait in s.
+    /// @return True if cancellation is requested.
+    bool WaitFor(double seconds) const;
+
+    /// @brief Waits until cancellation is requested or the point in time is reached.
+    /// @param timePoint The point in time.
+    /// @return True if cancellation is requested.
+    bool WaitUntil(const time_point_type & timePoint) const;
+
+    /// @brief Returns a file descriptor that is readable while cancellation is requested (to be used with poll()).
+    /// The file descriptor must not be read.
+    /// @return The file descriptor.
+    int GetEventFd() const { return _eventFd; }
+
+    /// @brief Registers a function that is called on cancellation. If cancellation is already requested, the function
+    /// is called immediately. The function must not register or unregister callbacks and must tolerate to be called twice.
+    /// @param callback The function.
+    /// @return The ID to unregister the function.
+    callback_id_type RegisterCallback(const std::function<void()> & callback) const;
+
+    /// @brief Unregisters a function. Waits until the function is finished if it is currently called.
+    /// @param callbackId The ID returned by RegisterCallback().
+    void UnregisterCallback(callback_id_type callbackId) const;
+
 private:
     std::atomic<bool> _cancel;
-};
 
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _cancelRequested;
+    int _eventFd;
+
+    // held while the callbacks are called, so a callback is not called after it was unregistered
+    mutable std::mutex _callbackMutex;
+    mutable std::map<callback_id_type, std::function<void()>> _callbacks;
+    mutable callback_id_type _nextCallbackId = 1;
+};
@@ -0,0 +1,228 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "ChannelModel.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+using namespace std;
+
+ChannelModel::ChannelModel(std::span<const int> txChannels, std::span<const int> rxChannels)
+{
+    if (txChannels.empty())
+        throw Error("No TX channels.");
+
+    for (int channel : txChannels)
+        _txChannelStatistics.push_back({ .Channel = channel });
+
+    for (int channel : rxChannels)
+        _rxChannelStatistics.push_back({ .Channel = channel });
+}
+
+int ChannelModel::SelectTxChannel(std::minstd_rand & randomEngine) const
+{
+    // draw a success rate for each channel from its posterior (uniform prior) and take the best one,
+    // channels with few requests have a wide distribution, so they are still tried from time to time
+    int bestChannel = _txChannelStatistics[0].Channel;
+    double bestSample = -1.0;
+
+    for (const auto & statistics : _txChannelStatistics)
+    {
+        double failures = max(statistics.Requests - statistics.Successes, 0.0);
+        double sample = SampleBeta(randomEngine, 1.0 + statistics.Successes, 1.0 + failures);
+
+        if (sample > bestSample)
+        {
+            bestSample = sample;
+            bestChannel = statistics.Channel;
+        }
+    }
+
+    return bestChannel;
+}
+
+void ChannelModel::OrderRxChannels(std::span<int> rxChannelList) const
+{
+    // insertion sort: stable and without allocation, the lists are short
+    for (size_t idx = 1; idx < rxChannelList.size(); idx++)
+    {
+        int channel = rxChannelList[idx];
+        double frameHits = GetRxFrameHits(channel);
+
+        size_t insertIdx = idx;
+        while ((insertIdx > 0) && (GetRxFrameHits(rxChannelList[insertIdx - 1]) < frameHits))
+        {
+            rxChannelList[insertIdx] = rxChannelList[insertIdx - 1];
+            insertIdx--;
+        }
+
+        rxChannelList[insertIdx] = channel;
+    }
+}
+
+void ChannelModel::RecordRequest(int txChannel, bool success, int framesReceived)
+{
+    for (auto & statistics : _txChannelStatistics)
+    {
+        statistics.Requests *= DECAY_FACTOR;
+        statistics.Successes *= DECAY_FACTOR;
+        statistics.FramesReceived *= DECAY_FACTOR;
+
+        if (statistics.Channel == txChannel)
+        {
+            statistics.Requests += 1.0;
+            statistics.FramesReceived += framesReceived;
+
+            if (success)
+                statistics.Successes += 1.0;
+        }
+    }
+
+    for (auto & statistics : _rxChannelStatistics)
+        statistics.FrameHits *= DECAY_FACTOR;
+}
+
+void ChannelModel::RecordRxFrame(int rxChannel)
+{
+    for (auto & statistics : _rxChannelStatistics)
+    {
+        if (statistics.Channel == rxChannel)
+            statistics.FrameHits += 1.0;
+    }
+}
+
+void ChannelModel::Load(const std::string & filename)
+{
+    if (!filesystem::exists(filename))
+        return;
+
+    ifstream file(filename);
+    if (!file)
+        throw Error(format("Can not open file: {}", filename));
+
+    string line;
+    while (getline(file, line))
+    {
+        istringstream ss(line);
+
+        string type;
+        int channel;
+        if (!(ss >> type >> channel))
+            continue;
+
+        if (type == "TX")
+        {
+            double requests, successes, framesReceived;
+            if (!(ss >> requests >> successes >> framesReceived))
+                throw Error(format("Invalid TX line in file {}: {}", filename, line));
+
+            for (auto & statistics : _txChannelStatistics)
+            {
+                if (statistics.Channel == channel)
+                    statistics = { channel, requests, successes, framesReceived };
+            }
+        }
+        else if (type == "RX")
+        {
+            double frameHits;
+            if (!(ss >> frameHits))
+                throw Error(format("Invalid RX line in file {}: {}", filename, line));
+
+            for (auto & statistics : _rxChannelStatistics)
+            {
+                if (statistics.Channel == channel)
+                    statistics.FrameHits = frameHits;
+            }
+        }
+    }
+}
+
+void ChannelModel::Save(const std::string & filename) const
+{
+    // write to a temporary file first, so the model is not lost if the program is killed while saving
+    string tmpFilename = filename + ".tmp";
+
+    {
+        ofstream file(tmpFilename, ios::trunc);
+        if (!file)
+            throw Error(format("Can not create file: {}", tmpFilename));
+
+        file << "# TX channel requests successes frames_received" << endl;
+        for (const auto & statistics : _txChannelStatistics)
+            file << format("TX {} {} {} {}", statistics.Channel, statistics.Requests, statistics.Successes, statistics.FramesReceived) << endl;
+
+        file << "# RX channel frame_hits" << endl;
+        for (const auto & statistics : _rxChannelStatistics)
+            file << format("RX {} {}", statistics.Channel, statistics.FrameHits) << endl;
+
+        if (!file)
+            throw Error(format("Can not write file: {}", tmpFilename));
+    }
+
+    filesystem::rename(tmpFilename, filename);
+}
+
+std::string ChannelModel::ToString() const
+{
+    string str;
+
+    for (const auto & statistics : _txChannelStatistics)
+    {
+        double successRate = (statistics.Requests > 0.0) ? 100.0 * statistics.Successes / statistics.Requests : 0.0;
+        str += format("TX {}: {:.0f}% ({:.1f} requests, {:.1f} frames) ", statistics.Channel, successRate, statistics.Requests, statistics.FramesReceived);
+    }
+
+    for (const auto & statistics : _rxChannelStatistics)
+        str += format("RX {}: {:.1f} hits ", statistics.Channel, statistics.FrameHits);
+
+    if (!str.empty())
+        str.pop_back();
+
+    return str;
+}
+
+double ChannelModel::SampleBeta(std::minstd_rand & randomEngine, double alpha, double beta)
+{
+    gamma_distribution<double> gammaAlpha(alpha, 1.0);
+    gamma_distribution<double> gammaBeta(beta, 1.0);
+
+    double x = gammaAlpha(randomEngine);
+    double y = gammaBeta(randomEngine);
+
+    return (x + y > 0.0) ? x / (x + y) : 0.5;
+}
+
+double ChannelModel::GetRxFrameHits(int rxChannel) const
+{
+    for (const auto & statistics : _rxChannelStatistics)
+    {
+        if (statistics.Channel == rxChannel)
+            return statistics.FrameHits;
+    }
+
+    return 0.0;
+}
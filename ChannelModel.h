@@ -0,0 +1,118 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <span>
+#include <string>
+#include <random>
+#include <stdexcept>
+#include <format>
+
+/// @brief Learns the quality of the radio channels from the results of the inverter queries.
+/// The statistics are exponentially decayed, so the model follows changes of the radio environment.
+/// The TX channel is selected by Thompson sampling, the RX channels are ordered by their frame hits.
+class ChannelModel
+{
+public:
+    /// @brief Channel model error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("Channel model error: {}", errorMessage)) { }
+    };
+
+    // the statistics are multiplied with this factor for every query (half-life of about 70 queries)
+    constexpr static double DECAY_FACTOR = 0.99;
+
+    /// @brief Constructor.
+    /// @param txChannels The channels where requests can be sent.
+    /// @param rxChannels The channels where responses can be received.
+    ChannelModel(std::span<const int> txChannels, std::span<const int> rxChannels);
+
+    /// @brief Selects the TX channel for the next request by Thompson sampling of the success rates.
+    /// @param randomEngine The random number generator.
+    /// @return The TX channel.
+    int SelectTxChannel(std::minstd_rand & randomEngine) const;
+
+    /// @brief Orders the RX channels by their frame hits, the channel with the most hits first.
+    /// Channels with equal hits keep their order.
+    /// @param rxChannelList The RX channel list which is sorted in place.
+    void OrderRxChannels(std::span<int> rxChannelList) const;
+
+    /// @brief Records the result of a request. The statistics of all channels are decayed first.
+    /// @param txChannel The TX channel where the request was sent.
+    /// @param success True if the frames received for this request completed the response.
+    /// @param framesReceived Number of new frames received.
+    void RecordRequest(int txChannel, bool success, int framesReceived);
+
+    /// @brief Records a valid frame received on a RX channel.
+    /// @param rxChannel The RX channel.
+    void RecordRxFrame(int rxChannel);
+
+    /// @brief Loads the statistics from a file. Unknown channels are ignored.
+    /// @param filename The filename.
+    void Load(const std::string & filename);
+
+    /// @brief Saves the statistics to a file.
+    /// @param filename The filename.
+    void Save(const std::string & filename) const;
+
+    /// @brief Returns the statistics as string, e.g. "TX 3: 85% (12.3 requests, 2.1 frames) ...".
+    /// @return The statistics as string.
+    std::string ToString() const;
+
+private:
+    /// @brief The decayed statistics of a TX channel.
+    struct TxChannelStatistics
+    {
+        int Channel = 0;
+        double Requests = 0.0;
+        double Successes = 0.0;
+        double FramesReceived = 0.0;
+    };
+
+    /// @brief The decayed statistics of a RX channel.
+    struct RxChannelStatistics
+    {
+        int Channel = 0;
+        double FrameHits = 0.0;
+    };
+
+    std::vector <TxChannelStatistics> _txChannelStatistics;
+    std::vector <RxChannelStatistics> _rxChannelStatistics;
+
+    /// @brief Returns a random number from the beta distribution.
+    /// @param randomEngine The random number generator.
+    /// @param alpha Parameter alpha (> 0).
+    /// @param beta Parameter beta (> 0).
+    /// @return The random number in the range 0 ... 1.
+    static double SampleBeta(std::minstd_rand & randomEngine, double alpha, double beta);
+
+    /// @brief Returns the hits of a RX channel.
+    /// @param rxChannel The RX channel.
+    /// @return The decayed frame hits, 0 if the channel is unknown.
+    double GetRxFrameHits(int rxChannel) const;
+};
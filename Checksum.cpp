@@ -0,0 +1,57 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "Checksum.h"
+
+namespace Checksum
+{
+    constexpr std::array<uint8_t, 9> CHECK_DATA = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+    static_assert(UpdateCrc8Hoymiles<1>(CRC8_HOYMILES_START_VALUE, CHECK_DATA) == 0x31);
+    static_assert(UpdateCrc8Hoymiles<4>(CRC8_HOYMILES_START_VALUE, CHECK_DATA) == 0x31);
+    static_assert(UpdateCrc8Hoymiles<8>(CRC8_HOYMILES_START_VALUE, CHECK_DATA) == 0x31);
+
+    static_assert(UpdateCrc16Modbus<1>(CRC16_MODBUS_START_VALUE, CHECK_DATA) == 0x4B37);
+    static_assert(UpdateCrc16Modbus<4>(CRC16_MODBUS_START_VALUE, CHECK_DATA) == 0x4B37);
+    static_assert(UpdateCrc16Modbus<8>(CRC16_MODBUS_START_VALUE, CHECK_DATA) == 0x4B37);
+
+    static_assert((UpdateCrc16X25<1>(CRC16_X25_START_VALUE, CHECK_DATA) ^ 0xFFFF) == 0x906E);
+    static_assert((UpdateCrc16X25<4>(CRC16_X25_START_VALUE, CHECK_DATA) ^ 0xFFFF) == 0x906E);
+    static_assert((UpdateCrc16X25<8>(CRC16_X25_START_VALUE, CHECK_DATA) ^ 0xFFFF) == 0x906E);
+
+    uint8_t CalculateCrc8Hoymiles(std::span<const uint8_t> data)
+    {
+        return UpdateCrc8Hoymiles(CRC8_HOYMILES_START_VALUE, data);
+    }
+
+    uint16_t CalculateCrc16Modbus(std::span<const uint8_t> data)
+    {
+        return UpdateCrc16Modbus(CRC16_MODBUS_START_VALUE, data);
+    }
+
+    uint16_t CalculateCrc16X25(std::span<const uint8_t> data)
+    {
+        return UpdateCrc16X25(CRC16_X25_START_VALUE, data) ^ 0xFFFF;
+    }
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <array>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+/// @brief Table driven CRC checksums used by the Smart Message Language (SML) and the Hoymiles inverter protocol.
+/// The tables are generated at compile time. The Update functions support incremental calculation and
+/// process SLICES bytes per step (slice-by-1, slice-by-4 or slice-by-8).
+namespace Checksum
+{
+    /// @brief Lookup tables for slice-by-N calculation: table k is the checksum of a byte followed by k zero bytes.
+    template <typename T>
+    using tables_type = std::array<std::array<T, 256>, 8>;
+
+    /// @brief Generates the lookup tables for a non reflected 8 bit CRC.
+    /// @param polynomial The polynomial without the x^8 term.
+    /// @return The lookup tables.
+    constexpr tables_type<uint8_t> GenerateCrc8Tables(uint8_t polynomial)
+    {
+        tables_type<uint8_t> tables {};
+
+        for (int value = 0; value < 256; value++)
+        {
+            uint8_t crc = static_cast<uint8_t>(value);
+
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ polynomial) : static_cast<uint8_t>(crc << 1);
+
+            tables[0][value] = crc;
+        }
+
+        for (size_t k = 1; k < tables.size(); k++)
+        {
+            for (int value = 0; value < 256; value++)
+                tables[k][value] = tables[0][tables[k - 1][value]];
+        }
+
+        return tables;
+    }
+
+    /// @brief Generates the lookup tables for a reflected 16 bit CRC.
+    /// @param polynomial The reflected polynomial.
+    /// @return The lookup tables.
+    constexpr tables_type<uint16_t> GenerateReflectedCrc16Tables(uint16_t polynomial)
+    {
+        tables_type<uint16_t> tables {};
+
+        for (int value = 0; value < 256; value++)
+        {
+            uint16_t crc = static_cast<uint16_t>(value);
+
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ polynomial) : static_cast<uint16_t>(crc >> 1);
+
+            tables[0][value] = crc;
+        }
+
+        for (size_t k = 1; k < tables.size(); k++)
+        {
+            for (int value = 0; value < 256; value++)
+                tables[k][value] = (tables[k - 1][value] >> 8) ^ tables[0][tables[k - 1][value] & 0xFF];
+        }
+
+        return tables;
+    }
+
+    /// @brief Updates a non reflected 8 bit CRC.
+    /// @tparam SLICES Number of bytes processed per step: 1, 4 or 8.
+    /// @param tables The lookup tables.
+    /// @param crc The checksum so far.
+    /// @param data The data to add to the checksum.
+    /// @return The updated checksum.
+    template <size_t SLICES>
+    constexpr uint8_t UpdateCrc8(const tables_type<uint8_t> & tables, uint8_t crc, std::span<const uint8_t> data)
+    {
+        static_assert((SLICES == 1) || (SLICES == 4) || (SLICES == 8), "SLICES must be 1, 4 or 8");
+
+        size_t idx = 0;
+
+        if constexpr (SLICES > 1)
+        {
+            for (; idx + SLICES <= data.size(); idx += SLICES)
+            {
+                uint8_t result = tables[SLICES - 1][data[idx] ^ crc];
+
+                for (size_t k = 1; k < SLICES; k++)
+                    result ^= tables[SLICES - 1 - k][data[idx + k]];
+
+                crc = result;
+            }
+        }
+
+        for (; idx < data.size(); idx++)
+            crc = tables[0][data[idx] ^ crc];
+
+        return crc;
+    }
+
+    /// @brief Updates a reflected 16 bit CRC.
+    /// @tparam SLICES Number of bytes processed per step: 1, 4 or 8.
+    /// @param tables The lookup tables.
+    /// @param crc The checksum so far.
+    /// @param data The data to add to the checksum.
+    /// @return The updated checksum.
+    template <size_t SLICES>
+    constexpr uint16_t UpdateReflectedCrc16(const tables_type<uint16_t> & tables, uint16_t crc, std::span<const uint8_t> data)
+    {
+        static_assert((SLICES == 1) || (SLICES == 4) || (SLICES == 8), "SLICES must be 1, 4 or 8");
+
+        size_t idx = 0;
+
+        if constexpr (SLICES > 1)
+        {
+            for (; idx + SLICES <= data.size(); idx += SLICES)
+            {
+                uint16_t result = tables[SLICES - 1][(data[idx] ^ crc) & 0xFF]
+                    ^ tables[SLICES - 2][(data[idx + 1] ^ (crc >> 8)) & 0xFF];
+
+                for (size_t k = 2; k < SLICES; k++)
+                    result ^= tables[SLICES - 1 - k][data[idx + k]];
+
+                crc = result;
+            }
+        }
+
+        for (; idx < data.size(); idx++)
+            crc = (crc >> 8) ^ tables[0][(data[idx] ^ crc) & 0xFF];
+
+        return crc;
+    }
+
+    inline constexpr tables_type<uint8_t> CRC8_HOYMILES_TABLES = GenerateCrc8Tables(0x01);
+    inline constexpr tables_type<uint16_t> CRC16_MODBUS_TABLES = GenerateReflectedCrc16Tables(0xA001);
+    inline constexpr tables_type<uint16_t> CRC16_X25_TABLES = GenerateReflectedCrc16Tables(0x8408);
+
+    constexpr uint8_t CRC8_HOYMILES_START_VALUE = 0x00;
+    constexpr uint16_t CRC16_MODBUS_START_VALUE = 0xFFFF;
+    constexpr uint16_t CRC16_X25_START_VALUE = 0xFFFF;
+
+    /// @brief Updates the CRC8 checksum for communication with hoymiles inverters. poly = 0x101; reversed = False; init-value = 0x00; XOR-out = 0x00; Check = 0x31
+    /// @tparam SLICES Number of bytes processed per step: 1, 4 or 8.
+    /// @param crc The checksum so far. (CRC8_HOYMILES_START_VALUE for the first data.)
+    /// @param data The data to add to the checksum.
+    /// @return The updated checksum.
+    template <size_t SLICES = 8>
+    constexpr uint8_t UpdateCrc8Hoymiles(uint8_t crc, std::span<const uint8_t> data)
+    {
+        return UpdateCrc8<SLICES>(CRC8_HOYMILES_TABLES, crc, data);
+    }
+
+    /// @brief Updates the CRC16 checksum for communication with hoymiles inverters. poly = 0x8005; reversed = True; init-value = 0xFFFF; XOR-out = 0x0000; Check = 0x4B37
+    /// @tparam SLICES Number of bytes processed per step: 1, 4 or 8.
+    /// @param crc The checksum so far. (CRC16_MODBUS_START_VALUE for the first data.)
+    /// @param data The data to add to the checksum.
+    /// @return The updated checksum.
+    template <size_t SLICES = 8>
+    constexpr uint16_t UpdateCrc16Modbus(uint16_t crc, std::span<const uint8_t> data)
+    {
+        return UpdateReflectedCrc16<SLICES>(CRC16_MODBUS_TABLES, crc, data);
+    }
+
+    /// @brief Updates the CRC16 checksum for Smart Message Language. poly = 0x1021; reversed = True; init-value = 0xFFFF; XOR-out = 0xFFFF; Check = 0x906E
+    /// The XOR-out is not applied, the final checksum is the returned value XOR 0xFFFF.
+    /// @tparam SLICES Number of bytes processed per step: 1, 4 or 8.
+    /// @param crc The checksum so far. (CRC16_X25_START_VALUE for the first data.)
+    /// @param data The data to add to the checksum.
+    /// @return The updated checksum.
+    template <size_t SLICES = 8>
+    constexpr uint16_t UpdateCrc16X25(uint16_t crc, std::span<const uint8_t> data)
+    {
+        return UpdateReflectedCrc16<SLICES>(CRC16_X25_TABLES, crc, data);
+    }
+
+    /// @brief Calculates the CRC8 checksum for communication with hoymiles inverters.
+    /// @param data The data on which the checksum is to be calculated.
+    /// @return The checksum.
+    uint8_t CalculateCrc8Hoymiles(std::span<const uint8_t> data);
+
+    /// @brief Calculates the CRC16 checksum for communication with hoymiles inverters.
+    /// @param data The data on which the checksum is to be calculated.
+    /// @return The checksum.
+    uint16_t CalculateCrc16Modbus(std::span<const uint8_t> data);
+
+    /// @brief Calculates the CRC16 checksum for Smart Message Language.
+    /// @param data The data on which the checksum is to be calculated.
+    /// @return The checksum.
+    uint16_t CalculateCrc16X25(std::span<const uint8_t> data);
+}
@@ -0,0 +1,92 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "CircuitBreaker.h"
+
+#include "Logger.h"
+
+#include <format>
+#include <algorithm>
+
+using namespace std;
+
+CircuitBreaker::CircuitBreaker(const std::string & deviceName, int failureThreshold,
+    double initialBackoffSeconds, double maxBackoffSeconds)
+: _deviceName(deviceName)
+, _failureThreshold(max(failureThreshold, 1))
+, _initialBackoffSeconds(initialBackoffSeconds)
+, _maxBackoffSeconds(max(maxBackoffSeconds, initialBackoffSeconds))
+, _backoffEnd(0.0)
+{
+}
+
+bool CircuitBreaker::IsAttemptAllowed()
+{
+    switch (_state)
+    {
+    case CBS_CLOSED:
+        return true;
+
+    case CBS_OPEN:
+        if (!_backoffEnd.IsExpired())
+            return false;
+
+        _state = CBS_HALF_OPEN;
+        return true;
+
+    case CBS_HALF_OPEN:
+    default:
+        return true;
+    }
+}
+
+void CircuitBreaker::RecordSuccess()
+{
+    if (_state != CBS_CLOSED)
+        LOG_INFO(format("{} is reachable again after {} failed attempts.", _deviceName, _consecutiveFailures));
+
+    _state = CBS_CLOSED;
+    _consecutiveFailures = 0;
+    _backoffSeconds = 0.0;
+}
+
+void CircuitBreaker::RecordFailure()
+{
+    _consecutiveFailures++;
+
+    if (_state == CBS_HALF_OPEN)
+        Open(min(2.0 * _backoffSeconds, _maxBackoffSeconds));
+    else if ((_state == CBS_CLOSED) && (_consecutiveFailures >= _failureThreshold))
+        Open(_initialBackoffSeconds);
+}
+
+void CircuitBreaker::Open(double backoffSeconds)
+{
+    if (_state == CBS_CLOSED)
+        LOG_WARN(format("{} is unreachable after {} failed attempts.", _deviceName, _consecutiveFailures));
+
+    _state = CBS_OPEN;
+    _backoffSeconds = backoffSeconds;
+    _backoffEnd = Deadline(backoffSeconds);
+}
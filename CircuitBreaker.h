@@ -0,0 +1,89 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "Deadline.h"
+
+#include <string>
+
+/// @brief Stops the attempts to reach a device while it is unreachable (e.g. the inverter at night).
+/// After a number of consecutive failures the breaker opens and no attempts are allowed until the backoff time is over.
+/// Then a single attempt is allowed: on success the breaker closes, on failure the backoff time is doubled (up to a maximum).
+class CircuitBreaker
+{
+public:
+    /// @brief The breaker state.
+    enum State
+    {
+        CBS_CLOSED,         // the device is reachable, all attempts are allowed
+        CBS_OPEN,           // the device is unreachable, no attempts until the backoff time is over
+        CBS_HALF_OPEN       // the backoff time is over, a single attempt is allowed
+    };
+
+    /// @brief Constructor.
+    /// @param deviceName The name of the device (for logging).
+    /// @param failureThreshold Number of consecutive failures that open the breaker.
+    /// @param initialBackoffSeconds The backoff time after the breaker was opened the first time in s.
+    /// @param maxBackoffSeconds The maximum backoff time in s.
+    CircuitBreaker(const std::string & deviceName, int failureThreshold = 3,
+        double initialBackoffSeconds = 60.0, double maxBackoffSeconds = 1800.0);
+
+    /// @brief Checks if an attempt to reach the device is allowed. Switches from open to half open if the backoff time is over.
+    /// @return True if the attempt is allowed.
+    bool IsAttemptAllowed();
+
+    /// @brief Records a successful attempt. Closes the breaker.
+    void RecordSuccess();
+
+    /// @brief Records a failed attempt. Opens the breaker after too many failures.
+    void RecordFailure();
+
+    /// @brief Returns the breaker state.
+    /// @return The state.
+    State GetState() const { return _state; }
+
+    /// @brief Returns the number of consecutive failed attempts.
+    /// @return The number of failures.
+    int GetConsecutiveFailures() const { return _consecutiveFailures; }
+
+    /// @brief Returns the current backoff time.
+    /// @return The backoff time in s (0 if the breaker is closed).
+    double GetBackoffSeconds() const { return _backoffSeconds; }
+
+private:
+    std::string _deviceName;
+    int _failureThreshold;
+    double _initialBackoffSeconds;
+    double _maxBackoffSeconds;
+
+    State _state = CBS_CLOSED;
+    int _consecutiveFailures = 0;
+    double _backoffSeconds = 0.0;
+    Deadline _backoffEnd;
+
+    /// @brief Opens the breaker for the given backoff time.
+    /// @param backoffSeconds The backoff time in s.
+    void Open(double backoffSeconds);
+};
@@ -31,16 +31,29 @@ IN THE SOFTWARE.
 
 #include <filesystem>
 #include <format>
+#include <cmath>
+#include <limits>
 
 using namespace Utils;
 using namespace std;
 
 Configuration::Configuration()
-: _inverterSerialNumber("00000000")
+: _locationLatitude(numeric_limits<double>::quiet_NaN())
+, _locationLongitude(numeric_limits<double>::quiet_NaN())
+, _inverterSerialNumber("00000000")
 , _inverterNumberOfChannels(2)
+, _inverterIrqGpioPin(25)
+, _inverterRadio("nRF24")
 , _electricityMeterSerialPort("/dev/ttyAMA0")
 , _databaseFilepath("electricity_monitor_readings.db")
+, _databaseCommitInterval(60.0)
+, _databaseCommitBatchSize(100)
+, _databaseCompactStorage(false)
+, _databaseArchiveAfterDays(0)
 , _dataAcquisitionPeriod(30.0)
+, _electricityMeterAcquisitionPeriod(30.0)
+, _inverterAcquisitionPeriod(30.0)
+, _overrunPolicy(PeriodicScheduler::OP_SKIP)
 {
 }
 
@@ -52,17 +65,74 @@ void Configuration::Load(const std::string & configurationFilename)
     Json json;
     json.LoadFromFile(configurationFilename);
 
+    _locationLatitude = GetDoubleValue(json, "Location", "Latitude", _locationLatitude);
+    _locationLongitude = GetDoubleValue(json, "Location", "Longitude", _locationLongitude);
+    _locationTimezone = GetStringValue(json, "Location", "Timezone", _locationTimezone);
+
+    if (HasLocation() && ((abs(_locationLatitude) > 90.0) || (abs(_locationLongitude) > 180.0)))
+        throw Error(format("Invalid location: latitude {}, longitude {}", _locationLatitude, _locationLongitude));
+
     _inverterSerialNumber = GetStringValue(json, "Inverter", "SerialNumber", _inverterSerialNumber);
     _inverterNumberOfChannels = GetIntValue(json, "Inverter", "NumberOfChannels", _inverterNumberOfChannels);
+    _inverterIrqGpioPin = GetIntValue(json, "Inverter", "IrqGpioPin", _inverterIrqGpioPin);
+    _inverterChannelModelFilepath = GetStringValue(json, "Inverter", "ChannelModelFilepath", _inverterChannelModelFilepath);
+    _inverterRadio = GetStringValue(json, "Inverter", "Radio", _inverterRadio);
+
+    if ((_inverterRadio != "nRF24") && (_inverterRadio != "Simulation"))
+        throw Error(format("Invalid inverter radio: {}", _inverterRadio));
+
+    auto & simulation = _inverterSimulationParameters;
+    simulation.NumberOfChannels = _inverterNumberOfChannels;
+    simulation.PacketLossProbability = GetDoubleValue(json, "InverterSimulation", "PacketLoss", simulation.PacketLossProbability);
+    simulation.PacketDuplicationProbability = GetDoubleValue(json, "InverterSimulation", "PacketDuplication", simulation.PacketDuplicationProbability);
+    simulation.ResponseLatencyMs = GetDoubleValue(json, "InverterSimulation", "ResponseLatencyMs", simulation.ResponseLatencyMs);
+    simulation.PacketGapMs = GetDoubleValue(json, "InverterSimulation", "PacketGapMs", simulation.PacketGapMs);
+    simulation.Seed = (uint32_t)GetIntValue(json, "InverterSimulation", "Seed", (int)simulation.Seed);
+    simulation.HasReceiveInterrupt = _inverterIrqGpioPin >= 0;
 
     _databaseFilepath = GetStringValue(json, "Database", "Filepath", _databaseFilepath);
+    _databaseCommitInterval = GetDoubleValue(json, "Database", "CommitInterval", _databaseCommitInterval);
+    _databaseCommitBatchSize = GetIntValue(json, "Database", "CommitBatchSize", _databaseCommitBatchSize);
+    _databaseCompactStorage = GetBoolValue(json, "Database", "CompactStorage", _databaseCompactStorage);
+
+    if ((_databaseCommitInterval < 0.0) || (_databaseCommitBatchSize < 1))
+        throw Error(format("Invalid database commit interval {} s or batch size {}", _databaseCommitInterval, _databaseCommitBatchSize));
+
+    _databaseArchiveAfterDays = GetIntValue(json, "Database", "ArchiveAfterDays", _databaseArchiveAfterDays);
+
+    if (_databaseArchiveAfterDays < 0)
+        throw Error(format("Invalid database archive age: {} days", _databaseArchiveAfterDays));
+
     _dataAcquisitionPeriod = GetDoubleValue(json, "Database", "DataAcquisitionPeriod", _dataAcquisitionPeriod);
+    _electricityMeterAcquisitionPeriod = GetDoubleValue(json, "ElectricityMeter", "AcquisitionPeriod", _dataAcquisitionPeriod);
+    _inverterAcquisitionPeriod = GetDoubleValue(json, "Inverter", "AcquisitionPeriod", _dataAcquisitionPeriod);
+
+    for (double period : { _dataAcquisitionPeriod, _electricityMeterAcquisitionPeriod, _inverterAcquisitionPeriod })
+    {
+        if (period < MIN_ACQUISITION_PERIOD)
+            throw Error(format("Invalid data acquisition period: {} s", period));
+    }
+
+    string overrunPolicy = GetStringValue(json, "Database", "OverrunPolicy", "Skip");
+
+    if (overrunPolicy == "Skip")
+        _overrunPolicy = PeriodicScheduler::OP_SKIP;
+    else if (overrunPolicy == "CatchUp")
+        _overrunPolicy = PeriodicScheduler::OP_CATCH_UP;
+    else
+        throw Error(format("Invalid overrun policy: {}", overrunPolicy));
 
     _electricityMeterSerialPort = GetStringValue(json, "ElectricityMeter", "SerialPort", _electricityMeterSerialPort);
+    _electricityMeterAdditionalObisCodes = GetObisCodes(json, "ElectricityMeter", "AdditionalObisCodes");
     
     LOG_INFO(std::string("Loaded configuration from: ") + configurationFilename);
 }
 
+bool Configuration::HasLocation() const
+{
+    return !isnan(_locationLatitude) && !isnan(_locationLongitude);
+}
+
 double Configuration::GetDoubleValue(const Json & json, const std::string & topic, const std::string & key)
 {
     json_object * objTopic = nullptr;
@@ -126,6 +196,36 @@ int Configuration::GetIntValue(const Json & json, const std::string & topic, con
     }
 }
 
+bool Configuration::GetBoolValue(const Json & json, const std::string & topic, const std::string & key)
+{
+    json_object * objTopic = nullptr;
+    json_object * objKey = nullptr;
+    auto root = json.GetRootObject();
+
+    if (!json_object_object_get_ex(root, topic.c_str(), &objTopic))
+        throw Error("Topic not found in JSON: " + topic);
+
+    if (!json_object_object_get_ex(objTopic, key.c_str(), &objKey))
+        throw Error("Key not found in JSON topic '" + topic + "': " + key);
+
+    if (json_object_get_type(objKey) == json_type_boolean)
+        return json_object_get_boolean(objKey);
+
+    throw Error("Key is not a boolean in JSON topic '" + topic + "': " + key);
+}
+
+bool Configuration::GetBoolValue(const Json & json, const std::string & topic, const std::string & key, bool defaultValue)
+{
+    try
+    {
+        return GetBoolValue(json, topic, key);
+    }
+    catch(const exception& e)
+    {
+        return defaultValue;
+    }
+}
+
 std::string Configuration::GetStringValue(const Json & json, const std::string & topic, const std::string & key)
 {
     json_object * objTopic = nullptr;
@@ -156,3 +256,63 @@ std::string Configuration::GetStringValue(const Json & json, const std::string &
     }
 }
 
+
+std::vector <ObisRegistry::AdditionalCode> Configuration::GetObisCodes(const Json & json, const std::string & topic, const std::string & key)
+{
+    vector <ObisRegistry::AdditionalCode> obisCodes;
+
+    json_object * objTopic = nullptr;
+    json_object * objKey = nullptr;
+    auto root = json.GetRootObject();
+
+    // the additional OBIS codes are optional
+    if (!json_object_object_get_ex(root, topic.c_str(), &objTopic))
+        return obisCodes;
+
+    if (!json_object_object_get_ex(objTopic, key.c_str(), &objKey))
+        return obisCodes;
+
+    if (json_object_get_type(objKey) != json_type_array)
+        throw Error("Key is not an array in JSON topic '" + topic + "': " + key);
+
+    size_t numberOfCodes = json_object_array_length(objKey);
+    for (size_t idx = 0; idx < numberOfCodes; idx++)
+    {
+        json_object * objCode = json_object_array_get_idx(objKey, idx);
+        json_object * objValue = nullptr;
+
+        if (json_object_get_type(objCode) != json_type_object)
+            throw Error(format("Item {} of '{}/{}' is not an object", idx, topic, key));
+
+        ObisRegistry::AdditionalCode obisCode;
+
+        if (!json_object_object_get_ex(objCode, "Code", &objValue) || (json_object_get_type(objValue) != json_type_string))
+            throw Error(format("Item {} of '{}/{}' has no string 'Code'", idx, topic, key));
+        obisCode.Code = json_object_get_string(objValue);
+
+        if (!json_object_object_get_ex(objCode, "Name", &objValue) || (json_object_get_type(objValue) != json_type_string))
+            throw Error(format("Item {} of '{}/{}' has no string 'Name'", idx, topic, key));
+        obisCode.Name = json_object_get_string(objValue);
+
+        if (json_object_object_get_ex(objCode, "Scaler", &objValue))
+        {
+            if ((json_object_get_type(objValue) != json_type_int) && (json_object_get_type(objValue) != json_type_double))
+                throw Error(format("Item {} of '{}/{}': 'Scaler' is not a number", idx, topic, key));
+            obisCode.Scaler = json_object_get_double(objValue);
+        }
+
+        if (json_object_object_get_ex(objCode, "Signed", &objValue))
+        {
+            if (json_object_get_type(objValue) != json_type_boolean)
+                throw Error(format("Item {} of '{}/{}': 'Signed' is not a boolean", idx, topic, key));
+            obisCode.IsSigned = json_object_get_boolean(objValue);
+        }
+
+        if (json_object_object_get_ex(objCode, "Unit", &objValue) && (json_object_get_type(objValue) == json_type_string))
+            obisCode.Unit = json_object_get_string(objValue);
+
+        obisCodes.push_back(obisCode);
+    }
+
+    return obisCodes;
+}
@@ -25,6 +25,11 @@ IN THE SOFTWARE.
 */
 
 #include "Json.h"
+#include "ObisRegistry.h"
+#include "SimulatedInverterRadio.h"
+#include "PeriodicScheduler.h"
+
+#include <vector>
 
 /// @brief The program configuration.
 class Configuration
@@ -49,10 +54,54 @@ public:
     /// @return The database filepath.
     const std::string & GetDatabaseFilepath() const { return _databaseFilepath; }
     
+    /// @brief Returns if a new database shall use the compact storage (integer readings in tables clustered by time).
+    /// @return True for compact storage.
+    bool GetDatabaseCompactStorage() const { return _databaseCompactStorage; }
+
     /// @brief Returns the data acquisition period in seconds.
     /// @return The data acquisition period in seconds.
     double GetDataAcquisitionPeriod() const { return _dataAcquisitionPeriod; }
 
+    /// @brief Returns the maximum time the samples are collected before they are written to the database in one transaction.
+    /// @return The commit interval in seconds.
+    double GetDatabaseCommitInterval() const { return _databaseCommitInterval; }
+
+    /// @brief Returns the number of samples that are written to the database in one transaction (if the commit interval is not over).
+    /// @return The number of samples.
+    int GetDatabaseCommitBatchSize() const { return _databaseCommitBatchSize; }
+
+    /// @brief Returns the age of the readings that are moved to the archive (compressed blocks).
+    /// @return The age in days (0: the readings are not archived).
+    int GetDatabaseArchiveAfterDays() const { return _databaseArchiveAfterDays; }
+
+    /// @brief Returns the data acquisition period of the electricity meters in seconds.
+    /// @return The period in seconds (default: the data acquisition period).
+    double GetElectricityMeterAcquisitionPeriod() const { return _electricityMeterAcquisitionPeriod; }
+
+    /// @brief Returns the data acquisition period of the inverter in seconds.
+    /// @return The period in seconds (default: the data acquisition period).
+    double GetInverterAcquisitionPeriod() const { return _inverterAcquisitionPeriod; }
+
+    /// @brief Returns what happens with the acquisition cycles missed because a cycle took longer than the period.
+    /// @return The overrun policy.
+    PeriodicScheduler::OverrunPolicy GetOverrunPolicy() const { return _overrunPolicy; }
+
+    /// @brief Checks if the location is configured.
+    /// @return True if latitude and longitude are configured.
+    bool HasLocation() const;
+
+    /// @brief Returns the latitude of the location.
+    /// @return The latitude in ° (north positive) or NaN if not configured.
+    double GetLocationLatitude() const { return _locationLatitude; }
+
+    /// @brief Returns the longitude of the location.
+    /// @return The longitude in ° (east positive) or NaN if not configured.
+    double GetLocationLongitude() const { return _locationLongitude; }
+
+    /// @brief Returns the time zone of the location.
+    /// @return The time zone (e.g. "Europe/Berlin") or an empty string if not configured.
+    const std::string & GetLocationTimezone() const { return _locationTimezone; }
+
     /// @brief Returns the inverter serial number.
     /// @return The inverter serial number.
     const std::string & GetInverterSerialNumber() const { return _inverterSerialNumber; }
@@ -61,19 +110,58 @@ public:
     /// @return The number of channels of the inverter.
     int GetInverterNumberOfChannels() const { return _inverterNumberOfChannels; }
 
+    /// @brief Returns the GPIO pin connected to the NRF24L01 IRQ signal.
+    /// @return The GPIO pin or -1 if the IRQ signal is not connected.
+    int GetInverterIrqGpioPin() const { return _inverterIrqGpioPin; }
+
+    /// @brief Returns the file where the learned inverter channel statistics are stored.
+    /// @return The filepath or an empty string if the statistics shall not be stored.
+    const std::string & GetInverterChannelModelFilepath() const { return _inverterChannelModelFilepath; }
+
+    /// @brief Returns the radio used to communicate with the inverter.
+    /// @return "nRF24" for the nRF24L01 module or "Simulation" for a simulated inverter.
+    const std::string & GetInverterRadio() const { return _inverterRadio; }
+
+    /// @brief Returns the parameters of the simulated inverter (if the inverter radio is "Simulation").
+    /// @return The simulation parameters.
+    const SimulatedInverterRadio::Parameters & GetInverterSimulationParameters() const { return _inverterSimulationParameters; }
+
     /// @brief Returns the electricity meter serial port.
     /// @return The electricity meter serial port.
     const std::string & GetElectricityMeterSerialPort() const { return _electricityMeterSerialPort; }
 
+    /// @brief Returns the additional OBIS codes to be read from the electricity meters.
+    /// @return The additional OBIS codes.
+    const std::vector <ObisRegistry::AdditionalCode> & GetElectricityMeterAdditionalObisCodes() const { return _electricityMeterAdditionalObisCodes; }
+
 private:
+    // shortest data acquisition period (in s)
+    constexpr static double MIN_ACQUISITION_PERIOD = 1.0;
+
+    double _locationLatitude;
+    double _locationLongitude;
+    std::string _locationTimezone;
+
     std::string _inverterSerialNumber;
     int _inverterNumberOfChannels;
+    int _inverterIrqGpioPin;
+    std::string _inverterChannelModelFilepath;
+    std::string _inverterRadio;
+    SimulatedInverterRadio::Parameters _inverterSimulationParameters;
 
     std::string _electricityMeterSerialPort;
+    std::vector <ObisRegistry::AdditionalCode> _electricityMeterAdditionalObisCodes;
 
     std::string _databaseFilepath;
+    double _databaseCommitInterval;
+    int _databaseCommitBatchSize;
+    bool _databaseCompactStorage;
+    int _databaseArchiveAfterDays;
 
     double _dataAcquisitionPeriod;
+    double _electricityMeterAcquisitionPeriod;
+    double _inverterAcquisitionPeriod;
+    PeriodicScheduler::OverrunPolicy _overrunPolicy;
 
     static std::string GetStringValue(const Json & json, const std::string & topic, const std::string & key);
     static std::string GetStringValue(const Json & json, const std::string & topic, const std::string & key, const std::string & defaultValue);
@@ -83,6 +171,11 @@ private:
     
     static int GetIntValue(const Json & json, const std::string & topic, const std::string & key);
     static int GetIntValue(const Json & json, const std::string & topic, const std::string & key, int defaultValue);
+
+    static bool GetBoolValue(const Json & json, const std::string & topic, const std::string & key);
+    static bool GetBoolValue(const Json & json, const std::string & topic, const std::string & key, bool defaultValue);
+
+    static std::vector <ObisRegistry::AdditionalCode> GetObisCodes(const Json & json, const std::string & topic, const std::string & key);
     
 };
 
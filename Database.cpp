@@ -24,29 +24,76 @@ IN THE SOFTWARE.
 
 #include <format>
 #include <ctime>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
 
 #include "Database.h"
 #include "Utils.h"
 #include "Logger.h"
+#include "OnScopeExit.h"
+#include "ObisRegistry.h"
+#include "ArchiveBlock.h"
 
 using namespace std;
 using namespace Utils;
 
-Database::Database(const std::string & fileName, int numberOfInverterChannels)
+/// @brief Returns the reading for the rollups. An energy counter reading below 0 is treated as missing (NaN),
+/// older versions stored -1 for a reading that was not received.
+static double GetRollupValue(bool isEnergyCounter, double value)
+{
+    return (isEnergyCounter && (value < 0.0)) ? numeric_limits<double>::quiet_NaN() : value;
+}
+
+Database::Database(const std::string & fileName, int numberOfInverterChannels, const std::vector <std::string> & additionalElectricityMeterColumns,
+    bool isCompactStorage)
 : _database(nullptr)
 {
+    if ((additionalElectricityMeterColumns.size() > ObisRegistry::MAX_ADDITIONAL_READINGS)
+        || (numberOfInverterChannels < 1) || (numberOfInverterChannels > ReadingsRecord::MAX_INVERTER_CHANNELS))
+        throw Error(format("Invalid number of additional electricity meter readings {} or inverter channels {}",
+            additionalElectricityMeterColumns.size(), numberOfInverterChannels));
+
+    // the built-in meter readings are integers scaled by the OBIS registry, the additional readings are stored as REAL
+    for (const auto & entry : ObisRegistry::BUILTIN_ENTRIES)
+    {
+        _columnsElectricityMeter.push_back(string(entry.Name));
+        _unitsPerValueElectricityMeter.push_back(entry.Divisor);
+    }
+
+    for (const auto & column : additionalElectricityMeterColumns)
+    {
+        _columnsElectricityMeter.push_back(column);
+        _unitsPerValueElectricityMeter.push_back(0.0);
+    }
+
     _numberOfInverterChannels = numberOfInverterChannels;
 
     for (int channel = 0; channel < numberOfInverterChannels; channel++)
     {
-        for (auto & reading : _READINGS_INVERTER_CHANNEL)
-            _columnsInverter.push_back(format("CH{} {}", channel, reading));
+        for (int reading = 0; reading < ReadingsRecord::NUMBER_OF_INVERTER_CHANNEL_READINGS; reading++)
+        {
+            _columnsInverter.push_back(format("CH{} {}", channel, ReadingsRecord::INVERTER_CHANNEL_READING_NAMES[reading]));
+            _unitsPerValueInverter.push_back(round(1.0 / RESOLUTIONS_INVERTER_CHANNEL[reading]));
+            _recordIndicesInverter.push_back(ReadingsRecord::InverterChannelIndex(channel, (ReadingsRecord::InverterChannelReading)reading));
+        }
     }
 
-    AppendRange(_columnsInverter, _READINGS_INVERTER);
+    for (int reading = 0; reading < ReadingsRecord::NUMBER_OF_INVERTER_READINGS; reading++)
+    {
+        _columnsInverter.push_back(ReadingsRecord::INVERTER_READING_NAMES[reading]);
+        _unitsPerValueInverter.push_back(round(1.0 / RESOLUTIONS_INVERTER[reading]));
+        _recordIndicesInverter.push_back(ReadingsRecord::InverterIndex((ReadingsRecord::InverterReading)reading));
+    }
+
+    InitializeRollupSources();
 
     OpenDatabase(fileName);
+    _isCompactStorage = DetectCompactStorage(isCompactStorage);
     CreateTablesIfNotExists();
+    PrepareInsertStatements();
 }
 
 Database::~Database()
@@ -67,6 +114,11 @@ void Database::OpenDatabase(const std::string fileName)
 
     int resultCode = sqlite3_open(fileName.c_str(), &_database);
     CheckResult(resultCode, format("Can not open database {}", fileName));
+
+    // with write ahead logging a commit appends to the log instead of rewriting the database pages,
+    // in WAL mode "NORMAL" syncs only at checkpoints and the database stays consistent on power loss
+    SqlExecute("PRAGMA journal_mode=WAL;");
+    SqlExecute("PRAGMA synchronous=NORMAL;");
 }
 
 void Database::CloseDatabase()
@@ -74,6 +126,9 @@ void Database::CloseDatabase()
     if (!_database)
         return;
 
+    // the database can not be closed while statements are not finalized
+    FinalizeStatements();
+
     int resultCode = sqlite3_close(_database);
     CheckResult(resultCode, "Can not close database");
 
@@ -103,79 +158,836 @@ void Database::SqlExecute(const std::string & sql)
 }
 
 void Database::CreateTablesIfNotExists()
+{
+    CreateReadingsTableIfNotExists("Inverter", _columnsInverter, _unitsPerValueInverter);
+    CreateReadingsTableIfNotExists("ElectricityMeter0", _columnsElectricityMeter, _unitsPerValueElectricityMeter);
+    CreateReadingsTableIfNotExists("ElectricityMeter1", _columnsElectricityMeter, _unitsPerValueElectricityMeter);
+
+    // the old readings compressed, one block per readings table and day
+    SqlExecute("CREATE TABLE IF NOT EXISTS Archive (\"table\" TEXT NOT NULL,\"day\" INT NOT NULL,\"first time\" INT NOT NULL,"
+        "\"last time\" INT NOT NULL,\"count\" INT NOT NULL,\"data\" BLOB NOT NULL,PRIMARY KEY (\"table\",\"day\"));");
+
+    CreateRollupTablesIfNotExists();
+}
+
+void Database::CreateReadingsTableIfNotExists(const std::string & tableName, const std::vector <std::string> & columns,
+    const std::vector <double> & unitsPerValue)
+{
+    vector <string> columnDefinitions;
+
+    if (!_isCompactStorage)
+    {
+        for (const auto & column : columns)
+            columnDefinitions.push_back(format("\"{}\" REAL", column));
+
+        SqlExecute(format("CREATE TABLE IF NOT EXISTS {} (\"time\" INT NOT NULL PRIMARY KEY,{});", tableName, Join(columnDefinitions, ",")));
+
+        // tables created by an older configuration may miss the additional readings
+        AddMissingColumns(tableName, columns);
+        return;
+    }
+
+    // the rows are stored in the primary key index (no separate rowid table and time index), so a time range is read sequentially
+    string compactTableName = tableName + COMPACT_TABLE_SUFFIX;
+    vector <string> viewColumns { "\"time\"" };
+
+    for (size_t idx = 0; idx < columns.size(); idx++)
+    {
+        const auto & column = columns[idx];
+
+        if (unitsPerValue[idx] > 0.0)
+        {
+            columnDefinitions.push_back(format("\"{}\" INT", column));
+            viewColumns.push_back(format("\"{0}\"/{1}.0 AS \"{0}\"", column, (int64_t)unitsPerValue[idx]));
+        }
+        else
+        {
+            columnDefinitions.push_back(format("\"{}\" REAL", column));
+            viewColumns.push_back(format("\"{}\"", column));
+        }
+    }
+
+    SqlExecute(format("CREATE TABLE IF NOT EXISTS {} (\"time\" INTEGER NOT NULL PRIMARY KEY,{}) WITHOUT ROWID;",
+        compactTableName, Join(columnDefinitions, ",")));
+
+    AddMissingColumns(compactTableName, columns, unitsPerValue);
+
+    // the view is recreated, so it contains the added columns
+    SqlExecute(format("DROP VIEW IF EXISTS {};", tableName));
+    SqlExecute(format("CREATE VIEW {} AS SELECT {} FROM {};", tableName, Join(viewColumns, ","), compactTableName));
+}
+
+bool Database::DetectCompactStorage(bool isCompactStorageRequested)
+{
+    sqlite3_stmt * statement = nullptr;
+
+    int resultCode = sqlite3_prepare_v2(_database, "SELECT type FROM sqlite_master WHERE name='Inverter';", -1, &statement, nullptr);
+    CheckResult(resultCode, "Can not query the database schema");
+
+    OnScopeExit finalize([&] { sqlite3_finalize(statement); });
+
+    resultCode = sqlite3_step(statement);
+    CheckResult(resultCode, "Can not query the database schema");
+
+    // a new database
+    if (resultCode != SQLITE_ROW)
+        return isCompactStorageRequested;
+
+    // with compact storage "Inverter" is a view
+    bool isCompactStorage = string(reinterpret_cast<const char *>(sqlite3_column_text(statement, 0))) == "view";
+
+    if (isCompactStorage != isCompactStorageRequested)
+        LOG_WARN(format("The existing database uses the {} storage, the configured storage is ignored.", isCompactStorage ? "compact" : "REAL"));
+
+    return isCompactStorage;
+}
+
+void Database::AddMissingColumns(const std::string & tableName, const std::vector <std::string> & columns, const std::vector <double> & unitsPerValue)
+{
+    vector <string> existingColumns;
+    sqlite3_stmt * statement = nullptr;
+
+    int resultCode = sqlite3_prepare_v2(_database, format("PRAGMA table_info({});", tableName).c_str(), -1, &statement, nullptr);
+    CheckResult(resultCode, format("Can not query columns of table {}", tableName));
+
+    while ((resultCode = sqlite3_step(statement)) == SQLITE_ROW)
+        existingColumns.push_back(reinterpret_cast<const char *>(sqlite3_column_text(statement, 1)));
+
+    sqlite3_finalize(statement);
+    CheckResult(resultCode, format("Can not query columns of table {}", tableName));
+
+    for (size_t idx = 0; idx < columns.size(); idx++)
+    {
+        const auto & column = columns[idx];
+
+        if (find(existingColumns.begin(), existingColumns.end(), column) != existingColumns.end())
+            continue;
+
+        const char * columnType = ((idx < unitsPerValue.size()) && (unitsPerValue[idx] > 0.0)) ? "INT" : "REAL";
+
+        LOG_INFO(format("Adding column \"{}\" to table {}", column, tableName));
+        SqlExecute(format("ALTER TABLE {} ADD COLUMN \"{}\" {};", tableName, column, columnType));
+    }
+}
+
+void Database::PrepareInsertStatements()
+{
+    // with compact storage the readings table names are views
+    string suffix = _isCompactStorage ? COMPACT_TABLE_SUFFIX : "";
+
+    _insertElectricityMeterStatements[0] = PrepareInsertStatement("ElectricityMeter0" + suffix, _columnsElectricityMeter);
+    _insertElectricityMeterStatements[1] = PrepareInsertStatement("ElectricityMeter1" + suffix, _columnsElectricityMeter);
+    _insertInverterStatement = PrepareInsertStatement("Inverter" + suffix, _columnsInverter);
+
+    _savepointStatement = PrepareSavepointStatement("SAVEPOINT sp;");
+    _releaseSavepointStatement = PrepareSavepointStatement("RELEASE sp;");
+    _rollbackToSavepointStatement = PrepareSavepointStatement("ROLLBACK TO sp;");
+
+    PrepareRollupStatements();
+}
+
+void Database::FinalizeStatements()
+{
+    for (auto & statement : _insertElectricityMeterStatements)
+    {
+        sqlite3_finalize(statement);
+        statement = nullptr;
+    }
+
+    sqlite3_finalize(_insertInverterStatement);
+    _insertInverterStatement = nullptr;
+
+    for (auto statement : { &_savepointStatement, &_releaseSavepointStatement, &_rollbackToSavepointStatement })
+    {
+        sqlite3_finalize(*statement);
+        *statement = nullptr;
+    }
+
+    for (auto & source : _rollupSources)
+    {
+        for (auto & statement : source.UpsertStatements)
+        {
+            sqlite3_finalize(statement);
+            statement = nullptr;
+        }
+    }
+}
+
+sqlite3_stmt * Database::PrepareInsertStatement(const std::string & tableName, const std::vector <std::string> & columns)
+{
+    vector <string> quotedColumns { "\"time\"" };
+    vector <string> parameters { "?" };
+
+    for (const auto & column : columns)
+    {
+        quotedColumns.push_back(format("\"{}\"", column));
+        parameters.push_back("?");
+    }
+
+    string sql = format("INSERT INTO {} ({}) VALUES ({});", tableName, Join(quotedColumns, ","), Join(parameters, ","));
+
+    sqlite3_stmt * statement = nullptr;
+    int resultCode = sqlite3_prepare_v3(_database, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &statement, nullptr);
+    CheckResult(resultCode, format("Can not prepare insert statement for table {}", tableName));
+
+    return statement;
+}
+
+sqlite3_stmt * Database::PrepareSavepointStatement(const char * sql)
+{
+    sqlite3_stmt * statement = nullptr;
+    int resultCode = sqlite3_prepare_v3(_database, sql, -1, SQLITE_PREPARE_PERSISTENT, &statement, nullptr);
+    CheckResult(resultCode, format("Can not prepare statement {}", sql));
+
+    return statement;
+}
+
+void Database::ExecuteStatement(sqlite3_stmt * statement)
+{
+    int resultCode = sqlite3_step(statement);
+
+    // the statement is reset also on error, so it can be used again
+    sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
+
+    if (resultCode != SQLITE_DONE)
+        throw Error(format("Can not execute SQL command: {} (error code {})", sqlite3_errmsg(_database), resultCode));
+}
+
+void Database::InitializeRollupSources()
+{
+    _rollupSources[0].TableName = "ElectricityMeter0";
+    _rollupSources[0].Columns = _columnsElectricityMeter;
+    _rollupSources[1].TableName = "ElectricityMeter1";
+    _rollupSources[1].Columns = _columnsElectricityMeter;
+    _rollupSources[ROLLUP_SOURCE_INVERTER].TableName = "Inverter";
+    _rollupSources[ROLLUP_SOURCE_INVERTER].Columns = _columnsInverter;
+    _rollupSources[0].UnitsPerValue = _unitsPerValueElectricityMeter;
+    _rollupSources[1].UnitsPerValue = _unitsPerValueElectricityMeter;
+    _rollupSources[ROLLUP_SOURCE_INVERTER].UnitsPerValue = _unitsPerValueInverter;
+
+    for (size_t sourceIdx = 0; sourceIdx < _rollupSources.size(); sourceIdx++)
+    {
+        auto & source = _rollupSources[sourceIdx];
+
+        for (size_t idx = 0; idx < source.Columns.size(); idx++)
+        {
+            source.IsEnergyCounter.push_back(IsEnergyCounter(source.Columns[idx]));
+
+            // missing electricity meter readings are stored as NULL
+            source.IsNullable.push_back(sourceIdx != ROLLUP_SOURCE_INVERTER);
+        }
+
+        source.PreviousValues.assign(source.Columns.size(), numeric_limits<double>::quiet_NaN());
+    }
+}
+
+bool Database::IsEnergyCounter(const std::string & column)
+{
+    // "DC E day" is reset every day, so it is aggregated like the other readings
+    if ((column == "+A") || (column == "+A T1") || (column == "+A T2") || (column == "-A"))
+        return true;
+
+    string energyTotal = "DC E total";
+    return column.ends_with(energyTotal);
+}
+
+std::vector <std::string> Database::GetRollupColumns(const RollupSource & source)
 {
     vector <string> columns;
 
-    // create inverter data table
-    for (const auto & column : _columnsInverter)
-        columns.push_back(format("\"{}\" REAL", column));
+    for (size_t idx = 0; idx < source.Columns.size(); idx++)
+    {
+        const auto & column = source.Columns[idx];
+
+        if (source.IsEnergyCounter[idx])
+        {
+            columns.push_back(column + " first");
+            columns.push_back(column + " last");
+            columns.push_back(column + " delta");
+        }
+        else
+        {
+            columns.push_back(column + " avg");
+            columns.push_back(column + " min");
+            columns.push_back(column + " max");
+
+            if (source.IsNullable[idx])
+                columns.push_back(column + " count");
+        }
+    }
 
-    string columnsStr = Join(columns, ",");
+    return columns;
+}
 
-    string sql = format("CREATE TABLE IF NOT EXISTS Inverter (\"time\" INT NOT NULL PRIMARY KEY,{});", columnsStr);
-    SqlExecute(sql);
+void Database::CreateRollupTablesIfNotExists()
+{
+    for (const auto & source : _rollupSources)
+    {
+        vector <string> rollupColumns = GetRollupColumns(source);
+        vector <string> columns;
 
-    // create electricity meter 1 data table
-    columns.clear();
-    for (const auto & column : _COLUMNS_ELECTRICITY_METER)
-        columns.push_back(format("\"{}\" REAL", column));
+        for (const auto & column : rollupColumns)
+            columns.push_back(format("\"{}\" REAL", column));
 
-    columnsStr = Join(columns, ",");
+        string columnsStr = Join(columns, ",");
 
-    sql = format("CREATE TABLE IF NOT EXISTS ElectricityMeter0 (\"time\" INT NOT NULL PRIMARY KEY,{});", columnsStr);
-    SqlExecute(sql);
-    
-    // create electricity meter 2 data table
-    sql = format("CREATE TABLE IF NOT EXISTS ElectricityMeter1 (\"time\" INT NOT NULL PRIMARY KEY,{});", columnsStr);
-    SqlExecute(sql);
+        for (const auto & rollup : ROLLUPS)
+        {
+            string tableName = source.TableName + rollup.Suffix;
+
+            // "time" is the start of the interval, "count" the number of readings in the interval
+            if (_isCompactStorage)
+                SqlExecute(format("CREATE TABLE IF NOT EXISTS {} (\"time\" INTEGER NOT NULL PRIMARY KEY,\"count\" INT NOT NULL,{}) WITHOUT ROWID;",
+                    tableName, columnsStr));
+            else
+                SqlExecute(format("CREATE TABLE IF NOT EXISTS {} (\"time\" INT NOT NULL PRIMARY KEY,\"count\" INT NOT NULL,{});",
+                    tableName, columnsStr));
+
+            AddMissingColumns(tableName, rollupColumns);
+        }
+    }
 }
 
-void Database::InsertReadingsElectricityMeter(int electricityMeterNum, const readings_type & readings)
+void Database::PrepareRollupStatements()
 {
-    if ((electricityMeterNum < 0) || (electricityMeterNum > 1))
-        throw Error(format("Invalid electricity meter number: {}", electricityMeterNum));
-    
-    ostringstream os;
+    for (auto & source : _rollupSources)
+    {
+        // parameter 1 is the start of the interval, then the readings of the columns, then the energy deltas
+        int numberOfColumns = (int)source.Columns.size();
+        vector <string> columns { "\"time\"", "\"count\"" };
+        vector <string> values { "?1", "1" };
+        vector <string> updates { "\"count\"=\"count\"+1" };
+
+        for (int idx = 0; idx < numberOfColumns; idx++)
+        {
+            const auto & column = source.Columns[idx];
+            string value = format("?{}", idx + 2);
+
+            if (source.IsEnergyCounter[idx])
+            {
+                string first = format("\"{} first\"", column);
+                string last = format("\"{} last\"", column);
+                string delta = format("\"{} delta\"", column);
+
+                columns.insert(columns.end(), { first, last, delta });
+                values.insert(values.end(), { value, value, format("?{}", numberOfColumns + idx + 2) });
+
+                updates.push_back(format("{0}=coalesce({0},excluded.{0})", first));
+                updates.push_back(format("{0}=coalesce(excluded.{0},{0})", last));
+                updates.push_back(format("{0}=coalesce({0},0)+coalesce(excluded.{0},0)", delta));
+            }
+            else
+            {
+                string avg = format("\"{} avg\"", column);
+                string min = format("\"{} min\"", column);
+                string max = format("\"{} max\"", column);
+
+                columns.insert(columns.end(), { avg, min, max });
+                values.insert(values.end(), { value, value, value });
+
+                // the number of readings that are not NULL
+                string count = "\"count\"";
+
+                if (source.IsNullable[idx])
+                {
+                    count = format("\"{} count\"", column);
+                    columns.push_back(count);
+                    values.push_back(format("({} IS NOT NULL)", value));
+                    updates.push_back(format("{0}=coalesce({0},0)+(excluded.{1} IS NOT NULL)", count, avg));
+                    count = format("coalesce({},0)", count);
+                }
+
+                // the SET expressions see the values before the update, min() and max() of NULL are NULL
+                updates.push_back(format("{0}=coalesce(({0}*{1}+excluded.{0})/({1}+1),{0},excluded.{0})", avg, count));
+                updates.push_back(format("{0}=min(coalesce({0},excluded.{0}),coalesce(excluded.{0},{0}))", min));
+                updates.push_back(format("{0}=max(coalesce({0},excluded.{0}),coalesce(excluded.{0},{0}))", max));
+            }
+        }
+
+        for (size_t rollupIdx = 0; rollupIdx < ROLLUPS.size(); rollupIdx++)
+        {
+            string tableName = source.TableName + ROLLUPS[rollupIdx].Suffix;
+            string sql = format("INSERT INTO {} ({}) VALUES ({}) ON CONFLICT(\"time\") DO UPDATE SET {};",
+                tableName, Join(columns, ","), Join(values, ","), Join(updates, ","));
+
+            int resultCode = sqlite3_prepare_v3(_database, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &source.UpsertStatements[rollupIdx], nullptr);
+            CheckResult(resultCode, format("Can not prepare update statement for table {}", tableName));
+        }
+
+        LoadPreviousValues(source);
+    }
+}
+
+void Database::LoadPreviousValues(RollupSource & source)
+{
+    vector <string> columns;
+    for (const auto & column : source.Columns)
+        columns.push_back(format("\"{}\"", column));
+
+    string sql = format("SELECT {} FROM {} ORDER BY \"time\" DESC LIMIT 1;", Join(columns, ","), source.TableName);
+
+    sqlite3_stmt * statement = nullptr;
+    int resultCode = sqlite3_prepare_v2(_database, sql.c_str(), -1, &statement, nullptr);
+    CheckResult(resultCode, format("Can not query latest readings of table {}", source.TableName));
+
+    OnScopeExit finalize([&] { sqlite3_finalize(statement); });
+
+    resultCode = sqlite3_step(statement);
+    CheckResult(resultCode, format("Can not query latest readings of table {}", source.TableName));
+
+    if (resultCode != SQLITE_ROW)
+        return;
+
+    for (size_t idx = 0; idx < source.Columns.size(); idx++)
+    {
+        if (sqlite3_column_type(statement, (int)idx) != SQLITE_NULL)
+            source.PreviousValues[idx] = GetRollupValue(source.IsEnergyCounter[idx], sqlite3_column_double(statement, (int)idx));
+    }
+}
+
+time_t Database::GetIntervalStart(time_t time, int64_t intervalSeconds)
+{
+    if (intervalSeconds != SECONDS_PER_DAY)
+        return time - time % intervalSeconds;
+
+    // the days start at local midnight, so the daily energy matches the day of the user (also at daylight saving changes)
+    tm localTime;
+    localtime_r(&time, &localTime);
+
+    localTime.tm_hour = 0;
+    localTime.tm_min = 0;
+    localTime.tm_sec = 0;
+    localTime.tm_isdst = -1;
+
+    return mktime(&localTime);
+}
+
+void Database::UpdateRollups(RollupSource & source, time_t time, const std::vector <double> & values)
+{
+    int numberOfColumns = (int)source.Columns.size();
+
+    for (size_t rollupIdx = 0; rollupIdx < ROLLUPS.size(); rollupIdx++)
+    {
+        sqlite3_stmt * statement = source.UpsertStatements[rollupIdx];
 
-    os << "INSERT INTO ElectricityMeter";
-    os << electricityMeterNum;
-    os << " VALUES (" << time(nullptr);
+        sqlite3_bind_int64(statement, 1, GetIntervalStart(time, ROLLUPS[rollupIdx].IntervalSeconds));
 
-    for (const auto & key : _COLUMNS_ELECTRICITY_METER)
+        for (int idx = 0; idx < numberOfColumns; idx++)
+        {
+            double value = GetRollupValue(source.IsEnergyCounter[idx], values[idx]);
+
+            if (isnan(value))
+                sqlite3_bind_null(statement, idx + 2);
+            else
+                sqlite3_bind_double(statement, idx + 2, value);
+
+            if (!source.IsEnergyCounter[idx])
+                continue;
+
+            // the energy since the previous reading, unknown after a counter reset (e.g. a replaced meter)
+            double previousValue = source.PreviousValues[idx];
+
+            if (isnan(value) || isnan(previousValue) || (value < previousValue))
+                sqlite3_bind_null(statement, numberOfColumns + idx + 2);
+            else
+                sqlite3_bind_double(statement, numberOfColumns + idx + 2, value - previousValue);
+        }
+
+        ExecuteStatement(statement);
+    }
+
+    for (int idx = 0; idx < numberOfColumns; idx++)
     {
-        os << ",";
+        double value = GetRollupValue(source.IsEnergyCounter[idx], values[idx]);
 
-        auto it = readings.find(key);
-        if (it == readings.end())
-            throw Error(format("did not find key {} in readings from electricity meter number {}", key, electricityMeterNum));
+        if (!isnan(value))
+            source.PreviousValues[idx] = value;
+    }
+}
 
-        os << it->second;
+void Database::RebuildRollups()
+{
+    BeginTransaction();
+
+    OnScopeExit rollback([&] { RollbackTransaction(); });
+
+    for (auto & source : _rollupSources)
+    {
+        for (const auto & rollup : ROLLUPS)
+            SqlExecute(format("DELETE FROM {}{};", source.TableName, rollup.Suffix));
+
+        source.PreviousValues.assign(source.Columns.size(), numeric_limits<double>::quiet_NaN());
+
+        size_t numberOfRows = 0;
+
+        // the archived readings are included
+        ReadReadings(source, 0, numeric_limits<time_t>::max(), [&](time_t time, const vector <double> & values)
+        {
+            UpdateRollups(source, time, values);
+            numberOfRows++;
+        });
+
+        LOG_INFO(format("Rebuilt the rollup tables of table {} from {} readings", source.TableName, numberOfRows));
     }
 
-    os << ");";
+    CommitMaintenanceTransaction();
+}
 
-    SqlExecute(os.str());
+const Database::RollupSource & Database::GetReadingsSource(const std::string & tableName) const
+{
+    for (const auto & source : _rollupSources)
+    {
+        if (source.TableName == tableName)
+            return source;
+    }
+
+    throw Error(format("Unknown readings table {}", tableName));
+}
+
+const std::vector <std::string> & Database::GetReadingsColumns(const std::string & tableName) const
+{
+    return GetReadingsSource(tableName).Columns;
+}
+
+void Database::ReadReadings(const std::string & tableName, time_t fromTime, time_t toTime, const read_callback_type & callback)
+{
+    ReadReadings(GetReadingsSource(tableName), fromTime, toTime, callback);
 }
 
-void Database::InsertReadingsInverter(const readings_type & readings)
+void Database::ReadReadings(const RollupSource & source, time_t fromTime, time_t toTime, const read_callback_type & callback)
 {
-    ostringstream os;
+    vector <string> columns { "\"time\"" };
+    for (const auto & column : source.Columns)
+        columns.push_back(format("\"{}\"", column));
+
+    string sql = format("SELECT {} FROM {} WHERE \"time\">=? AND \"time\"<? ORDER BY \"time\";", Join(columns, ","), source.TableName);
+
+    sqlite3_stmt * readingsStatement = nullptr;
+    int resultCode = sqlite3_prepare_v2(_database, sql.c_str(), -1, &readingsStatement, nullptr);
+    CheckResult(resultCode, format("Can not query readings of table {}", source.TableName));
+
+    OnScopeExit finalizeReadings([&] { sqlite3_finalize(readingsStatement); });
+
+    sqlite3_bind_int64(readingsStatement, 1, fromTime);
+    sqlite3_bind_int64(readingsStatement, 2, toTime);
+
+    // only the blocks of the days in the time range are read and decoded
+    sqlite3_stmt * archiveStatement = nullptr;
+    resultCode = sqlite3_prepare_v2(_database, "SELECT \"data\" FROM Archive WHERE \"table\"=? AND \"day\">=? AND \"day\"<? ORDER BY \"day\";",
+        -1, &archiveStatement, nullptr);
+    CheckResult(resultCode, "Can not query the archive");
+
+    OnScopeExit finalizeArchive([&] { sqlite3_finalize(archiveStatement); });
+
+    sqlite3_bind_text(archiveStatement, 1, source.TableName.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(archiveStatement, 2, GetIntervalStart(fromTime, SECONDS_PER_DAY));
+    sqlite3_bind_int64(archiveStatement, 3, toTime);
+
+    vector <double> values(source.Columns.size());
+
+    // the readings table may contain readings of archived days (e.g. stored after the day was archived), so both are merged by time
+    int readingsResultCode = sqlite3_step(readingsStatement);
 
-    os << "INSERT INTO Inverter VALUES (" << time(nullptr);
+    auto readReadingsBefore = [&](time_t time)
+    {
+        while ((readingsResultCode == SQLITE_ROW) && (sqlite3_column_int64(readingsStatement, 0) < time))
+        {
+            for (size_t idx = 0; idx < values.size(); idx++)
+            {
+                if (sqlite3_column_type(readingsStatement, (int)idx + 1) == SQLITE_NULL)
+                    values[idx] = numeric_limits<double>::quiet_NaN();
+                else
+                    values[idx] = sqlite3_column_double(readingsStatement, (int)idx + 1);
+            }
+
+            callback((time_t)sqlite3_column_int64(readingsStatement, 0), values);
+            readingsResultCode = sqlite3_step(readingsStatement);
+        }
+
+        CheckResult(readingsResultCode, format("Can not query readings of table {}", source.TableName));
+    };
+
+    while ((resultCode = sqlite3_step(archiveStatement)) == SQLITE_ROW)
+    {
+        auto block = ArchiveBlock::Decode(static_cast<const uint8_t *>(sqlite3_column_blob(archiveStatement, 0)),
+            sqlite3_column_bytes(archiveStatement, 0));
+
+        // blocks archived before columns were added lack these columns
+        vector <int> blockColumns;
+        for (const auto & column : source.Columns)
+        {
+            auto it = find(block.GetColumns().begin(), block.GetColumns().end(), column);
+            blockColumns.push_back((it != block.GetColumns().end()) ? (int)(it - block.GetColumns().begin()) : -1);
+        }
+
+        for (size_t row = 0; row < block.GetNumberOfRows(); row++)
+        {
+            time_t time = block.GetTime(row);
+            if ((time < fromTime) || (time >= toTime))
+                continue;
+
+            readReadingsBefore(time);
+
+            for (size_t idx = 0; idx < values.size(); idx++)
+                values[idx] = (blockColumns[idx] >= 0) ? block.GetValue(row, blockColumns[idx]) : numeric_limits<double>::quiet_NaN();
+
+            callback(time, values);
+        }
+    }
+
+    CheckResult(resultCode, "Can not query the archive");
+
+    readReadingsBefore(numeric_limits<time_t>::max());
+}
+
+int Database::ArchiveReadings(time_t archiveBefore, const Deadline & deadline)
+{
+    time_t archiveBeforeDay = GetIntervalStart(archiveBefore, SECONDS_PER_DAY);
+    int numberOfDays = 0;
+    bool isArchived = true;
 
-    for (const auto & key : _columnsInverter)
+    // the oldest day of every readings table is archived in turn, until no day is left or the deadline is reached
+    while (isArchived)
     {
-        os << ",";
+        isArchived = false;
+
+        for (const auto & source : _rollupSources)
+        {
+            if (deadline.IsExpired())
+                return numberOfDays;
+
+            time_t oldestTime = 0;
+            time_t latestTime = 0;
+
+            {
+                // two sub queries, so both use the primary key
+                string sql = format("SELECT (SELECT min(\"time\") FROM {0}),(SELECT max(\"time\") FROM {0});", source.TableName);
+
+                sqlite3_stmt * statement = nullptr;
+                int resultCode = sqlite3_prepare_v2(_database, sql.c_str(), -1, &statement, nullptr);
+                CheckResult(resultCode, format("Can not query time range of table {}", source.TableName));
+
+                OnScopeExit finalize([&] { sqlite3_finalize(statement); });
+
+                resultCode = sqlite3_step(statement);
+                CheckResult(resultCode, format("Can not query time range of table {}", source.TableName));
+
+                if ((resultCode != SQLITE_ROW) || (sqlite3_column_type(statement, 0) == SQLITE_NULL))
+                    continue;
+
+                oldestTime = (time_t)sqlite3_column_int64(statement, 0);
+                latestTime = (time_t)sqlite3_column_int64(statement, 1);
+            }
+
+            time_t dayStart = GetIntervalStart(oldestTime, SECONDS_PER_DAY);
+            time_t nextDayStart = GetNextDayStart(dayStart);
+
+            // the latest readings stay in the readings table, they are the previous values of the energy deltas after a restart
+            if ((nextDayStart > archiveBeforeDay) || (nextDayStart > latestTime))
+                continue;
+
+            ArchiveDay(source, dayStart);
+
+            numberOfDays++;
+            isArchived = true;
+        }
+    }
+
+    return numberOfDays;
+}
+
+void Database::ArchiveDay(const RollupSource & source, time_t dayStart)
+{
+    time_t nextDayStart = GetNextDayStart(dayStart);
+
+    BeginTransaction();
+
+    OnScopeExit rollback([&] { RollbackTransaction(); });
+
+    // the readings of the day including an archived block, the readings table has precedence
+    map <time_t, vector <double>> rows;
+    ReadReadings(source, dayStart, nextDayStart, [&](time_t time, const vector <double> & values) { rows[time] = values; });
+
+    if (rows.empty())
+        return;
+
+    ArchiveBlock block(source.Columns, source.UnitsPerValue);
+    for (const auto & [time, values] : rows)
+        block.AddRow(time, values);
+
+    auto data = block.Encode();
+
+    sqlite3_stmt * statement = nullptr;
+    int resultCode = sqlite3_prepare_v2(_database, "INSERT OR REPLACE INTO Archive VALUES (?,?,?,?,?,?);", -1, &statement, nullptr);
+    CheckResult(resultCode, "Can not prepare statement to archive the readings");
+
+    OnScopeExit finalize([&] { sqlite3_finalize(statement); });
+
+    sqlite3_bind_text(statement, 1, source.TableName.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(statement, 2, dayStart);
+    sqlite3_bind_int64(statement, 3, rows.begin()->first);
+    sqlite3_bind_int64(statement, 4, rows.rbegin()->first);
+    sqlite3_bind_int64(statement, 5, (int64_t)rows.size());
+    sqlite3_bind_blob(statement, 6, data.data(), (int)data.size(), SQLITE_STATIC);
+
+    ExecuteStatement(statement);
+
+    // with compact storage the readings table name is a view
+    string tableName = _isCompactStorage ? source.TableName + COMPACT_TABLE_SUFFIX : source.TableName;
+    SqlExecute(format("DELETE FROM {} WHERE \"time\">={} AND \"time\"<{};", tableName, dayStart, nextDayStart));
 
-        auto it = readings.find(key);
-        if (it != readings.end())
-            os << it->second;
+    CommitMaintenanceTransaction();
+}
+
+time_t Database::GetNextDayStart(time_t dayStart)
+{
+    // a day has 23 to 25 hours at daylight saving changes
+    return GetIntervalStart(dayStart + SECONDS_PER_DAY + SECONDS_PER_DAY / 4, SECONDS_PER_DAY);
+}
+
+double Database::BindReading(sqlite3_stmt * statement, int parameterIndex, double value, double unitsPerValue)
+{
+    if (!_isCompactStorage || (unitsPerValue <= 0.0))
+    {
+        sqlite3_bind_double(statement, parameterIndex, value);
+        return value;
+    }
+
+    // the reading was computed from an integer number of units, so rounding restores the exact integer
+    int64_t units = llround(value * unitsPerValue);
+    sqlite3_bind_int64(statement, parameterIndex, units);
+
+    return units / unitsPerValue;
+}
+
+void Database::InsertReadingsElectricityMeter(int electricityMeterNum, const ReadingsRecord & readings, time_t time)
+{
+    if ((electricityMeterNum < 0) || (electricityMeterNum > 1))
+        throw Error(format("Invalid electricity meter number: {}", electricityMeterNum));
+
+    sqlite3_stmt * statement = _insertElectricityMeterStatements[electricityMeterNum];
+
+    // parameter 1 is the time, the columns follow
+    sqlite3_bind_int64(statement, 1, time);
+    _values.resize(_columnsElectricityMeter.size());
+
+    for (size_t idx = 0; idx < _columnsElectricityMeter.size(); idx++)
+    {
+        // the columns are in the order of the readings record
+        double value = readings.Values[idx];
+        int parameterIndex = (int)idx + 2;
+
+        if (!isnan(value))
+        {
+            _values[idx] = BindReading(statement, parameterIndex, value, _unitsPerValueElectricityMeter[idx]);
+        }
         else
-            os << 0.0;
+        {
+            // a reading the meter did not send is stored as NULL
+            sqlite3_bind_null(statement, parameterIndex);
+            _values[idx] = numeric_limits<double>::quiet_NaN();
+        }
     }
 
-    os << ");";
+    ExecuteStatement(statement);
+    UpdateRollups(_rollupSources[electricityMeterNum], time, _values);
 
-    SqlExecute(os.str());
+    _statistics.Rows++;
 }
 
+void Database::InsertReadingsInverter(const ReadingsRecord & readings, time_t time)
+{
+    sqlite3_stmt * statement = _insertInverterStatement;
+
+    // parameter 1 is the time, the columns follow
+    sqlite3_bind_int64(statement, 1, time);
+
+    _values.resize(_columnsInverter.size());
+
+    for (size_t idx = 0; idx < _columnsInverter.size(); idx++)
+    {
+        // channels the inverter did not report are stored as 0
+        double value = readings.Values[_recordIndicesInverter[idx]];
+        _values[idx] = BindReading(statement, (int)idx + 2, isnan(value) ? 0.0 : value, _unitsPerValueInverter[idx]);
+    }
+
+    ExecuteStatement(statement);
+    UpdateRollups(_rollupSources[ROLLUP_SOURCE_INVERTER], time, _values);
+
+    _statistics.Rows++;
+}
+
+void Database::BeginTransaction()
+{
+    SqlExecute("BEGIN;");
+}
+
+void Database::CommitTransaction()
+{
+    auto startTime = chrono::steady_clock::now();
+
+    SqlExecute("COMMIT;");
+
+    double latencyMs = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+
+    _statistics.Transactions++;
+    _commitLatencySumMs += latencyMs;
+    _statistics.CommitLatencyMeanMs = _commitLatencySumMs / _statistics.Transactions;
+    _statistics.CommitLatencyMaxMs = max(_statistics.CommitLatencyMaxMs, latencyMs);
+}
+
+void Database::RollbackTransaction()
+{
+    if (sqlite3_get_autocommit(_database))
+        return;
+
+    try
+    {
+        SqlExecute("ROLLBACK;");
+    }
+    catch(const exception & exc)
+    {
+        LOG_ERROR(exc);
+    }
+}
+
+void Database::BeginSavepoint()
+{
+    ExecuteStatement(_savepointStatement);
+}
+
+void Database::ReleaseSavepoint()
+{
+    ExecuteStatement(_releaseSavepointStatement);
+}
+
+void Database::RollbackToSavepoint()
+{
+    // some errors (e.g. a full disk) roll back the whole transaction
+    if (sqlite3_get_autocommit(_database))
+        return;
+
+    try
+    {
+        // ROLLBACK TO keeps the savepoint, it is released afterwards
+        ExecuteStatement(_rollbackToSavepointStatement);
+        ExecuteStatement(_releaseSavepointStatement);
+    }
+    catch(const exception & exc)
+    {
+        LOG_ERROR(exc);
+    }
+}
+
+void Database::CommitMaintenanceTransaction()
+{
+    SqlExecute("COMMIT;");
+    _statistics.MaintenanceTransactions++;
+}
+
+std::string Database::Statistics::ToString() const
+{
+    return format("transactions {}, rows {}, maintenance transactions {}, commit latency mean {:.1f} ms, max {:.1f} ms",
+        Transactions, Rows, MaintenanceTransactions, CommitLatencyMeanMs, CommitLatencyMaxMs);
+}
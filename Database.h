@@ -28,15 +28,28 @@ IN THE SOFTWARE.
 #include <string>
 #include <stdexcept>
 #include <vector>
-#include <map>
+#include <array>
 #include <format>
+#include <ctime>
+#include <cstdint>
+#include <functional>
+
+#include "Deadline.h"
+#include "ReadingsRecord.h"
 
 /// @brief Class to store the readings in a SQLite database.
+/// For each readings table the database maintains rollup tables (e.g. ElectricityMeter0_15min) with the readings
+/// aggregated over 1 min, 15 min, 1 hour and 1 day, so dashboards of long time ranges read few rows.
+/// With compact storage the readings are stored as exact integers of the sensor resolution (e.g. 10 µWh) in tables
+/// clustered by time (e.g. ElectricityMeter0_compact), views with the readings table names show the floating point values.
+/// Old readings can be moved to the table Archive, which stores the readings of a readings table and a day as compressed block.
 class Database
 {
 public:
 
-    typedef std::map <std::string, double> readings_type;
+    /// @brief Function called for every row read from a readings table.
+    /// The parameters are the time and the readings in the order of the columns (NaN if NULL).
+    typedef std::function<void(time_t, const std::vector <double> &)> read_callback_type;
 
     /// @brief Database error.
     class Error : public std::runtime_error
@@ -48,7 +61,11 @@ public:
     /// @brief Creates a new instance of the database object.
     /// @param fileName The filename of the SQLite database. If the database does not exists a new one will be created.
     /// @param numberOfInverterChannels Number of inverter channels = number of solar panels.
-    Database(const std::string & fileName, int numberOfInverterChannels);
+    /// @param additionalElectricityMeterColumns Additional electricity meter readings (from additional OBIS codes),
+    /// in the order of their reading index in the OBIS registry.
+    /// @param isCompactStorage True if a new database shall use the compact storage. (An existing database keeps its storage.)
+    Database(const std::string & fileName, int numberOfInverterChannels, const std::vector <std::string> & additionalElectricityMeterColumns = {},
+        bool isCompactStorage = false);
 
     Database(const Database &) = delete;
     Database & operator=(const Database &) = delete;
@@ -57,24 +74,167 @@ public:
 
     /// @brief Inserts the electricity meter readings into the database.
     /// @param electricityMeterNum The electricity meter 0 or 1.
-    /// @param readings The electricity meter readings: "+A", "+A T1", "+A T2", "-A", "P", "P L1", "P L2", "P L3".
-    void InsertReadingsElectricityMeter(int electricityMeterNum, const readings_type & readings);
+    /// @param readings The electricity meter readings: "+A", "+A T1", "+A T2", "-A", "P", "P L1", "P L2", "P L3" and the additional readings.
+    /// Missing readings (NaN) are stored as NULL.
+    /// @param time The time when the readings were taken (in s since the start of the epoch).
+    void InsertReadingsElectricityMeter(int electricityMeterNum, const ReadingsRecord & readings, time_t time);
 
     /// @brief Inserts the inverter readings into the database.
     /// @param readings The inverter readings: "CH0 DC V", "CH0 DC I", "CH0 DC P", "CH0 DC E day", "CH0 DC E total", "CH1 DC V", "CH1 DC I", "CH1 DC P", "CH1 DC E day", "CH1 DC E total", "AC V", "AC I", "AC F", "AC P", "AC Q", "AC PF", "T".
-    void InsertReadingsInverter(const readings_type & readings);
+    /// Missing readings are stored as 0.
+    /// @param time The time when the readings were taken (in s since the start of the epoch).
+    void InsertReadingsInverter(const ReadingsRecord & readings, time_t time);
+
+    /// @brief Rebuilds the rollup tables from the readings tables (e.g. for readings stored by an older version).
+    void RebuildRollups();
+
+    /// @brief Moves the readings of the days before the given time from the readings tables to the table Archive.
+    /// Every day is moved in its own transaction. The day of the latest readings of a table is not moved.
+    /// @param archiveBefore The days that end before this time are archived.
+    /// @param deadline No more days are archived after the deadline.
+    /// @return The number of archived days.
+    int ArchiveReadings(time_t archiveBefore, const Deadline & deadline = Deadline::Never());
+
+    /// @brief Reads the readings of a readings table from the archive and the readings table ordered by time.
+    /// @param tableName The readings table: ElectricityMeter0, ElectricityMeter1 or Inverter.
+    /// @param fromTime The start of the time range.
+    /// @param toTime The end of the time range (excluded).
+    /// @param callback Called for every row.
+    void ReadReadings(const std::string & tableName, time_t fromTime, time_t toTime, const read_callback_type & callback);
+
+    /// @brief Returns the columns of a readings table.
+    /// @param tableName The readings table: ElectricityMeter0, ElectricityMeter1 or Inverter.
+    /// @return The column names (without "time").
+    const std::vector <std::string> & GetReadingsColumns(const std::string & tableName) const;
+
+    /// @brief Starts a transaction. The inserts until the commit are written at once.
+    void BeginTransaction();
+
+    /// @brief Commits the transaction.
+    void CommitTransaction();
+
+    /// @brief Rolls back the transaction (if one is active). Does not throw exceptions.
+    void RollbackTransaction();
+
+    /// @brief Starts a savepoint within the transaction, so the inserts of one sample can be rolled back alone.
+    void BeginSavepoint();
+
+    /// @brief Keeps the inserts since the savepoint in the transaction.
+    void ReleaseSavepoint();
+
+    /// @brief Rolls back the inserts since the savepoint, the transaction stays active. Does not throw exceptions.
+    void RollbackToSavepoint();
+
+    /// @brief The write statistics of the database.
+    struct Statistics
+    {
+        // number of committed transactions of inserted readings and number of inserted rows
+        uint64_t Transactions = 0;
+        uint64_t Rows = 0;
+
+        // number of committed archive and rollup rebuild transactions (not included in the commit latency)
+        uint64_t MaintenanceTransactions = 0;
+
+        // time to commit a transaction of inserted readings (in ms)
+        double CommitLatencyMeanMs = 0.0;
+        double CommitLatencyMaxMs = 0.0;
+
+        /// @brief Returns the statistics as string.
+        /// @return The statistics string.
+        std::string ToString() const;
+    };
+
+    /// @brief Returns the write statistics.
+    /// @return The statistics.
+    const Statistics & GetStatistics() const { return _statistics; }
+
+    /// @brief Checks if the database uses the compact storage.
+    /// @return True for compact storage.
+    bool IsCompactStorage() const { return _isCompactStorage; }
 
 private:
 
-    const std::vector <std::string> _COLUMNS_ELECTRICITY_METER { "+A", "+A T1", "+A T2", "-A", "P", "P L1", "P L2", "P L3" };
-    const std::vector <std::string> _READINGS_INVERTER_CHANNEL { "DC V", "DC I", "DC P", "DC E day", "DC E total" };
-    const std::vector <std::string> _READINGS_INVERTER { "AC V", "AC I", "AC F", "AC P", "AC Q", "AC PF", "T" };
+    // the column names are only used to create the tables and statements, the readings are bound by index
     std::vector <std::string> _columnsInverter;
+    std::vector <std::string> _columnsElectricityMeter;
+
+    // the index of the reading in the readings record for every inverter column
+    // (the electricity meter columns are in the order of the readings record)
+    std::vector <size_t> _recordIndicesInverter;
+
+    // the resolution of the inverter readings (as transmitted by the inverter)
+    constexpr static std::array <double, ReadingsRecord::NUMBER_OF_INVERTER_CHANNEL_READINGS> RESOLUTIONS_INVERTER_CHANNEL { 0.1, 0.01, 0.1, 1.0, 0.001 };
+    constexpr static std::array <double, ReadingsRecord::NUMBER_OF_INVERTER_READINGS> RESOLUTIONS_INVERTER { 0.1, 0.01, 0.01, 0.1, 0.1, 0.001, 0.1 };
+
+    // the compact storage stores a reading as integer number of units (e.g. 1E8 units per kWh), 0 if stored as REAL
+    std::vector <double> _unitsPerValueInverter;
+    std::vector <double> _unitsPerValueElectricityMeter;
+
+    bool _isCompactStorage = false;
+    constexpr static const char * COMPACT_TABLE_SUFFIX = "_compact";
 
     int _numberOfInverterChannels;
 
     sqlite3 *_database;
 
+    // the insert statements are prepared once and reused, so SQLite does not parse and plan them for every sample
+    std::array <sqlite3_stmt *, 2> _insertElectricityMeterStatements { nullptr, nullptr };
+    sqlite3_stmt * _insertInverterStatement = nullptr;
+
+    // the savepoint statements are executed for every sample and prepared once as well
+    sqlite3_stmt * _savepointStatement = nullptr;
+    sqlite3_stmt * _releaseSavepointStatement = nullptr;
+    sqlite3_stmt * _rollbackToSavepointStatement = nullptr;
+
+    Statistics _statistics;
+    double _commitLatencySumMs = 0.0;
+
+    /// @brief A table with the readings aggregated over an interval.
+    struct Rollup
+    {
+        // the table name is the readings table name with this suffix
+        const char * Suffix;
+
+        // the interval in s, one day is a day in local time
+        int64_t IntervalSeconds;
+    };
+
+    constexpr static int64_t SECONDS_PER_DAY = 86400;
+
+    constexpr static std::array <Rollup, 4> ROLLUPS { {
+        { "_1min", 60 },
+        { "_15min", 900 },
+        { "_hourly", 3600 },
+        { "_daily", SECONDS_PER_DAY } } };
+
+    /// @brief A readings table and its rollup tables.
+    struct RollupSource
+    {
+        std::string TableName;
+        std::vector <std::string> Columns;
+
+        // energy counters are aggregated to first, last and delta, the other readings to avg, min and max
+        std::vector <bool> IsEnergyCounter;
+
+        // readings that may be NULL (the electricity meter readings) need their own count for the average
+        std::vector <bool> IsNullable;
+
+        // the resolution of the readings for the compact storage and the archive (0 if unknown)
+        std::vector <double> UnitsPerValue;
+
+        // the previous reading of each column (NaN if unknown), the energy deltas are relative to it
+        std::vector <double> PreviousValues;
+
+        std::array <sqlite3_stmt *, ROLLUPS.size()> UpsertStatements {};
+    };
+
+    // the readings tables ElectricityMeter0, ElectricityMeter1 and Inverter
+    std::array <RollupSource, 3> _rollupSources;
+    constexpr static size_t ROLLUP_SOURCE_INVERTER = 2;
+
+    // the readings of the current insert (NaN if NULL)
+    std::vector <double> _values;
+
     /// @brief Opens the database.
     void OpenDatabase(const std::string fileName);
 
@@ -84,6 +244,115 @@ private:
     /// @brief Creates all missing tables in the database.
     void CreateTablesIfNotExists();
 
+    /// @brief Creates a readings table if it does not exist and adds the missing columns.
+    /// With compact storage the table and a view with the readings table name are created.
+    /// @param tableName The readings table name.
+    /// @param columns The columns (without "time").
+    /// @param unitsPerValue The units per value of the columns for the compact storage (0 for REAL).
+    void CreateReadingsTableIfNotExists(const std::string & tableName, const std::vector <std::string> & columns,
+        const std::vector <double> & unitsPerValue);
+
+    /// @brief Checks the storage of an existing database.
+    /// @param isCompactStorageRequested True if a new database shall use the compact storage.
+    /// @return True if the database uses the compact storage.
+    bool DetectCompactStorage(bool isCompactStorageRequested);
+
+    /// @brief Adds the columns which are missing in an existing table.
+    /// @param tableName The table name.
+    /// @param columns The columns the table must contain.
+    /// @param unitsPerValue Optional, the columns with units per value greater than 0 are INT columns, the others REAL columns.
+    void AddMissingColumns(const std::string & tableName, const std::vector <std::string> & columns, const std::vector <double> & unitsPerValue = {});
+
+    /// @brief Binds a reading to a statement parameter.
+    /// @param statement The statement.
+    /// @param parameterIndex The parameter index.
+    /// @param value The reading.
+    /// @param unitsPerValue The units per value for the compact storage (0 for REAL).
+    /// @return The reading as stored in the database.
+    double BindReading(sqlite3_stmt * statement, int parameterIndex, double value, double unitsPerValue);
+
+    /// @brief Prepares the insert statements. (The tables must exist.)
+    void PrepareInsertStatements();
+
+    /// @brief Finalizes all prepared statements.
+    void FinalizeStatements();
+
+    /// @brief Initializes the readings tables that have rollup tables.
+    void InitializeRollupSources();
+
+    /// @brief Creates the missing rollup tables and adds the missing columns.
+    void CreateRollupTablesIfNotExists();
+
+    /// @brief Prepares the statements to update the rollup tables. (The tables must exist.)
+    void PrepareRollupStatements();
+
+    /// @brief Loads the latest readings of a readings table as previous values for the energy deltas.
+    /// @param source The readings table.
+    void LoadPreviousValues(RollupSource & source);
+
+    /// @brief Adds the readings to the rollup tables of a readings table.
+    /// @param source The readings table.
+    /// @param time The time when the readings were taken.
+    /// @param values The readings in the order of the columns (NaN if NULL).
+    void UpdateRollups(RollupSource & source, time_t time, const std::vector <double> & values);
+
+    /// @brief Returns the columns of the rollup tables.
+    /// @param source The readings table.
+    /// @return The column names.
+    static std::vector <std::string> GetRollupColumns(const RollupSource & source);
+
+    /// @brief Returns the readings table with the given name.
+    /// @param tableName The readings table name.
+    /// @return The readings table.
+    const RollupSource & GetReadingsSource(const std::string & tableName) const;
+
+    /// @brief Reads the readings of a readings table from the archive and the readings table ordered by time.
+    /// @param source The readings table.
+    /// @param fromTime The start of the time range.
+    /// @param toTime The end of the time range (excluded).
+    /// @param callback Called for every row.
+    void ReadReadings(const RollupSource & source, time_t fromTime, time_t toTime, const read_callback_type & callback);
+
+    /// @brief Moves the readings of a day from a readings table to the table Archive.
+    /// An existing block of the day is merged.
+    /// @param source The readings table.
+    /// @param dayStart The start of the day.
+    void ArchiveDay(const RollupSource & source, time_t dayStart);
+
+    /// @brief Commits an archive or rollup rebuild transaction. It is counted separately from the inserted readings.
+    void CommitMaintenanceTransaction();
+
+    /// @brief Returns the start of the day after the given day.
+    /// @param dayStart The start of the day.
+    /// @return The start of the next day.
+    static time_t GetNextDayStart(time_t dayStart);
+
+    /// @brief Returns the start of the interval that contains the time.
+    /// @param time The time.
+    /// @param intervalSeconds The interval in s.
+    /// @return The start of the interval (the local midnight for one day).
+    static time_t GetIntervalStart(time_t time, int64_t intervalSeconds);
+
+    /// @brief Checks if the readings of a column are an energy counter (only increasing).
+    /// @param column The column name.
+    /// @return True for an energy counter.
+    static bool IsEnergyCounter(const std::string & column);
+
+    /// @brief Prepares an insert statement with a parameter for the time and every column.
+    /// @param tableName The table name.
+    /// @param columns The columns.
+    /// @return The prepared statement.
+    sqlite3_stmt * PrepareInsertStatement(const std::string & tableName, const std::vector <std::string> & columns);
+
+    /// @brief Prepares a savepoint statement without parameters.
+    /// @param sql The SQL command.
+    /// @return The prepared statement.
+    sqlite3_stmt * PrepareSavepointStatement(const char * sql);
+
+    /// @brief Executes a prepared statement with the bound parameters and resets it for the next use.
+    /// @param statement The statement.
+    void ExecuteStatement(sqlite3_stmt * statement);
+
     /// @brief Checks the result code and throws an error if it is an error code.
     /// @param resultCode The result code to be checked.
     /// @param message The error message prefix.
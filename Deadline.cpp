@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "Deadline.h"
+#include "CancellationToken.h"
+
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+using namespace std::chrono;
+
+Deadline::Deadline(double budgetSeconds, const CancellationToken * cancellationToken)
+: _timePoint(clock_type::now() + duration_cast<clock_type::duration>(duration<double>(max(budgetSeconds, 0.0))))
+, _cancellationToken(cancellationToken)
+{
+}
+
+Deadline::Deadline(const time_point_type & timePoint, const CancellationToken * cancellationToken)
+: _timePoint(timePoint)
+, _cancellationToken(cancellationToken)
+{
+}
+
+Deadline Deadline::Never()
+{
+    return Deadline(time_point_type::max());
+}
+
+Deadline Deadline::Limit(double budgetSeconds) const
+{
+    Deadline deadline(budgetSeconds);
+    return Deadline(Limit(deadline._timePoint), _cancellationToken);
+}
+
+Deadline::time_point_type Deadline::Limit(const time_point_type & timePoint) const
+{
+    return min(timePoint, _timePoint);
+}
+
+bool Deadline::IsExpired() const
+{
+    if (_cancellationToken && _cancellationToken->IsCancel())
+        return true;
+
+    return clock_type::now() >= _timePoint;
+}
+
+double Deadline::GetRemainingSeconds() const
+{
+    if (_cancellationToken && _cancellationToken->IsCancel())
+        return 0.0;
+
+    auto now = clock_type::now();
+    if (now >= _timePoint)
+        return 0.0;
+
+    return duration<double>(_timePoint - now).count();
+}
+
+bool Deadline::SleepFor(double seconds) const
+{
+    double remainingSeconds = GetRemainingSeconds();
+    bool isShortened = remainingSeconds < seconds;
+    double sleepSeconds = isShortened ? remainingSeconds : seconds;
+
+    if (_cancellationToken)
+        return !_cancellationToken->WaitFor(sleepSeconds) && !isShortened;
+
+    this_thread::sleep_for(duration<double>(sleepSeconds));
+    return !isShortened;
+}
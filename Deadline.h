@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <chrono>
+
+class CancellationToken;
+
+/// @brief A point in time until a task must be finished. All waits and retry loops of the task are bounded by the deadline,
+/// so a device that does not respond can not block the data acquisition cycle.
+/// A deadline with a cancellation token expires immediately on cancellation, so the task stops within milliseconds.
+class Deadline
+{
+public:
+    typedef std::chrono::steady_clock clock_type;
+    typedef clock_type::time_point time_point_type;
+
+    /// @brief Creates a deadline relative to now.
+    /// @param budgetSeconds The time budget in s.
+    /// @param cancellationToken Optional token, the deadline expires on cancellation. (Must outlive the deadline.)
+    explicit Deadline(double budgetSeconds, const CancellationToken * cancellationToken = nullptr);
+
+    /// @brief Creates a deadline at the given point in time.
+    /// @param timePoint The point in time.
+    /// @param cancellationToken Optional token, the deadline expires on cancellation. (Must outlive the deadline.)
+    explicit Deadline(const time_point_type & timePoint, const CancellationToken * cancellationToken = nullptr);
+
+    /// @brief Returns a deadline that never expires.
+    /// @return The deadline.
+    static Deadline Never();
+
+    /// @brief Returns a deadline that expires after the given budget, but not later than this deadline.
+    /// The deadline has the same cancellation token.
+    /// @param budgetSeconds The time budget in s.
+    /// @return The deadline.
+    Deadline Limit(double budgetSeconds) const;
+
+    /// @brief Returns the earlier of the given point in time and the deadline.
+    /// @param timePoint The point in time.
+    /// @return The earlier point in time.
+    time_point_type Limit(const time_point_type & timePoint) const;
+
+    /// @brief Returns the point in time of the deadline.
+    /// @return The point in time.
+    const time_point_type & GetTimePoint() const { return _timePoint; }
+
+    /// @brief Checks if the deadline is reached or cancellation is requested.
+    /// @return True if the deadline is reached.
+    bool IsExpired() const;
+
+    /// @brief Returns the time until the deadline is reached.
+    /// @return The remaining time in s (0 if the deadline is reached or cancellation is requested).
+    double GetRemainingSeconds() const;
+
+    /// @brief Sleeps for the given time, but not beyond the deadline. The sleep is interrupted on cancellation.
+    /// @param seconds The time to sleep in s.
+    /// @return True if the full time was slept, false if the sleep was shortened by the deadline or cancellation.
+    bool SleepFor(double seconds) const;
+
+private:
+    time_point_type _timePoint;
+    const CancellationToken * _cancellationToken;
+};
@@ -28,30 +28,37 @@ IN THE SOFTWARE.
 
 #include <format>
 #include <stdexcept>
-#include <thread>
 #include <chrono>
 #include <iostream>
+#include <cmath>
+#include <limits>
 
 using namespace std;
 
-using std::chrono::steady_clock;
-using std::chrono::duration;
+// path of the value list inside the GetList response message: message body, GetList response, value list
+constexpr static SmlPath VALUE_LIST_PATH("3.1.4");
 
-constexpr static const string ID_PLUS_A     = string("\x01\x00\x01\x08\x00\xFF", 6);
-constexpr static const string ID_PLUS_A_T1  = string("\x01\x00\x01\x08\x01\xFF", 6);
-constexpr static const string ID_PLUS_A_T2  = string("\x01\x00\x01\x08\x02\xFF", 6);
-constexpr static const string ID_MINUS_A    = string("\x01\x00\x02\x08\x00\xFF", 6);
-constexpr static const string ID_POWER      = string("\x01\x00\x10\x07\x00\xFF", 6);
-constexpr static const string ID_POWER_L1   = string("\x01\x00\x24\x07\x00\xFF", 6);
-constexpr static const string ID_POWER_L2   = string("\x01\x00\x38\x07\x00\xFF", 6);
-constexpr static const string ID_POWER_L3   = string("\x01\x00\x4C\x07\x00\xFF", 6);
-
-EbzDd3::EbzDd3(const std::string & serialPortName, int gpioPinSwitch)
+// the reading fields indexed by ObisRegistry::BuiltinReading
+constexpr static double EbzDd3::Readings::* BUILTIN_READING_FIELDS[ObisRegistry::NUMBER_OF_BUILTIN_READINGS] =
+{
+    &EbzDd3::Readings::PlusA,
+    &EbzDd3::Readings::PlusA_T1,
+    &EbzDd3::Readings::PlusA_T2,
+    &EbzDd3::Readings::MinusA,
+    &EbzDd3::Readings::Power,
+    &EbzDd3::Readings::PowerL1,
+    &EbzDd3::Readings::PowerL2,
+    &EbzDd3::Readings::PowerL3,
+};
+
+EbzDd3::EbzDd3(const std::string & serialPortName, int gpioPinSwitch, const std::vector <ObisRegistry::AdditionalCode> & additionalObisCodes)
 : _serialPortName(serialPortName)
 , _gpioSwitch(gpioPinSwitch)
 , _gpio("EbzDd3")
 , _isOpen(false)
 {
+    for (const auto & additionalCode : additionalObisCodes)
+        _obisRegistry.Add(additionalCode);
 
 }
 
@@ -87,7 +94,7 @@ void EbzDd3::Close()
     _serialPort.ClosePort();
 }
 
-void EbzDd3::SelectChannel(int channelNum)
+void EbzDd3::SelectChannel(int channelNum, const Deadline & deadline)
 {
     AssertIsOpen();
 
@@ -105,160 +112,142 @@ void EbzDd3::SelectChannel(int channelNum)
         throw Error(format("SelectChannel(): Invalid channel number {}. Must be 0 or 1.", channelNum));
     }
 
-    this_thread::sleep_for(chrono::milliseconds(100));
+    deadline.SleepFor(CHANNEL_SWITCH_TIME);
 }
 
-void EbzDd3::ReadBlock(const SerialPort & serialPort, std::vector <uint8_t> & data, double timeoutBetweenBytes, double timeoutFirstByte)
+Result<void> EbzDd3::ReceiveInfoData(std::vector <uint8_t> & data, int channelNum, const Deadline & deadline)
 {
     data.clear();
 
-    char buffer[8];
-    auto tm = steady_clock::now();
+    SelectChannel(channelNum, deadline);
 
-    // extra timeout for the first byte?
-    if (timeoutFirstByte > 0.0)
-    {
-        while (true)
-        {
-            try
-            {
-                serialPort.ReadData(buffer, 1, true);
-                data.push_back(buffer[0]);
+    // discard old data
+    _serialPort.ClearInputBuffer();
+    _smlFramer.Reset();
 
-                // first byte received
-                break;
-            }
-            catch(const SerialPort::Timeout &) { }
+    size_t numberOfDiscardedFrames = _smlFramer.GetNumberOfDiscardedFrames();
 
-            if (duration<double>(steady_clock::now() - tm).count() > timeoutFirstByte)
-                return;
-        }
-    }
+    // count the frames discarded by the framer (checksum errors, invalid escape sequences)
+    auto countDiscardedFrames = [&]
+    {
+        for (size_t idx = numberOfDiscardedFrames; idx < _smlFramer.GetNumberOfDiscardedFrames(); idx++)
+            _errorCounters.Count(EK_INVALID_FRAME);
+    };
 
-    // receive bytes and consider the timeout between the bytes
-    tm = steady_clock::now();
-    
-    while (duration<double>(steady_clock::now() - tm).count() < timeoutBetweenBytes)
+    // feed the received bytes into the framer until a complete info message was received
+    RingBuffer & receiveBuffer = _serialPort.GetReceiveBuffer();
+    auto receiveDeadline = deadline.Limit(RECEIVE_INFO_TIMEOUT);
+
+    while (!receiveDeadline.IsExpired())
     {
-        try
+        auto result = _serialPort.TryReceiveData(receiveDeadline.GetTimePoint());
+        if (!result && (result.GetErrorKind() != EK_TIMEOUT))
         {
-            serialPort.ReadData(buffer, 1, true);
-            data.push_back(buffer[0]);
-
-            tm = steady_clock::now();
+            countDiscardedFrames();
+            return Failure(result.GetErrorKind());
         }
-        catch(const SerialPort::Timeout &)
+
+        while (!receiveBuffer.IsEmpty())
         {
-            // ignore
+            size_t bytesConsumed = _smlFramer.Feed(receiveBuffer.GetReadableData());
+            receiveBuffer.Consume(bytesConsumed);
+
+            if (_smlFramer.IsFrameComplete())
+            {
+                auto frame = _smlFramer.GetFrame();
+                data.assign(frame.begin(), frame.end());
+                countDiscardedFrames();
+                return {};
+            }
         }
     }
-}
-
-void EbzDd3::ReceiveInfoData(std::vector <uint8_t> & data, int channelNum)
-{
-    SelectChannel(channelNum);
-
-    // discard old data
-    _serialPort.ClearInputBuffer();
 
-    // wait until time gap before start of the info message
-    ReadBlock(_serialPort, data, 0.3, 0.0);
-    
-    // now receive the info message
-    ReadBlock(_serialPort, data, 0.3, 1.0);
+    countDiscardedFrames();
+    return Failure(EK_TIMEOUT);
 }
 
-bool EbzDd3::ExtractInfoFromDataSet(const SmlData & dataSet, Readings & readings)
+Result<bool> EbzDd3::ExtractInfoFromDataSet(const SmlView & dataSet, Readings & readings) const
 {
-    const std::string & id = dataSet.GetListItem(0).GetString();
+    auto objName = dataSet.TryGetListItem(0);
+    if (!objName)
+        return Failure(objName.GetErrorKind());
 
-    // +A: Active energy, grid supplies to customer.
-    // -A: Active energy, customer supplies to grid
+    auto objNameString = objName->TryGetString();
+    if (!objNameString)
+        return Failure(objNameString.GetErrorKind());
 
-    if (id == ID_PLUS_A)
-    {
-        // meter reading +A, tariff-free in kWh
-        double value = dataSet.GetListItem(5).GetUnsigned();
-        readings.PlusA = value / 1E8;
-        return true;
-    }
+    const ObisRegistry::Entry * entry = _obisRegistry.Find(ObisRegistry::PackObjName(*objNameString));
+    if (!entry)
+        return false;
 
-    if (id == ID_PLUS_A_T1)
-    {
-        // meter reading +A, tariff 1 in kWh
-        double value = dataSet.GetListItem(5).GetUnsigned();
-        readings.PlusA_T1 = value / 1E8;
-        return true;
-    }
+    auto valueItem = dataSet.TryGetListItem(5);
+    if (!valueItem)
+        return Failure(valueItem.GetErrorKind());
 
-    if (id == ID_PLUS_A_T2)
-    {
-        // meter reading +A, tariff 2 in kWh
-        double value = dataSet.GetListItem(5).GetUnsigned();
-        readings.PlusA_T2 = value / 1E8;
-        return true;
-    }
+    double value;
 
-    if (id == ID_MINUS_A)
+    if (entry->IsSigned)
     {
-        // meter reading -A, tariff-free in kWh
-        double value = dataSet.GetListItem(5).GetUnsigned();
-        readings.MinusA = value / 1E8;
-        return true;
-    }
+        auto integer = valueItem->TryGetInteger();
+        if (!integer)
+            return Failure(integer.GetErrorKind());
 
-    if (id == ID_POWER)
-    {
-        // Sum of instantaneous power in all phases in W
-        double value = dataSet.GetListItem(5).GetInteger();
-        readings.Power = value / 1E2;
-        return true;
+        value = (double)*integer;
     }
-
-    if (id == ID_POWER_L1)
+    else
     {
-        // Instantaneous power phase L1 in W
-        double value = dataSet.GetListItem(5).GetInteger();
-        readings.PowerL1 = value / 1E2;
-        return true;
-    }
+        auto unsignedInteger = valueItem->TryGetUnsigned();
+        if (!unsignedInteger)
+            return Failure(unsignedInteger.GetErrorKind());
 
-    if (id == ID_POWER_L2)
-    {
-        // Instantaneous power phase L2 in W
-        double value = dataSet.GetListItem(5).GetInteger();
-        readings.PowerL2 = value / 1E2;
-        return true;
+        value = (double)*unsignedInteger;
     }
 
-    if (id == ID_POWER_L3)
-    {
-        // Instantaneous power phase L3 in W
-        double value = dataSet.GetListItem(5).GetInteger();
-        readings.PowerL3 = value / 1E2;
-        return true;
-    }
+    value = value / entry->Divisor * entry->Scaler;
 
-    return false;
+    if (entry->ReadingIndex < ObisRegistry::NUMBER_OF_BUILTIN_READINGS)
+        readings.*BUILTIN_READING_FIELDS[entry->ReadingIndex] = value;
+    else
+        readings.AdditionalReadings[entry->ReadingIndex - ObisRegistry::NUMBER_OF_BUILTIN_READINGS] = value;
+
+    return true;
 }
 
-void EbzDd3::ExtractInfoFromData(const std::vector<uint8_t> & data, Readings & readings)
+Result<void> EbzDd3::ExtractInfoFromData(const std::vector<uint8_t> & data, Readings & readings) const
 {
-    auto messageList = DecodeSmlMessages(data);
+    // the checksum was already checked by the SML framer
+    auto frame = SmlFrameView::TryCreate(data, false);
+    if (!frame)
+        return Failure(frame.GetErrorKind());
+
+    // get the useful data sets: only the value list of the GetList response is decoded, everything else is skipped
+    auto message = frame->TryFindMessage(SmlFrameView::GET_LIST_RESPONSE);
+    if (!message)
+        return Failure(message.GetErrorKind());
 
-    // get the useful data sets
-    const SmlData & message = messageList.at(1);
-    const SmlData & dataSetList = message.GetListItem(3).GetListItem(1).GetListItem(4);
+    auto dataSetList = message->TrySelect(VALUE_LIST_PATH);
+    if (!dataSetList)
+        return Failure(dataSetList.GetErrorKind());
 
-    // message.PrintValue(cout);
+    ErrorKind dataSetError = EK_NONE;
 
-    for (const auto & dataSet : dataSetList.GetList())
+    auto result = dataSetList->TryForEachListItem([&](const SmlView & dataSet)
     {
-        ExtractInfoFromDataSet(dataSet, readings);
-    }
+        auto dataSetResult = ExtractInfoFromDataSet(dataSet, readings);
+        if (!dataSetResult && (dataSetError == EK_NONE))
+            dataSetError = dataSetResult.GetErrorKind();
+    });
+
+    if (!result)
+        return result;
+
+    if (dataSetError != EK_NONE)
+        return Failure(dataSetError);
+
+    return {};
 }
 
-bool EbzDd3::ReceiveInfo(int channelNum, Readings & readings)
+bool EbzDd3::ReceiveInfo(int channelNum, Readings & readings, const Deadline & deadline)
 {
     AssertIsOpen();
     
@@ -268,11 +257,16 @@ bool EbzDd3::ReceiveInfo(int channelNum, Readings & readings)
     {
         vector <uint8_t> data;
 
-        ReceiveInfoData(data, channelNum);
-        if (data.size() == 0)
-            return false;
+        auto result = ReceiveInfoData(data, channelNum, deadline);
+        if (result)
+            result = ExtractInfoFromData(data, readings);
 
-        ExtractInfoFromData(data, readings);
+        if (!result)
+        {
+            // errors are counted, not logged: a missing or corrupted message is expected now and then
+            _errorCounters.Count(result.GetErrorKind());
+            return false;
+        }
 
         return true;
     }
@@ -299,6 +293,8 @@ void EbzDd3::Readings::Clear()
     PowerL1 = InvalidValue;
     PowerL2 = InvalidValue;
     PowerL3 = InvalidValue;
+
+    AdditionalReadings.fill(numeric_limits<double>::quiet_NaN());
 }
 
 void EbzDd3::Readings::Print(std::ostream & os)
@@ -311,18 +307,20 @@ void EbzDd3::Readings::Print(std::ostream & os)
     os << "P L1  = " << PowerL1 << " " << UnitPowerL1 << endl;
     os << "P L2  = " << PowerL2 << " " << UnitPowerL2 << endl;
     os << "P L3  = " << PowerL3 << " " << UnitPowerL3 << endl;
+
+    for (size_t idx = 0; idx < AdditionalReadings.size(); idx++)
+    {
+        if (!isnan(AdditionalReadings[idx]))
+            os << "additional reading " << idx << " = " << AdditionalReadings[idx] << endl;
+    }
 }
 
-void EbzDd3::Readings::GetReadings(std::map <std::string, double> & readings)
+void EbzDd3::Readings::GetReadings(ReadingsRecord & readings) const
 {
-    readings.clear();
-
-    readings["+A"] = PlusA;
-    readings["+A T1"] = PlusA_T1;
-    readings["+A T2"] = PlusA_T2;
-    readings["-A"] = MinusA;
-    readings["P"] = Power;
-    readings["P L1"] = PowerL1;
-    readings["P L2"] = PowerL2;
-    readings["P L3"] = PowerL3;
+    // the record is indexed by the reading index of the OBIS registry, readings not received are NaN (InvalidValue)
+    for (size_t idx = 0; idx < ObisRegistry::NUMBER_OF_BUILTIN_READINGS; idx++)
+        readings.Values[idx] = this->*BUILTIN_READING_FIELDS[idx];
+
+    for (size_t idx = 0; idx < AdditionalReadings.size(); idx++)
+        readings.Values[ObisRegistry::NUMBER_OF_BUILTIN_READINGS + idx] = AdditionalReadings[idx];
 }
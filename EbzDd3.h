@@ -26,13 +26,20 @@ IN THE SOFTWARE.
 
 #include <vector>
 #include <string>
-#include <map>
+#include <array>
 #include <cstdint>
+#include <limits>
 #include <format>
 
 #include "SerialPort.h"
 #include "Gpio.h"
 #include "SmlDecoder.h"
+#include "SmlFramer.h"
+#include "ObisRegistry.h"
+#include "Result.h"
+#include "ErrorCounters.h"
+#include "Deadline.h"
+#include "ReadingsRecord.h"
 
 /// @brief Class to interface with two EBZ DD3 electricity meter via a serial port and GPIO.
 class EbzDd3
@@ -43,7 +50,8 @@ public:
     class Readings
     {
     public:
-        constexpr static double InvalidValue = -1.0;
+        /// @brief A reading that was not received. (NaN: every number, e.g. -1 W, can be a real power reading.)
+        constexpr static double InvalidValue = std::numeric_limits<double>::quiet_NaN();
 
         /// @brief meter reading +A, tariff-free in kWh (+A: Active energy, grid supplies to customer)
         double PlusA = InvalidValue;   
@@ -77,16 +85,23 @@ public:
         double PowerL3 = InvalidValue;   
         constexpr static const char * UnitPowerL3 = "W";
 
-        /// @brief Sets all values to "InvalidValue".
+        /// @brief Readings of the additional OBIS codes from the configuration, indexed by the reading index of the
+        /// OBIS registry - NUMBER_OF_BUILTIN_READINGS (NaN if not received).
+        std::array <double, ObisRegistry::MAX_ADDITIONAL_READINGS> AdditionalReadings;
+
+        /// @brief Constructor. All values are invalid.
+        Readings() { Clear(); }
+
+        /// @brief Sets all values to "InvalidValue" and the additional readings to NaN.
         void Clear();
 
         /// @brief Prints the readings.
         /// @param os The stream where the readings shall be printed.
         void Print(std::ostream & os);
 
-        /// @brief Returns the readings as a dictionary.
-        /// @param readings The readings dictionary.
-        void GetReadings(std::map <std::string, double> & readings);
+        /// @brief Returns the readings as readings record.
+        /// @param readings The readings record.
+        void GetReadings(ReadingsRecord & readings) const;
     };
 
     /// @brief EbzDd3 error.
@@ -99,7 +114,8 @@ public:
     /// @brief Constructor
     /// @param serialPortName The name of the serial port (e.g. "/dev/ttyS0" on Linux).
     /// @param gpioPinSwitch The GPIO pin number used to switch between electricity meter 1 and 2 (default: 17).
-    EbzDd3(const std::string & serialPortName, int gpioPinSwitch = 17);
+    /// @param additionalObisCodes Additional OBIS codes to be extracted from the meter data.
+    EbzDd3(const std::string & serialPortName, int gpioPinSwitch = 17, const std::vector <ObisRegistry::AdditionalCode> & additionalObisCodes = {});
 
     ~EbzDd3();
 
@@ -114,45 +130,56 @@ public:
 
     /// @brief Selects the channel (= the electricity meter) to read from.
     /// @param channelNum The channel (= the electricity meter) 0 or 1.
-    void SelectChannel(int channelNum);
+    /// @param deadline Waiting for the switch to settle is stopped at this deadline.
+    void SelectChannel(int channelNum, const Deadline & deadline = Deadline::Never());
 
     /// @brief Receives the information from a electricity meter. (The meter readings.)
     /// @param channelNum The channel (= the electricity meter) 0 or 1.
     /// @param readings The electricity meter readings.
+    /// @param deadline Receiving is stopped when the deadline is reached.
     /// @return True if readings are valid.
-    bool ReceiveInfo(int channelNum, Readings & readings);
+    bool ReceiveInfo(int channelNum, Readings & readings, const Deadline & deadline);
+
+    /// @brief Returns the counters of the errors that occurred while receiving the info messages.
+    /// @return The error counters.
+    const ErrorCounters & GetErrorCounters() const { return _errorCounters; }
 
 private:
+    // maximum time to receive one info message (in s), the electricity meter sends a message every second
+    constexpr static double RECEIVE_INFO_TIMEOUT = 2.5;
+
+    // time for the channel switch to settle (in s)
+    constexpr static double CHANNEL_SWITCH_TIME = 0.1;
+
     std::string _serialPortName;
     int _gpioSwitch;
 
     SerialPort _serialPort;
     Gpio _gpio;
+    SmlFramer _smlFramer;
+    ObisRegistry _obisRegistry;
+    ErrorCounters _errorCounters;
 
     bool _isOpen;
     
-    /// @brief Reads a data block from the serial port with specified timeouts.
-    /// @param serialPort The serial port to read from.
-    /// @param data The data buffer to store the read data.
-    /// @param timeoutBetweenBytes The timeout between receiving two bytes in seconds.
-    /// @param timeoutFirstByte The timeout for receiving the first byte in seconds.
-    static void ReadBlock(const SerialPort & serialPort, std::vector <uint8_t> & data, double timeoutBetweenBytes, double timeoutFirstByte);
-
     /// @brief Receives the data of one full info message.
-    /// @param data The data buffer where the received message data is stored.
+    /// @param data The data buffer where the received message data is stored. (Empty if no valid message was received.)
     /// @param channelNum The channel (= electricity meter 0 or 1).
-    void ReceiveInfoData(std::vector <uint8_t> & data, int channelNum);
+    /// @param deadline Receiving is stopped when the deadline is reached.
+    /// @return Success or the serial port error (EK_TIMEOUT if no valid message was received).
+    Result<void> ReceiveInfoData(std::vector <uint8_t> & data, int channelNum, const Deadline & deadline);
 
     /// @brief Extracts meter readings from the received raw data.
-    /// @param data The received raw data.
+    /// @param data The received raw data (a complete frame from the SML framer, the checksum is not checked again).
     /// @param readings The meter readinds.
-    static void ExtractInfoFromData(const std::vector <uint8_t> & data, Readings & readings);
+    /// @return Success or the SML decoding error.
+    Result<void> ExtractInfoFromData(const std::vector <uint8_t> & data, Readings & readings) const;
 
     /// @brief Extracts meter reading from one dataset.
     /// @param dataSet The data for one reading.
     /// @param readings Where to store the reading.
-    /// @return True if a known reading was found-
-    static bool ExtractInfoFromDataSet(const SmlData & dataSet, Readings & readings);
+    /// @return True if a known reading was found, false if the OBIS code is unknown or the SML decoding error.
+    Result<bool> ExtractInfoFromDataSet(const SmlView & dataSet, Readings & readings) const;
 
     /// @brief Ensures that the electricity meter connection is open.
     void AssertIsOpen();
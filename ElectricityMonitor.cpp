@@ -25,82 +25,349 @@ IN THE SOFTWARE.
 #include "ElectricityMonitor.h"
 
 #include "Logger.h"
+#include "Rf24Radio.h"
+#include "SimulatedInverterRadio.h"
+#include "OnScopeExit.h"
 
 #include <chrono>
 #include <thread>
 #include <iostream>
 #include <cstdlib>
+#include <algorithm>
 
 using std::chrono::steady_clock;
+using std::chrono::system_clock;
 using std::chrono::duration;
+using std::chrono::duration_cast;
 using std::chrono::seconds;
+using std::chrono::minutes;
+using std::chrono::days;
+using std::chrono::floor;
 
 using namespace std;
 
 ElectricityMonitor::ElectricityMonitor()
+: _electricityMeterBreakers {
+    CircuitBreaker("Electricity meter 0", DEVICE_FAILURE_THRESHOLD, DEVICE_INITIAL_BACKOFF, DEVICE_MAX_BACKOFF),
+    CircuitBreaker("Electricity meter 1", DEVICE_FAILURE_THRESHOLD, DEVICE_INITIAL_BACKOFF, DEVICE_MAX_BACKOFF) }
+, _inverterBreaker("Inverter", DEVICE_FAILURE_THRESHOLD, DEVICE_INITIAL_BACKOFF, DEVICE_MAX_BACKOFF)
+, _nextInverterQuery(0.0)
 {
-
 }
 
 void ElectricityMonitor::Run(Configuration & configuration, const CancellationToken & cancellationToken)
 {
-    Database database(configuration.GetDatabaseFilepath(), configuration.GetInverterNumberOfChannels());
-    EbzDd3 electricityMeter(configuration.GetElectricityMeterSerialPort(), GPIO_PIN_SWITCH_ELECTRICITY_METER);
-    HoymilesHmDtu hmDut(configuration.GetInverterSerialNumber(), GPIO_PIN_HOYMILES_HM_DTU_CSN, GPIO_PIN_HOYMILES_HM_DTU_CE);
+    vector <string> additionalElectricityMeterColumns;
+    for (const auto & obisCode : configuration.GetElectricityMeterAdditionalObisCodes())
+        additionalElectricityMeterColumns.push_back(obisCode.Name);
+
+    Database database(configuration.GetDatabaseFilepath(), configuration.GetInverterNumberOfChannels(), additionalElectricityMeterColumns,
+        configuration.GetDatabaseCompactStorage());
+    EbzDd3 electricityMeter(configuration.GetElectricityMeterSerialPort(), GPIO_PIN_SWITCH_ELECTRICITY_METER, configuration.GetElectricityMeterAdditionalObisCodes());
+    HoymilesHmDtu hmDut(configuration.GetInverterSerialNumber(), CreateInverterRadio(configuration),
+        configuration.GetInverterChannelModelFilepath());
+
+    if (configuration.HasLocation())
+    {
+        _solarPosition = make_unique<SolarPosition>(configuration.GetLocationLatitude(), configuration.GetLocationLongitude());
+        LOG_INFO(format("Location: latitude {}, longitude {}, time zone {}", configuration.GetLocationLatitude(),
+            configuration.GetLocationLongitude(), configuration.GetLocationTimezone()));
+    }
+    else
+    {
+        LOG_INFO("No location configured, the inverter is queried day and night.");
+    }
 
     electricityMeter.Open();
 
     hmDut.InitializeCommunication();
     LOG_INFO(hmDut.PrintNrf24l01Info());
 
-    hmDut.TestInverterCommunication();
-    (void)cancellationToken;
-    
-    exit(0);
-    // for (size_t cycleCounter = 1; !cancellationToken.IsCancel(); cycleCounter++)
-    // {
-    //     auto startTime = steady_clock::now();
+    double electricityMeterPeriod = configuration.GetElectricityMeterAcquisitionPeriod();
+    double inverterPeriod = configuration.GetInverterAcquisitionPeriod();
+    auto overrunPolicy = configuration.GetOverrunPolicy();
+    SampleSink sampleSink;
+
+    // the electricity meters (serial port and GPIO) and the inverter (SPI radio) share no hardware, so they are read in parallel
+    _stopWorkers.Reset();
+    _isWorkerFailed = false;
+
+    // the workers and the database loop are woken up immediately on cancellation
+    auto stopCallbackId = cancellationToken.RegisterCallback([this] { _stopWorkers.Cancel(); });
+    OnScopeExit unregisterStopCallback([&] { cancellationToken.UnregisterCallback(stopCallbackId); });
+
+    auto interruptCallbackId = _stopWorkers.RegisterCallback([&] { sampleSink.Interrupt(); });
+    OnScopeExit unregisterInterruptCallback([&] { _stopWorkers.UnregisterCallback(interruptCallbackId); });
+
+    thread electricityMeterThread([&]
+    {
+        RunDeviceWorker("Electricity meter",
+            [&](time_t sampleTime, const Deadline & deadline) { CollectElectricityMeterData(electricityMeter, sampleSink, sampleTime, deadline); },
+            electricityMeter.GetErrorCounters(), electricityMeterPeriod, overrunPolicy, cancellationToken);
+    });
+
+    thread inverterThread([&]
+    {
+        RunDeviceWorker("Inverter",
+            [&](time_t sampleTime, const Deadline & deadline) { CollectInverterData(hmDut, sampleSink, inverterPeriod, sampleTime, deadline); },
+            hmDut.GetErrorCounters(), inverterPeriod, overrunPolicy, cancellationToken);
+    });
+
+    auto joinWorkers = [&]
+    {
+        _stopWorkers.Cancel();
+
+        if (electricityMeterThread.joinable())
+            electricityMeterThread.join();
+
+        if (inverterThread.joinable())
+            inverterThread.join();
+    };
+
+    // the workers must be stopped before the devices are destroyed, also if storing fails
+    OnScopeExit stopWorkers(joinWorkers);
+
+    // the database is used by this thread only, the samples are collected and written in one transaction,
+    // so the slow SD card is synced less often (the workers are not affected, they only publish the samples)
+    double commitInterval = configuration.GetDatabaseCommitInterval();
+    size_t commitBatchSize = configuration.GetDatabaseCommitBatchSize();
+    int archiveAfterDays = configuration.GetDatabaseArchiveAfterDays();
+    vector <Sample> samples;
+
+    while (!IsStopRequested(cancellationToken))
+    {
+        if (!sampleSink.WaitAndTakeAll(samples, commitInterval, commitBatchSize))
+            continue;
+
+        StoreSamples(database, samples);
+
+        if (archiveAfterDays > 0)
+        {
+            int numberOfDays = database.ArchiveReadings(time(nullptr) - archiveAfterDays * SECONDS_PER_DAY, Deadline(ARCHIVE_BUDGET, &_stopWorkers));
+
+            if (numberOfDays > 0)
+                LOG_INFO(format("Archived {} days of readings", numberOfDays));
+        }
+
+        if (database.GetStatistics().Transactions % LOG_INTERVAL_CYCLES == 0)
+            LogDatabaseStatistics(database, sampleSink);
+    }
+
+    // store the samples published while stopping, so no pending sample is lost on shutdown
+    joinWorkers();
+
+    if (sampleSink.WaitAndTakeAll(samples, 0.0))
+        StoreSamples(database, samples);
+
+    LogDatabaseStatistics(database, sampleSink);
+
+    if (_isWorkerFailed)
+        throw Error("a device worker failed");
+}
+
+void ElectricityMonitor::RunDeviceWorker(const std::string & workerName, const std::function<void(time_t, const Deadline &)> & collectData,
+    const ErrorCounters & errorCounters, double period, PeriodicScheduler::OverrunPolicy overrunPolicy, const CancellationToken & cancellationToken)
+{
+    try
+    {
+        // the cycles start at wall clock multiples of the period, so they do not drift with the runtime of the cycles
+        PeriodicScheduler scheduler(period, overrunPolicy);
+
+        for (size_t cycleCounter = 1; !IsStopRequested(cancellationToken); )
+        {
+            if (!scheduler.WaitForTick(SAMPLE_WAIT_TIMEOUT, &_stopWorkers))
+                continue;
+
+            // the samples are stored with the scheduled time, so the samples of all devices have the same timestamps
+            collectData(system_clock::to_time_t(scheduler.GetTickTime()), Deadline(period * CYCLE_BUDGET_FRACTION, &_stopWorkers));
+
+            if (cycleCounter % LOG_INTERVAL_CYCLES == 0)
+            {
+                string errors = errorCounters.ToString();
+                LOG_INFO(format("{} worker is running, cycle {}, errors: {}, timing: {}", workerName, cycleCounter,
+                    errors.empty() ? "none" : errors, scheduler.GetStatistics().ToString()));
+            }
+
+            cycleCounter++;
+        }
+    }
+    catch (const exception & exc)
+    {
+        LOG_ERROR(format("{} worker failed: {}", workerName, exc.what()));
+        _isWorkerFailed = true;
+        _stopWorkers.Cancel();
+    }
+}
+
+bool ElectricityMonitor::IsStopRequested(const CancellationToken & cancellationToken) const
+{
+    return cancellationToken.IsCancel() || _stopWorkers.IsCancel();
+}
+
+void ElectricityMonitor::StoreSamples(Database & database, const std::vector <Sample> & samples)
+{
+    database.BeginTransaction();
+
+    // no transaction is left open if the commit fails
+    OnScopeExit rollback([&] { database.RollbackTransaction(); });
+
+    for (const auto & sample : samples)
+    {
+        // a sample that can not be stored (e.g. a second sample with the same time) is rolled back alone,
+        // the other samples of the transaction are stored
+        database.BeginSavepoint();
+
+        try
+        {
+            switch (sample.Source)
+            {
+            case Sample::SS_ELECTRICITY_METER:
+                database.InsertReadingsElectricityMeter(sample.DeviceNumber, sample.Readings, sample.Time);
+                break;
+
+            case Sample::SS_INVERTER:
+                database.InsertReadingsInverter(sample.Readings, sample.Time);
+                break;
+            }
 
-    //     CollectAndStoreData(database, electricityMeter, hmDut);
+            database.ReleaseSavepoint();
+        }
+        catch (const exception & exc)
+        {
+            database.RollbackToSavepoint();
+            _numberOfFailedSamples++;
 
-    //     double tm = duration<double>(steady_clock::now() - startTime).count();
-    //     double delayTime = configuration.GetDataAcquisitionPeriod() - tm;
-    //     if (delayTime < 5.0)
-    //         delayTime = 5.0;
+            LOG_ERROR(format("Sample at {} not stored: {}", sample.Time, exc.what()));
+        }
+    }
 
-    //     if (cycleCounter % 20 == 0)
-    //         LOG_INFO(format("Electricity monitor is running, cycle {}", cycleCounter));
+    database.CommitTransaction();
+}
 
-    //     this_thread::sleep_for(seconds((int)delayTime));
-    // }
+void ElectricityMonitor::LogDatabaseStatistics(const Database & database, const SampleSink & sampleSink) const
+{
+    LOG_INFO(format("Database writer: {}, waiting samples max {}, dropped samples {}, failed samples {}", database.GetStatistics().ToString(),
+        sampleSink.GetMaximumNumberOfWaitingSamples(), sampleSink.GetNumberOfDroppedSamples(), _numberOfFailedSamples));
 }
 
-void ElectricityMonitor::CollectAndStoreData(Database & database, EbzDd3 & electricityMeter, HoymilesHmDtu & hmDtu)
+std::shared_ptr<Radio> ElectricityMonitor::CreateInverterRadio(const Configuration & configuration)
+{
+    if (configuration.GetInverterRadio() == "Simulation")
+    {
+        LOG_INFO("The inverter is simulated!");
+        return make_shared<SimulatedInverterRadio>(configuration.GetInverterSimulationParameters());
+    }
+
+    return make_shared<Rf24Radio>(GPIO_PIN_HOYMILES_HM_DTU_CSN, GPIO_PIN_HOYMILES_HM_DTU_CE, configuration.GetInverterIrqGpioPin());
+}
+
+void ElectricityMonitor::CollectElectricityMeterData(EbzDd3 & electricityMeter, SampleSink & sampleSink, time_t sampleTime, const Deadline & deadline)
 {
     EbzDd3::Readings electricityMeterReadings;
+
+    for (int channelNum = 0; channelNum < (int)_electricityMeterBreakers.size(); channelNum++)
+    {
+        auto & breaker = _electricityMeterBreakers[channelNum];
+        if (!breaker.IsAttemptAllowed())
+            continue;
+
+        electricityMeterReadings.Clear();
+        bool success = electricityMeter.ReceiveInfo(channelNum, electricityMeterReadings, deadline.Limit(ELECTRICITY_METER_BUDGET));
+        if (!success)
+        {
+            breaker.RecordFailure();
+            continue;
+        }
+
+        breaker.RecordSuccess();
+
+        Sample sample { Sample::SS_ELECTRICITY_METER, channelNum, sampleTime, {} };
+        electricityMeterReadings.GetReadings(sample.Readings);
+        sampleSink.Publish(std::move(sample));
+    }
+}
+
+void ElectricityMonitor::CollectInverterData(HoymilesHmDtu & hmDtu, SampleSink & sampleSink, double period, time_t sampleTime, const Deadline & deadline)
+{
+    // the inverter is not queried at night or if it was unreachable the last times
+    if (!IsInverterQueryDue(period) || !_inverterBreaker.IsAttemptAllowed())
+        return;
+
     HoymilesHmDtu::Readings hmDtuReadings;
-    Database::readings_type databaseReadings;
 
-    bool success = electricityMeter.ReceiveInfo(0, electricityMeterReadings);
-    if (success)
+    bool success = hmDtu.QueryInverterInfo(hmDtuReadings, deadline, 50);
+    if (!success)
     {
-        // electricityMeterReadings.Print(cout);
-        electricityMeterReadings.GetReadings(databaseReadings);
-        database.InsertReadingsElectricityMeter(0, databaseReadings);
+        _inverterBreaker.RecordFailure();
+        return;
     }
 
-    electricityMeterReadings.Clear();
-    success = electricityMeter.ReceiveInfo(1, electricityMeterReadings);
-    if (success)
+    _inverterBreaker.RecordSuccess();
+
+    Sample sample { Sample::SS_INVERTER, 0, sampleTime, {} };
+    hmDtuReadings.GetReadings(sample.Readings);
+    sampleSink.Publish(std::move(sample));
+}
+
+bool ElectricityMonitor::IsInverterQueryDue(double dataAcquisitionPeriod)
+{
+    if (!_solarPosition)
+        return true;
+
+    auto now = system_clock::now();
+    double elevation = _solarPosition->GetElevation(now);
+
+    // the inverter is unpowered at night
+    if (elevation < INVERTER_NIGHT_ELEVATION)
     {
-        // electricityMeterReadings.Print(cout);
-        electricityMeterReadings.GetReadings(databaseReadings);
-        database.InsertReadingsElectricityMeter(1, databaseReadings);
+        if (!_isInverterPollingSuspended)
+        {
+            _isInverterPollingSuspended = true;
+
+            string nextSunrise = "none (polar night)";
+            system_clock::time_point sunrise, sunset;
+
+            for (int day = 0; day <= 1; day++)
+            {
+                if (_solarPosition->GetSunriseSunset(now + days(day), sunrise, sunset) && (sunrise > now))
+                {
+                    nextSunrise = format("{:%Y-%m-%d %H:%M}", floor<minutes>(sunrise));
+                    break;
+                }
+            }
+
+            LOG_INFO(format("Inverter polling is suspended for the night, next sunrise: {}", nextSunrise));
+        }
+
+        return false;
     }
 
-    success = hmDtu.QueryInverterInfo(hmDtuReadings, 50);
-    if (success)
+    if (_isInverterPollingSuspended)
     {
+        _isInverterPollingSuspended = false;
+        _nextInverterQuery = Deadline(0.0);
 
+        LOG_INFO(format("Inverter polling is resumed, sun elevation {:.1f}°", elevation));
     }
+
+    if (!_nextInverterQuery.IsExpired())
+        return false;
+
+    // half a period tolerance, so the query is not skipped due to jitter of the cycle
+    double pollingInterval = GetInverterPollingInterval(elevation, dataAcquisitionPeriod);
+    _nextInverterQuery = Deadline(pollingInterval - 0.5 * dataAcquisitionPeriod);
+
+    return true;
+}
+
+double ElectricityMonitor::GetInverterPollingInterval(double elevation, double dataAcquisitionPeriod)
+{
+    if (elevation >= INVERTER_DAY_ELEVATION)
+        return dataAcquisitionPeriod;
+
+    // linear ramp from the twilight interval at the night elevation to the data acquisition period at the day elevation
+    double fraction = clamp((elevation - INVERTER_NIGHT_ELEVATION) / (INVERTER_DAY_ELEVATION - INVERTER_NIGHT_ELEVATION), 0.0, 1.0);
+    double pollingInterval = INVERTER_TWILIGHT_POLLING_INTERVAL * (1.0 - fraction) + dataAcquisitionPeriod * fraction;
+
+    return max(pollingInterval, dataAcquisitionPeriod);
 }
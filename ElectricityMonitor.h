@@ -29,6 +29,20 @@ IN THE SOFTWARE.
 #include "Database.h"
 #include "EbzDd3.h"
 #include "HoymilesHmDtu.h"
+#include "Deadline.h"
+#include "CircuitBreaker.h"
+#include "SolarPosition.h"
+#include "SampleSink.h"
+#include "PeriodicScheduler.h"
+#include "ErrorCounters.h"
+
+#include <array>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <stdexcept>
+#include <format>
 
 constexpr const int GPIO_PIN_SWITCH_ELECTRICITY_METER = 17;
 constexpr const int GPIO_PIN_HOYMILES_HM_DTU_CSN = 0;
@@ -40,24 +54,134 @@ class ElectricityMonitor
 {
 public:
 
+    /// @brief Electricity monitor error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("Electricity monitor error: {}", errorMessage)) { }
+    };
+
     /// @brief Constructor.
     ElectricityMonitor();
 
     ElectricityMonitor(const ElectricityMonitor &) = delete;
     ElectricityMonitor & operator=(const ElectricityMonitor &) = delete;
     
-    /// @brief The main loop.
+    /// @brief The main loop. The electricity meters and the inverter are read by independent worker threads,
+    /// the calling thread stores the samples in the database.
     /// @param configuration The configuration.
     /// @param cancellationToken Token to cancel the main loop.
     void Run(Configuration & configuration, const CancellationToken & cancellationToken);
 
 private:
+    // part of the data acquisition period that may be used to collect the data (the rest is left for sleeping)
+    constexpr static double CYCLE_BUDGET_FRACTION = 0.8;
+
+    // the workers log their state and error counters every this number of cycles,
+    // the database writer logs its statistics every this number of transactions
+    constexpr static size_t LOG_INTERVAL_CYCLES = 20;
+
+    // maximum time the database thread and the workers wait before they check for cancellation (in s),
+    // normally they are woken up by the cancellation
+    constexpr static double SAMPLE_WAIT_TIMEOUT = 0.5;
+
+    // maximum time the database thread archives old readings after a transaction (in s),
+    // a large backlog of old readings is archived in steps, the new samples wait in the sample sink meanwhile
+    constexpr static double ARCHIVE_BUDGET = 2.0;
+
+    constexpr static time_t SECONDS_PER_DAY = 86400;
+
+    // maximum time to receive the readings of one electricity meter (in s)
+    constexpr static double ELECTRICITY_METER_BUDGET = 3.0;
+
+    // the electricity meters and the inverter are skipped after this number of consecutive failures
+    constexpr static int DEVICE_FAILURE_THRESHOLD = 3;
+
+    // backoff time of an unreachable device, doubled after each failed attempt up to the maximum (in s)
+    constexpr static double DEVICE_INITIAL_BACKOFF = 60.0;
+    constexpr static double DEVICE_MAX_BACKOFF = 1800.0;
+
+    // below this sun elevation the inverter is unpowered and not queried (in °)
+    constexpr static double INVERTER_NIGHT_ELEVATION = -3.0;
+
+    // above this sun elevation the inverter is queried in every cycle, below the polling interval is ramped up (in °)
+    constexpr static double INVERTER_DAY_ELEVATION = 3.0;
+
+    // polling interval of the inverter at the night elevation (in s)
+    constexpr static double INVERTER_TWILIGHT_POLLING_INTERVAL = 300.0;
+
+    std::array <CircuitBreaker, 2> _electricityMeterBreakers;
+    CircuitBreaker _inverterBreaker;
 
-    /// @brief Collect and stores the electricity and inverter data.
-    /// @param database The database to store the data.
+    // the sun position at the configured location (null if no location is configured)
+    std::unique_ptr<SolarPosition> _solarPosition;
+    Deadline _nextInverterQuery;
+    bool _isInverterPollingSuspended = false;
+
+    // set to stop the workers, set by a worker that stopped because of an error, too
+    CancellationToken _stopWorkers;
+    std::atomic<bool> _isWorkerFailed = false;
+
+    // number of samples not stored because of a database error (database thread only)
+    size_t _numberOfFailedSamples = 0;
+
+    /// @brief Runs the data acquisition cycles of a device until cancellation or until a worker failed.
+    /// @param workerName The name of the worker (for logging).
+    /// @param collectData Collects the data of the device for one cycle (with the sample time) and publishes the samples.
+    /// @param errorCounters The error counters of the device (for logging).
+    /// @param period The data acquisition period in s.
+    /// @param overrunPolicy What happens with the cycles missed because a cycle took longer than the period.
+    /// @param cancellationToken Token to cancel the worker.
+    void RunDeviceWorker(const std::string & workerName, const std::function<void(time_t, const Deadline &)> & collectData,
+        const ErrorCounters & errorCounters, double period, PeriodicScheduler::OverrunPolicy overrunPolicy,
+        const CancellationToken & cancellationToken);
+
+    /// @brief Checks if the workers shall stop.
+    /// @param cancellationToken Token to cancel the workers.
+    /// @return True if the workers shall stop.
+    bool IsStopRequested(const CancellationToken & cancellationToken) const;
+
+    /// @brief Collects the data of both electricity meters.
     /// @param electricityMeter The electricity meter to collect data.
+    /// @param sampleSink The sink where the samples are published.
+    /// @param sampleTime The time of the samples.
+    /// @param deadline The data must be collected until this deadline.
+    void CollectElectricityMeterData(EbzDd3 & electricityMeter, SampleSink & sampleSink, time_t sampleTime, const Deadline & deadline);
+
+    /// @brief Collects the inverter data (if the inverter is not asleep).
     /// @param hmDtu The hoymiles inverter to collect data.
-    void CollectAndStoreData(Database & database, EbzDd3 & electricityMeter, HoymilesHmDtu & hmDtu);
+    /// @param sampleSink The sink where the samples are published.
+    /// @param period The data acquisition period in s.
+    /// @param sampleTime The time of the samples.
+    /// @param deadline The data must be collected until this deadline.
+    void CollectInverterData(HoymilesHmDtu & hmDtu, SampleSink & sampleSink, double period, time_t sampleTime, const Deadline & deadline);
+
+    /// @brief Stores samples in the database in one transaction. A sample that can not be stored is skipped and counted.
+    /// @param database The database.
+    /// @param samples The samples.
+    void StoreSamples(Database & database, const std::vector <Sample> & samples);
+
+    /// @brief Logs the write statistics of the database and the sample sink.
+    /// @param database The database.
+    /// @param sampleSink The sample sink.
+    void LogDatabaseStatistics(const Database & database, const SampleSink & sampleSink) const;
+
+    /// @brief Checks if the inverter shall be queried in this cycle. The inverter is not queried at night
+    /// and less often at dawn and dusk. (Always true if no location is configured.)
+    /// @param dataAcquisitionPeriod The data acquisition period in s.
+    /// @return True if the inverter shall be queried.
+    bool IsInverterQueryDue(double dataAcquisitionPeriod);
+
+    /// @brief Returns the inverter polling interval depending on the sun elevation.
+    /// @param elevation The sun elevation in °.
+    /// @param dataAcquisitionPeriod The data acquisition period in s.
+    /// @return The polling interval in s.
+    static double GetInverterPollingInterval(double elevation, double dataAcquisitionPeriod);
+
+    /// @brief Creates the radio to communicate with the inverter: the nRF24L01 module or a simulated inverter.
+    /// @param configuration The configuration.
+    /// @return The radio.
+    static std::shared_ptr<Radio> CreateInverterRadio(const Configuration & configuration);
 
 };
 
@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "ErrorCounters.h"
+
+#include <sstream>
+
+using namespace std;
+
+ErrorCounters::ErrorCounters()
+{
+    Clear();
+}
+
+uint64_t ErrorCounters::Get(ErrorKind errorKind) const
+{
+    if ((errorKind <= EK_NONE) || (errorKind >= NUMBER_OF_ERROR_KINDS))
+        return 0;
+
+    return _counters[errorKind].load(memory_order_relaxed);
+}
+
+uint64_t ErrorCounters::GetTotal() const
+{
+    uint64_t total = 0;
+
+    for (const auto & counter : _counters)
+        total += counter.load(memory_order_relaxed);
+
+    return total;
+}
+
+void ErrorCounters::Clear()
+{
+    for (auto & counter : _counters)
+        counter.store(0, memory_order_relaxed);
+}
+
+std::string ErrorCounters::ToString() const
+{
+    ostringstream os;
+    bool first = true;
+
+    for (int errorKind = EK_NONE + 1; errorKind < NUMBER_OF_ERROR_KINDS; errorKind++)
+    {
+        uint64_t count = _counters[errorKind].load(memory_order_relaxed);
+        if (count == 0)
+            continue;
+
+        if (!first)
+            os << ", ";
+
+        os << GetErrorKindName((ErrorKind)errorKind) << ": " << count;
+        first = false;
+    }
+
+    if (first)
+        os << "no errors";
+
+    return os.str();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "Result.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// @brief Counts the errors by error kind, so that failure rates can be measured without logging every error.
+/// The counters can be incremented from any thread.
+class ErrorCounters
+{
+public:
+    /// @brief Constructor.
+    ErrorCounters();
+
+    ErrorCounters(const ErrorCounters &) = delete;
+    ErrorCounters & operator=(const ErrorCounters &) = delete;
+
+    /// @brief Increments the counter of an error kind. EK_NONE is ignored.
+    /// @param errorKind The error kind.
+    void Count(ErrorKind errorKind)
+    {
+        if ((errorKind > EK_NONE) && (errorKind < NUMBER_OF_ERROR_KINDS))
+            _counters[errorKind].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the counter of an error kind.
+    /// @param errorKind The error kind.
+    /// @return The number of errors of this kind.
+    uint64_t Get(ErrorKind errorKind) const;
+
+    /// @brief Returns the total number of errors.
+    /// @return The total number of errors.
+    uint64_t GetTotal() const;
+
+    /// @brief Sets all counters to 0.
+    void Clear();
+
+    /// @brief Returns the counters which are not 0 as string, e.g. "timeout: 3, checksum error: 1".
+    /// @return The counters as string.
+    std::string ToString() const;
+
+private:
+    std::array<std::atomic<uint64_t>, NUMBER_OF_ERROR_KINDS> _counters;
+};
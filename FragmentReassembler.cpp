@@ -0,0 +1,148 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "FragmentReassembler.h"
+
+#include "Utils.h"
+#include "Checksum.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace Utils;
+
+FragmentReassembler::FragmentReassembler(const buffer_type & senderAddress, int expectedNumberOfFrames)
+    : _senderAddress(senderAddress), _expectedNumberOfFrames(min(expectedNumberOfFrames, MAX_NUMBER_OF_FRAMES))
+{
+}
+
+void FragmentReassembler::Clear()
+{
+    for (auto & payload : _payloads)
+        payload.Clear();
+
+    _frameMask = 0;
+    _lastFrameNumber = 0;
+}
+
+Result<bool> FragmentReassembler::AddFragment(std::span<const uint8_t> packet)
+{
+    // header, at least one byte payload and checksum
+    if (packet.size() < PACKET_HEADER_SIZE + 2)
+        return Failure(EK_INVALID_FRAME);
+
+    // the sender address is contained twice in the response
+    if (!equal(_senderAddress.begin(), _senderAddress.end(), packet.begin() + 1))
+        return Failure(EK_INVALID_FRAME);
+
+    if (!equal(_senderAddress.begin(), _senderAddress.end(), packet.begin() + 5))
+        return Failure(EK_INVALID_FRAME);
+
+    uint8_t checksum = Checksum::CalculateCrc8Hoymiles(packet.first(packet.size() - 1));
+    if (checksum != packet[packet.size() - 1])
+        return Failure(EK_CHECKSUM_ERROR);
+
+    // is the frame number valid?
+    int frameNumber = packet[9] & 0x7F;
+    bool isLastFrame = (packet[9] & 0x80) != 0;
+
+    if ((frameNumber < 1) || (frameNumber > MAX_NUMBER_OF_FRAMES))
+        return Failure(EK_INVALID_FRAME);
+
+    if (_expectedNumberOfFrames > 0)
+    {
+        if ((frameNumber > _expectedNumberOfFrames) || (isLastFrame != (frameNumber == _expectedNumberOfFrames)))
+            return Failure(EK_INVALID_FRAME);
+    }
+
+    if (isLastFrame)
+        _lastFrameNumber = frameNumber;
+
+    // header is 10 bytes and last byte is the checksum
+    auto newPayload = packet.subspan(PACKET_HEADER_SIZE, packet.size() - PACKET_HEADER_SIZE - 1);
+    auto & payload = _payloads[frameNumber];
+
+    // the same fragment received again (e.g. on another channel)?
+    if (HasFragment(frameNumber) && equal(payload.begin(), payload.end(), newPayload.begin(), newPayload.end()))
+        return false;
+
+    // new fragment or a fragment from a newer response replaces the old one
+    if (!payload.Assign(newPayload))
+        return Failure(EK_INVALID_FRAME);
+
+    _frameMask |= 1u << frameNumber;
+
+    return true;
+}
+
+bool FragmentReassembler::HasFragment(int frameNumber) const
+{
+    if ((frameNumber < 1) || (frameNumber > MAX_NUMBER_OF_FRAMES))
+        return false;
+
+    return (_frameMask & (1u << frameNumber)) != 0;
+}
+
+bool FragmentReassembler::IsComplete() const
+{
+    if (_lastFrameNumber == 0)
+        return false;
+
+    uint32_t mask = GetFrameMask(_lastFrameNumber);
+    return (_frameMask & mask) == mask;
+}
+
+uint32_t FragmentReassembler::GetMissingFrameMask() const
+{
+    int lastFrameNumber = (_lastFrameNumber > 0) ? _lastFrameNumber : _expectedNumberOfFrames;
+
+    return GetFrameMask(lastFrameNumber) & ~_frameMask;
+}
+
+Result<void> FragmentReassembler::Assemble(buffer_type & data)
+{
+    data.clear();
+
+    if (!IsComplete())
+        return Failure(EK_INCOMPLETE);
+
+    data.reserve(_lastFrameNumber * RadioPacket::CAPACITY);
+
+    for (int frameNumber = 1; frameNumber <= _lastFrameNumber; frameNumber++)
+        data.insert(data.end(), _payloads[frameNumber].begin(), _payloads[frameNumber].end());
+
+    if (data.size() < 2)
+        return Failure(EK_INCOMPLETE);
+
+    // the fragments of different responses can not be combined
+    uint16_t crc1 = GetUInt16(data, (int)data.size() - 2);
+    uint16_t crc2 = Checksum::CalculateCrc16Modbus(span(data).first(data.size() - 2));
+    if (crc1 != crc2)
+    {
+        Clear();
+        return Failure(EK_CHECKSUM_ERROR);
+    }
+
+    return {};
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "Result.h"
+#include "RadioPacket.h"
+
+#include <array>
+#include <bit>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/// @brief Reassembles the response of the inverter from the received packets (fragments).
+/// The fragments are keyed by frame number, so they can arrive in any order and more than once.
+/// The fragments are kept until Clear() is called, so fragments of repeated requests can be combined.
+class FragmentReassembler
+{
+public:
+    typedef std::vector <uint8_t> buffer_type;
+
+    // the frame numbers are 7 bit, the frames 1 ... 31 are supported
+    constexpr static int MAX_NUMBER_OF_FRAMES = 31;
+
+    // the size of the packet header (command, receiver address, sender address, frame number)
+    constexpr static int PACKET_HEADER_SIZE = 10;
+
+    /// @brief Constructor.
+    /// @param senderAddress The radio address of the sender (inverter), 4 bytes.
+    /// @param expectedNumberOfFrames The expected number of frames or 0 if not known.
+    FragmentReassembler(const buffer_type & senderAddress, int expectedNumberOfFrames = 0);
+
+    /// @brief Discards all fragments.
+    void Clear();
+
+    /// @brief Adds a received packet.
+    /// @param packet The packet (unescaped).
+    /// @return True if the fragment is new or replaced a different fragment, false if it is a duplicate.
+    /// EK_INVALID_FRAME if the packet is not from the sender or the frame number is invalid, EK_CHECKSUM_ERROR if the CRC8 is invalid.
+    Result<bool> AddFragment(std::span<const uint8_t> packet);
+
+    /// @brief Returns true if the fragment was received.
+    /// @param frameNumber The frame number (1 ... MAX_NUMBER_OF_FRAMES).
+    /// @return True if the fragment was received.
+    bool HasFragment(int frameNumber) const;
+
+    /// @brief Returns true if no fragment was received.
+    /// @return True if empty.
+    bool IsEmpty() const { return _frameMask == 0; }
+
+    /// @brief Returns the number of received fragments.
+    /// @return The number of fragments.
+    int GetNumberOfFragments() const { return std::popcount(_frameMask); }
+
+    /// @brief Returns the number of the last frame (flagged with 0x80) or 0 if the last frame was not received yet.
+    /// @return The number of the last frame.
+    int GetLastFrameNumber() const { return _lastFrameNumber; }
+
+    /// @brief Returns true if all frames 1 ... last frame were received.
+    /// @return True if complete.
+    bool IsComplete() const;
+
+    /// @brief Returns the frames that are missing.
+    /// If the last frame was not received yet, the frames up to the expected number of frames are checked.
+    /// @return Bit n is set if frame n is missing.
+    uint32_t GetMissingFrameMask() const;
+
+    /// @brief Assembles the payload of all fragments in frame order and checks the CRC16 at the end of the data.
+    /// If the checksum is invalid, the fragments do not belong together and all fragments are discarded.
+    /// @param data The assembled data including the CRC16. (This function clears the buffer first, the capacity is reused.)
+    /// @return Success or EK_INCOMPLETE, EK_CHECKSUM_ERROR.
+    Result<void> Assemble(buffer_type & data);
+
+private:
+    buffer_type _senderAddress;
+    int _expectedNumberOfFrames;
+
+    // payload of the fragments indexed by frame number (preallocated, no heap allocation when fragments are added)
+    std::array <RadioPacket, MAX_NUMBER_OF_FRAMES + 1> _payloads;
+
+    // bit n is set if frame n was received
+    uint32_t _frameMask = 0;
+
+    int _lastFrameNumber = 0;
+
+    /// @brief Returns the mask with the bits 1 ... lastFrameNumber set.
+    /// @param lastFrameNumber The last frame number.
+    /// @return The mask.
+    constexpr static uint32_t GetFrameMask(int lastFrameNumber)
+    {
+        return (uint32_t)((2ull << lastFrameNumber) - 2);
+    }
+};
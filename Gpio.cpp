@@ -26,6 +26,7 @@ IN THE SOFTWARE.
 
 #include <stdexcept>
 #include <format>
+#include <cmath>
 
 using namespace std;
 
@@ -51,7 +52,8 @@ Gpio::~Gpio()
     _chip.reset();
 }
 
-std::shared_ptr<gpiod_line_request> Gpio::RequestLine(unsigned int pinNumber, gpiod_line_direction direction, const std::string & consumer)
+std::shared_ptr<gpiod_line_request> Gpio::RequestLine(unsigned int pinNumber, gpiod_line_direction direction, const std::string & consumer,
+    gpiod_line_edge edge)
 {
 	shared_ptr<gpiod_line_settings> settings(gpiod_line_settings_new(), gpiod_line_settings_free);
 	if (!settings)
@@ -62,6 +64,15 @@ std::shared_ptr<gpiod_line_request> Gpio::RequestLine(unsigned int pinNumber, gp
     if (direction == GPIOD_LINE_DIRECTION_OUTPUT)
 	    gpiod_line_settings_set_output_value(settings.get(), GPIOD_LINE_VALUE_INACTIVE);
 
+    if (edge != GPIOD_LINE_EDGE_NONE)
+    {
+        if (gpiod_line_settings_set_edge_detection(settings.get(), edge))
+            throw Error(format("gpiod_line_settings_set_edge_detection() failed for pin {}", pinNumber));
+
+        if (gpiod_line_settings_set_event_clock(settings.get(), GPIOD_LINE_CLOCK_MONOTONIC))
+            throw Error(format("gpiod_line_settings_set_event_clock() failed for pin {}", pinNumber));
+    }
+
     shared_ptr <gpiod_line_config> lineConfig(gpiod_line_config_new(), gpiod_line_config_free);
 	if (!lineConfig)
         throw Error(format("gpiod_line_config_new() failed for pin {}", pinNumber));
@@ -94,6 +105,88 @@ void Gpio::InitializeGpioLine(int pinNumber, GpioDirection direction)
     _gpioLines[pinNumber] = RequestLine(pinNumber, direction == GD_OUTPUT ? GPIOD_LINE_DIRECTION_OUTPUT : GPIOD_LINE_DIRECTION_INPUT, _applicationName);
 }
 
+void Gpio::InitializeEdgeEventLine(int pinNumber, GpioEdge edge)
+{
+    AssertPinIsValid(pinNumber);
+
+    if (_gpioLines.at(pinNumber))
+        _gpioLines[pinNumber].reset();
+
+    gpiod_line_edge lineEdge = GPIOD_LINE_EDGE_BOTH;
+    if (edge == GE_RISING)
+        lineEdge = GPIOD_LINE_EDGE_RISING;
+    else if (edge == GE_FALLING)
+        lineEdge = GPIOD_LINE_EDGE_FALLING;
+
+    _gpioLines[pinNumber] = RequestLine(pinNumber, GPIOD_LINE_DIRECTION_INPUT, _applicationName, lineEdge);
+
+    if (!_edgeEventBuffer)
+    {
+        _edgeEventBuffer = shared_ptr<gpiod_edge_event_buffer>(gpiod_edge_event_buffer_new(EDGE_EVENT_BUFFER_SIZE), gpiod_edge_event_buffer_free);
+        if (!_edgeEventBuffer)
+            throw Error(format("gpiod_edge_event_buffer_new() failed for pin {}", pinNumber));
+    }
+}
+
+int Gpio::GetEdgeEventFileDescriptor(int pinNumber)
+{
+    return gpiod_line_request_get_fd(GetLine(pinNumber, "GetEdgeEventFileDescriptor"));
+}
+
+bool Gpio::WaitForEdgeEvent(int pinNumber, double timeoutSeconds)
+{
+    auto gpioLine = GetLine(pinNumber, "WaitForEdgeEvent");
+
+    int64_t timeoutNs = (timeoutSeconds > 0.0) ? (int64_t)ceil(timeoutSeconds * 1E9) : 0;
+
+    int result = gpiod_line_request_wait_edge_events(gpioLine, timeoutNs);
+    if (result < 0)
+        throw Error(format("WaitForEdgeEvent() failed for GPIO line {}", pinNumber));
+
+    return result > 0;
+}
+
+void Gpio::ReadEdgeEvents(int pinNumber, std::vector <EdgeEvent> & events)
+{
+    events.clear();
+
+    auto gpioLine = GetLine(pinNumber, "ReadEdgeEvents");
+
+    if (!_edgeEventBuffer)
+        throw Error(format("ReadEdgeEvents() failed, pin {} is not initialized for edge events", pinNumber));
+
+    // reading blocks if no event is pending
+    while (gpiod_line_request_wait_edge_events(gpioLine, 0) > 0)
+    {
+        int numberOfEvents = gpiod_line_request_read_edge_events(gpioLine, _edgeEventBuffer.get(), EDGE_EVENT_BUFFER_SIZE);
+        if (numberOfEvents < 0)
+            throw Error(format("ReadEdgeEvents() failed for GPIO line {}", pinNumber));
+
+        for (int idx = 0; idx < numberOfEvents; idx++)
+        {
+            gpiod_edge_event * event = gpiod_edge_event_buffer_get_event(_edgeEventBuffer.get(), idx);
+
+            events.push_back({
+                gpiod_edge_event_get_event_type(event) == GPIOD_EDGE_EVENT_RISING_EDGE,
+                gpiod_edge_event_get_timestamp_ns(event) });
+        }
+
+        if (numberOfEvents < (int)EDGE_EVENT_BUFFER_SIZE)
+            break;
+    }
+}
+
+gpiod_line_request * Gpio::GetLine(int pinNumber, const char * functionName)
+{
+    AssertPinIsValid(pinNumber);
+
+    auto & gpioLine = _gpioLines[pinNumber];
+    if (!gpioLine)
+        throw Error(format("{}() failed, pin {} is not initialized", functionName, pinNumber));
+
+    return gpioLine.get();
+}
+
 void Gpio::SetPinLevel(int pinNumber, int level)
 {
     auto gpioLine = _gpioLines.at(pinNumber);
@@ -31,6 +31,7 @@ IN THE SOFTWARE.
 #include <stdexcept>
 #include <format>
 #include <memory>
+#include <cstdint>
 
 class Gpio
 {
@@ -43,6 +44,23 @@ public:
         GD_OUTPUT
     };
 
+    enum GpioEdge
+    {
+        GE_RISING,
+        GE_FALLING,
+        GE_BOTH
+    };
+
+    /// @brief An edge event of an input line.
+    struct EdgeEvent
+    {
+        /// @brief True for a rising edge, false for a falling edge.
+        bool IsRisingEdge;
+
+        /// @brief Time of the edge in ns (CLOCK_MONOTONIC, same clock as std::chrono::steady_clock).
+        uint64_t TimestampNs;
+    };
+
     /// @brief GPIO error.
     class Error : public std::runtime_error
     {
@@ -75,11 +93,37 @@ public:
     /// @return The level of the pin (0 = low, 1 = high).
     int ReadPinLevel(int pinNumber);
 
+    /// @brief Configures the specified pin as input with edge detection. Must be called before waiting for edge events.
+    /// @param pinNumber The GPIO pin number.
+    /// @param edge The edges to detect.
+    void InitializeEdgeEventLine(int pinNumber, GpioEdge edge);
+
+    /// @brief Returns the file descriptor of an edge event line, e.g. to wait for edge events with poll().
+    /// The file descriptor becomes readable if an edge event is pending.
+    /// @param pinNumber The GPIO pin number.
+    /// @return The file descriptor.
+    int GetEdgeEventFileDescriptor(int pinNumber);
+
+    /// @brief Waits until an edge event is pending or the timeout expires.
+    /// @param pinNumber The GPIO pin number.
+    /// @param timeoutSeconds The timeout in seconds.
+    /// @return True if an edge event is pending, false on timeout.
+    bool WaitForEdgeEvent(int pinNumber, double timeoutSeconds);
+
+    // maximum number of edge events read at once
+    constexpr static size_t EDGE_EVENT_BUFFER_SIZE = 16;
+
+    /// @brief Reads all pending edge events (does not block if no edge event is pending).
+    /// @param pinNumber The GPIO pin number.
+    /// @param events The edge events. (This function clears the list first.)
+    void ReadEdgeEvents(int pinNumber, std::vector <EdgeEvent> & events);
+
 private:
     std::string _applicationName;
     std::shared_ptr<gpiod_chip> _chip;
     int _numberOfLines;
     std::vector <std::shared_ptr<gpiod_line_request>> _gpioLines;
+    std::shared_ptr<gpiod_edge_event_buffer> _edgeEventBuffer;
 
     /// @brief Checks if the specified pin number is valid.
     /// @param pinNumber The GPIO pin number to check.
@@ -89,8 +133,16 @@ private:
     /// @param pinNumber The GPIO pin number.
     /// @param direction Input or output direction.
     /// @param consumer The application name.
+    /// @param edge The edges to detect (input only).
     /// @return The requested line.
-    std::shared_ptr<gpiod_line_request> RequestLine(unsigned int pinNumber, gpiod_line_direction direction, const std::string & consumer);
+    std::shared_ptr<gpiod_line_request> RequestLine(unsigned int pinNumber, gpiod_line_direction direction, const std::string & consumer,
+        gpiod_line_edge edge = GPIOD_LINE_EDGE_NONE);
+
+    /// @brief Returns an initialized line.
+    /// @param pinNumber The GPIO pin number.
+    /// @param functionName The name of the calling function for the error message.
+    /// @return The line.
+    gpiod_line_request * GetLine(int pinNumber, const char * functionName);
 };  
 
 
@@ -25,6 +25,7 @@ IN THE SOFTWARE.
 #include "HoymilesHmDtu.h"
 
 #include "Utils.h"
+#include "Checksum.h"
 #include "OnScopeExit.h"
 #include "Logger.h"
 
@@ -32,20 +33,23 @@ IN THE SOFTWARE.
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 using namespace Utils;
 using namespace std::chrono;
 
-const std::vector<int> HoymilesHmDtu::TX_CHANNELS = { 3, 23, 40, 61, 75 };
+const HoymilesHmDtu::rx_channel_list_type & HoymilesHmDtu::GetRxChannelList(int txChannel)
+{
+    for (size_t idx = 0; idx < TX_CHANNELS.size(); idx++)
+    {
+        if (TX_CHANNELS[idx] == txChannel)
+            return RX_CHANNEL_LISTS[idx];
+    }
 
-const std::map <int, std::vector <int>> HoymilesHmDtu::RX_CHANNEL_LISTS = {
-    {  3, { 23, 40, 61 }},
-    { 23, { 40, 61, 75 }},
-    { 40, { 61, 75,  3 }},
-    { 61, { 75,  3, 23 }},
-    { 75, {  3, 23, 40 }},
-};
+    throw Error(format("Internal error: no RX channels for tx channel {}", txChannel));
+}
 
 HoymilesHmDtu::ChannelReadings::ChannelReadings()
 : _channelNumber(0)
@@ -91,6 +95,30 @@ void HoymilesHmDtu::Readings::Print(std::ostream & os) const
     os << "    EVT:               " << _EVT             << " " << UnitEVT << endl;
 }
 
+void HoymilesHmDtu::Readings::GetReadings(ReadingsRecord & readings) const
+{
+    readings.Clear();
+
+    for (int channel = 0; channel < (int)_channelReadingsList.size(); channel++)
+    {
+        const auto & channelReadings = _channelReadingsList[channel];
+
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_VOLTAGE)] = channelReadings.GetDcVoltage();
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_CURRENT)] = channelReadings.GetDcCurrent();
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_POWER)] = channelReadings.GetDcPower();
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_ENERGY_DAY)] = channelReadings.GetDcEnergyDay();
+        readings.Values[ReadingsRecord::InverterChannelIndex(channel, ReadingsRecord::ICR_DC_ENERGY_TOTAL)] = channelReadings.GetDcEnergyTotal();
+    }
+
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_VOLTAGE)] = _acVoltage;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_CURRENT)] = _acCurrent;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_FREQUENCY)] = _acFrequency;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_POWER)] = _acPower;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_REACTIVE_POWER)] = _acReactivePower;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_AC_POWER_FACTOR)] = _acPowerFactor;
+    readings.Values[ReadingsRecord::InverterIndex(ReadingsRecord::IR_TEMPERATURE)] = _temperature;
+}
+
 void HoymilesHmDtu::Readings::ExtractReadings(int numberOfChannels, const buffer_type & data)
 {
     if ((numberOfChannels != 1) && (numberOfChannels != 2) && (numberOfChannels != 4))
@@ -137,19 +165,27 @@ void HoymilesHmDtu::Readings::ExtractReadings(const buffer_type & data,
     _EVT = GetUInt16(data, idxEVT) / 1.0;               // -
 }
 
-HoymilesHmDtu::HoymilesHmDtu(const std::string & inverterSerialNumber, int pinCSn, int pinCE)
-    : _inverterSerialNumber(inverterSerialNumber)
-    , _pinCSn(pinCSn)
-    , _pinCE(pinCE)
-    , _randomEngine()
-    , _randomTxChannel(0, TX_CHANNELS.size() - 1)
+HoymilesHmDtu::HoymilesHmDtu(const std::string & inverterSerialNumber, std::shared_ptr<Radio> radio,
+    const std::string & channelModelFilepath)
+    : _radio(radio)
+    , _inverterSerialNumber(inverterSerialNumber)
+    , _dtuRadioAddress(GenerateDtuRadioAddress())
+    , _inverterRadioAddress(GetInverterRadioAddress(inverterSerialNumber))
+    , _inverterNumberOfChannels(GetInverterNumberOfChannels(inverterSerialNumber))
+    , _reassembler(_inverterRadioAddress, _inverterNumberOfChannels + 1)
+    , _channelModel(TX_CHANNELS, TX_CHANNELS) // the inverter responds on the TX channels of the other requests
+    , _channelModelFilepath(channelModelFilepath)
+    , _randomEngine(random_device()())
 {
-    if (_inverterSerialNumber.length() != 12)
-        throw Error(format("Inverter serial number has not 12 digits: {}", _inverterSerialNumber));
+    if (!_radio)
+        throw Error("No radio!");
+
+    // the request packet is created once, only the time and the checksums are updated for each request
+    CreateRequestInfoPacket(_requestInfoPacket, _inverterRadioAddress, _dtuRadioAddress);
 
-    _dtuRadioAddress = GenerateDtuRadioAddress();
-    _inverterRadioAddress = GetInverterRadioAddress(_inverterSerialNumber);
-    _inverterNumberOfChannels = GetInverterNumberOfChannels(_inverterSerialNumber);
+    // the buffers are allocated once, so the queries do not allocate memory
+    _responseData.reserve(FragmentReassembler::MAX_NUMBER_OF_FRAMES * RadioPacket::CAPACITY);
+    _irqTimestampsNs.reserve(Radio::RECEIVE_INTERRUPT_BUFFER_SIZE);
 
     _writingPipeAddress.push_back(0x01);
     AppendRange(_writingPipeAddress, _inverterRadioAddress);
@@ -157,13 +193,25 @@ HoymilesHmDtu::HoymilesHmDtu(const std::string & inverterSerialNumber, int pinCS
     _readingPipeAddress.push_back(0x01);
     AppendRange(_readingPipeAddress, _dtuRadioAddress);
 
-    
+    // a missing or invalid channel model is not fatal, the channels are learned again
+    if (!_channelModelFilepath.empty())
+    {
+        try
+        {
+            _channelModel.Load(_channelModelFilepath);
+        }
+        catch (const exception & exc)
+        {
+            LOG_ERROR(exc);
+        }
+    }
 }
 
 HoymilesHmDtu::~HoymilesHmDtu()
 {
     try
     {
+        SaveChannelModel();
         TerminateCommunication();
     }
     catch(const exception & exc)
@@ -172,14 +220,17 @@ HoymilesHmDtu::~HoymilesHmDtu()
     }
 }
 
+void HoymilesHmDtu::SaveChannelModel() const
+{
+    if (!_channelModelFilepath.empty())
+        _channelModel.Save(_channelModelFilepath);
+}
+
 std::string HoymilesHmDtu::PrintNrf24l01Info()
 {
     AssertCommunicationIsInitialized();
 
-    vector <char> buffer(1024, '\0');
-    _radio->sprintfPrettyDetails(&(buffer[0]));
-
-    return string(&(buffer[0]));
+    return _radio->GetDetails();
 }
 
 HoymilesHmDtu::buffer_type HoymilesHmDtu::GenerateDtuRadioAddress()
@@ -246,53 +297,60 @@ int HoymilesHmDtu::GetInverterNumberOfChannels(const std::string & inverterSeria
 
 void HoymilesHmDtu::AssertCommunicationIsInitialized() const
 {
-    if (!_radio)
+    if (!_radio->IsInitialized())
     {
         throw Error("Communication is not initialized!");
     }
 }
 
-void HoymilesHmDtu::EscapeData(buffer_type & dest, const buffer_type & src)
+void HoymilesHmDtu::EscapeData(RadioPacket & dest, std::span<const uint8_t> src)
 {
-    dest.clear();
-    dest.reserve(src.size() * 2);
+    dest.Clear();
 
     // Replaces bytes with special meaning by escape sequences.
     // 0x7D -> 0x7D 0x5D
     // 0x7E -> 0x7D 0x5E
     // 0x7F -> 0x7D 0x5F
 
+    bool success = true;
+
     for (uint8_t b : src)
     {
         switch (b)
         {
             case 0x7D:
-                dest.push_back(0x7D);
-                dest.push_back(0x5D);
+                success = dest.PushBack(0x7D) && dest.PushBack(0x5D);
                 break;
 
             case 0x7E:
-                dest.push_back(0x7D);
-                dest.push_back(0x5E);
+                success = dest.PushBack(0x7D) && dest.PushBack(0x5E);
                 break;
 
             case 0x7F:
-                dest.push_back(0x7D);
-                dest.push_back(0x5F);
+                success = dest.PushBack(0x7D) && dest.PushBack(0x5F);
                 break;
 
             default:
-                dest.push_back(b);
+                success = dest.PushBack(b);
                 break;
         }
+
+        if (!success)
+            throw Error(format("EscapeData(): escaped data exceeds the packet size {}", RadioPacket::CAPACITY));
     }
 }
 
-void HoymilesHmDtu::UnescapeData(buffer_type & dest, const buffer_type & src)
+void HoymilesHmDtu::UnescapeData(RadioPacket & dest, std::span<const uint8_t> src)
 {
-    dest.clear();
-    dest.reserve(src.size() + 16);
+    if (!TryUnescapeData(dest, src))
+        throw Error("UnescapeData(): Invalid data, can not decode.");
+}
 
+Result<void> HoymilesHmDtu::TryUnescapeData(RadioPacket & dest, std::span<const uint8_t> src)
+{
+    dest.Clear();
+
+    // the unescaped data is never longer than the escaped data, so the packet can not overflow
     for (size_t idx = 0; idx < src.size(); idx++)
     {
         uint8_t b = src[idx];
@@ -300,130 +358,49 @@ void HoymilesHmDtu::UnescapeData(buffer_type & dest, const buffer_type & src)
         if (b == 0x7D)
         {
             idx++;
-            b = src.at(idx);
+            if (idx >= src.size())
+                return Failure(EK_INVALID_ESCAPE_SEQUENCE);
+
+            b = src[idx];
 
             switch (b)
             {
                 case 0x5D:
-                    dest.push_back(0x7D);
+                    dest.PushBack(0x7D);
                     break;
 
                 case 0x5E:
-                    dest.push_back(0x7E);
+                    dest.PushBack(0x7E);
                     break;
 
                 case 0x5F:
-                    dest.push_back(0x7F);
+                    dest.PushBack(0x7F);
                     break;
 
                 default:
-                    throw Error("UnescapeData(): Invalid data, can not decode.");
+                    return Failure(EK_INVALID_ESCAPE_SEQUENCE);
             }
         }
-        else
+        else if (!dest.PushBack(b))
         {
-            dest.push_back(b);
+            return Failure(EK_BUFFER_OVERFLOW);
         }
-
     }
-}
-
-uint8_t HoymilesHmDtu::CalculateCrc8(const buffer_type & data, size_t startPos, size_t endPos)
-{
-    uint32_t crc = 0;
 
-    for (size_t idx = startPos; idx < endPos; idx++)
-    {
-        crc ^= data[idx];
-
-        for (int p = 0; p < 8; p++)
-        {
-            crc <<= 1;
-
-            if (crc & 0x0100)
-                crc ^= 0x01;
-
-            crc &= 0xFF;
-        }
-    }
-
-    return static_cast<uint8_t>(crc);
-}
-
-uint16_t HoymilesHmDtu::CalculateCrc16(const buffer_type & data, size_t startPos, size_t endPos)
-{
-    uint32_t crc = 0xFFFF;
-
-    for (size_t idx = startPos; idx < endPos; idx++)
-    {
-        crc ^= data[idx];
-
-        for (int p = 0; p < 8; p++)
-        {
-            if (crc & 0x0001)
-            {
-                crc >>= 1;
-                crc ^= 0xA001;
-            }
-            else
-            {
-                crc >>= 1;
-            }
-        }
-    }
-
-    return static_cast<uint16_t>(crc);
-}
-
-bool HoymilesHmDtu::CheckPacketChecksum(const buffer_type & packet)
-{
-    uint8_t checksum1 = CalculateCrc8(packet, 0, packet.size() - 1);
-    uint8_t checksum2 = packet[packet.size() - 1];
-
-    return checksum1 == checksum2;
+    return {};
 }
 
 void HoymilesHmDtu::InitializeCommunication()
 {
-    TerminateCommunication();
-
-    auto radio = make_shared<RF24>(_pinCE, _pinCSn, SPI_FREQUENCY_HZ);
-
-    if (!radio->begin())
-        throw Error("Can not initialize RF24!");
-    
-    if (!radio->isChipConnected())
-        throw Error("Error chip is not connected!");
-
-    radio->stopListening();
-
-    radio->setDataRate(RF24_250KBPS);
-    radio->setPALevel(RF24_PA_MIN);
-    radio->setCRCLength(RF24_CRC_16);
-    radio->setAddressWidth(5);
-
-    radio->openWritingPipe(&(_writingPipeAddress[0]));
-    radio->openReadingPipe(RX_PIPE_NUM, &(_readingPipeAddress[0]));
-
-    radio->enableDynamicPayloads();
-    radio->setRetries(3, 10);
-    radio->setAutoAck(true);
-
-    _radio = radio;
+    _radio->Initialize(_writingPipeAddress, _readingPipeAddress);
 }
 
 void HoymilesHmDtu::TerminateCommunication()
 {
-    if (!_radio)
-        return;
-
-    // recommended idle behavior is TX mode
-    _radio->stopListening();
-
-    _radio.reset();
+    _radio->Terminate();
 }
 
-void HoymilesHmDtu::CreatePacketHeader(buffer_type & packetHeader, uint8_t command, const buffer_type & receiverAddr,
+void HoymilesHmDtu::CreatePacketHeader(RadioPacket & packetHeader, uint8_t command, const buffer_type & receiverAddr,
     const buffer_type & senderAddr, uint8_t frame)
 {
     if (receiverAddr.size() != 4)
@@ -434,130 +411,153 @@ void HoymilesHmDtu::CreatePacketHeader(buffer_type & packetHeader, uint8_t comma
     
     size_t sz = packetHeader.size();
 
-    packetHeader.push_back(command);
-    AppendRange(packetHeader, receiverAddr);
-    AppendRange(packetHeader, senderAddr);
-    packetHeader.push_back(frame);
+    packetHeader.PushBack(command);
+    packetHeader.Append(receiverAddr);
+    packetHeader.Append(senderAddr);
+    packetHeader.PushBack(frame);
     
     if (packetHeader.size() - sz != 10)
         throw Error(format("Internal error __CreatePacketHeader: size {} != 10", packetHeader.size()));
 }
 
-void HoymilesHmDtu::CreateRequestInfoPayload(buffer_type & payload, uint32_t currentTime)
+void HoymilesHmDtu::CreateRequestInfoPayload(RadioPacket & payload)
 {
     size_t sz = payload.size();
 
-    payload.push_back(0x0B); // sub command
-    payload.push_back(0x00); // revision
+    payload.PushBack(0x0B); // sub command
+    payload.PushBack(0x00); // revision
 
-    payload.push_back((uint8_t)(currentTime >> 24));
-    payload.push_back((uint8_t)(currentTime >> 16));
-    payload.push_back((uint8_t)(currentTime >>  8));
-    payload.push_back((uint8_t)(currentTime >>  0));
+    // the time (4 bytes) is set before the request is sent
+    payload.Append(array<uint8_t, 4> { 0x00, 0x00, 0x00, 0x00 });
 
-    payload.push_back(0x00);
-    payload.push_back(0x00);
-    payload.push_back(0x00);
+    payload.PushBack(0x00);
+    payload.PushBack(0x00);
+    payload.PushBack(0x00);
 
-    payload.push_back(0x05);
+    payload.PushBack(0x05);
     
-    payload.push_back(0x00);
-    payload.push_back(0x00);
-    payload.push_back(0x00);
-    payload.push_back(0x00);
+    payload.PushBack(0x00);
+    payload.PushBack(0x00);
+    payload.PushBack(0x00);
+    payload.PushBack(0x00);
     
     if (payload.size() - sz != 14)
         throw Error(format("Internal error CreateRequestInfoPayload: size {} != 14", payload.size()));
 }
 
-void HoymilesHmDtu::CreateRequestInfoPacket(buffer_type & packet, const buffer_type & receiverAddr,
-    const buffer_type & senderAddr, uint32_t currentTime)
+void HoymilesHmDtu::CreateRequestInfoPacket(RadioPacket & packet, const buffer_type & receiverAddr, const buffer_type & senderAddr)
 {
-    packet.clear();
-    packet.reserve(MAX_PACKET_SIZE);
+    packet.Clear();
 
-    vector<uint8_t> tmpPacket;
-    tmpPacket.reserve(MAX_PACKET_SIZE);
-    
     // add the header
-    CreatePacketHeader(tmpPacket, 0x15, receiverAddr, senderAddr, 0x80);
+    CreatePacketHeader(packet, 0x15, receiverAddr, senderAddr, 0x80);
 
     // add the payload
-    size_t payloadStartPos = tmpPacket.size();
-    CreateRequestInfoPayload(tmpPacket, currentTime);
-
-    // add the payload checksum
-    uint16_t payloadChecksum = CalculateCrc16(tmpPacket, payloadStartPos, tmpPacket.size());
-    UInt16ToBytes(tmpPacket, payloadChecksum, true);
+    CreateRequestInfoPayload(packet);
 
-    // add the packet checksum
-    uint8_t packetChecksum = CalculateCrc8(tmpPacket, 0, tmpPacket.size());
-    tmpPacket.push_back(packetChecksum);
+    // reserve the payload checksum and the packet checksum
+    packet.PushBack(0x00);
+    packet.PushBack(0x00);
+    packet.PushBack(0x00);
 
     // check the length
-    if (tmpPacket.size() != 27)
-        throw Error(format("Internal error CreateRequestInfoPacket: packet size {} != 27", packet.size()));
+    if (packet.size() != REQUEST_INFO_PACKET_SIZE)
+        throw Error(format("Internal error CreateRequestInfoPacket: packet size {} != {}", packet.size(), REQUEST_INFO_PACKET_SIZE));
 
-    // replace special characters
-    EscapeData(packet, tmpPacket);
+    SetRequestInfoPacketTime(packet, 0);
+}
+
+void HoymilesHmDtu::SetRequestInfoPacketTime(RadioPacket & packet, uint32_t currentTime)
+{
+    if (packet.size() != REQUEST_INFO_PACKET_SIZE)
+        throw Error(format("Internal error SetRequestInfoPacketTime: packet size {} != {}", packet.size(), REQUEST_INFO_PACKET_SIZE));
+
+    span<uint8_t> data(packet.data(), packet.size());
 
-    if (packet.size() > MAX_PACKET_SIZE)
-        throw Error(format("Internal error CreateRequestInfoPacket: packet size {} > MAX_PACKET_SIZE {}", packet.size(), MAX_PACKET_SIZE));
+    data[REQUEST_INFO_TIME_POS + 0] = (uint8_t)(currentTime >> 24);
+    data[REQUEST_INFO_TIME_POS + 1] = (uint8_t)(currentTime >> 16);
+    data[REQUEST_INFO_TIME_POS + 2] = (uint8_t)(currentTime >>  8);
+    data[REQUEST_INFO_TIME_POS + 3] = (uint8_t)(currentTime >>  0);
+
+    // the payload checksum
+    size_t payloadSize = REQUEST_INFO_PAYLOAD_CHECKSUM_POS - REQUEST_INFO_PAYLOAD_POS;
+    uint16_t payloadChecksum = Checksum::CalculateCrc16Modbus(data.subspan(REQUEST_INFO_PAYLOAD_POS, payloadSize));
+    data[REQUEST_INFO_PAYLOAD_CHECKSUM_POS + 0] = (uint8_t)(payloadChecksum >> 8);
+    data[REQUEST_INFO_PAYLOAD_CHECKSUM_POS + 1] = (uint8_t)(payloadChecksum >> 0);
+
+    // the packet checksum
+    data[REQUEST_INFO_PACKET_SIZE - 1] = Checksum::CalculateCrc8Hoymiles(data.first(REQUEST_INFO_PACKET_SIZE - 1));
 }
 
-void HoymilesHmDtu::SendRequestAndScanForResponses(std::vector <buffer_type> & responsePacketList,
-    int txChannel, const std::vector <int> & rxChannelList, const buffer_type & txPacket)
+void HoymilesHmDtu::CreateRequestRetransmitPacket(RadioPacket & packet, const buffer_type & receiverAddr,
+    const buffer_type & senderAddr, int frameNumber)
 {
-    responsePacketList.clear();
+    if ((frameNumber < 1) || (frameNumber > FragmentReassembler::MAX_NUMBER_OF_FRAMES))
+        throw Error(format("CreateRequestRetransmitPacket: invalid frame number {}", frameNumber));
 
-    AssertCommunicationIsInitialized();
+    RadioPacket tmpPacket;
 
-    if (txPacket.size() > MAX_PACKET_SIZE)
-        throw Error(format("SendRequestAndScanForResponses: packet size {} > MAX_PACKET_SIZE {}", txPacket.size(), MAX_PACKET_SIZE));
+    // the header with the number of the missing frame, there is no payload
+    CreatePacketHeader(tmpPacket, 0x15, receiverAddr, senderAddr, (uint8_t)(0x80 | frameNumber));
 
-    uint32_t rxChannelIndex = 0;
+    // add the packet checksum
+    uint8_t packetChecksum = Checksum::CalculateCrc8Hoymiles(tmpPacket);
+    tmpPacket.PushBack(packetChecksum);
 
-    buffer_type packet;
-    packet.reserve(MAX_PACKET_SIZE);
+    // replace special characters
+    EscapeData(packet, tmpPacket);
+}
 
-    // send request to the inverter
-    _radio->stopListening();
+int HoymilesHmDtu::SendRequestAndScanForResponses(FragmentReassembler & reassembler,
+    int txChannel, std::span<const int> rxChannelList, const RadioPacket & txPacket, const Deadline & deadline,
+    int scanTimeMs, int awaitedFrameNumber)
+{
+    AssertCommunicationIsInitialized();
 
-    _radio->flush_rx();
-    _radio->flush_tx();
+    // send request to the inverter
+    _radio->StopListening();
 
-    _radio->setChannel(txChannel);
-     this_thread::sleep_for(microseconds(150));
+    _radio->FlushRx();
+    _radio->FlushTx();
 
-    _radio->write(&(txPacket[0]), (uint8_t)txPacket.size());
+    _radio->SetChannel(txChannel);
+    _radio->Write(txPacket);
     
     // scan channels for response from the inverter
-    _radio->startListening();
-    
-    // all inverter responses should be received within 500 ms
-    constexpr int maxScanTimeMs = 500;
+    auto scanDeadline = deadline.Limit(scanTimeMs / 1000.0);
 
-    auto startTime1 = steady_clock::now();
-    auto endTime1 = startTime1 + milliseconds(maxScanTimeMs);
-    while (steady_clock::now() < endTime1)
+    if (_radio->HasReceiveInterrupt())
+        return ScanForResponsesIrq(reassembler, rxChannelList, scanDeadline, awaitedFrameNumber);
+    else
+        return ScanForResponsesPolling(reassembler, rxChannelList, scanDeadline, awaitedFrameNumber);
+}
+
+int HoymilesHmDtu::ScanForResponsesPolling(FragmentReassembler & reassembler,
+    std::span<const int> rxChannelList, const Deadline & scanDeadline, int awaitedFrameNumber)
+{
+    uint32_t rxChannelIndex = 0;
+    int numberOfPackets = 0;
+
+    RadioPacket packet;
+
+    _radio->StartListening();
+
+    while (!scanDeadline.IsExpired())
     {
         int rxChannel = rxChannelList[rxChannelIndex];
         rxChannelIndex++;
         if (rxChannelIndex >= rxChannelList.size())
             rxChannelIndex = 0;
 
-        // set new receive channel
-        _radio->setChannel(rxChannel);
-
-        // wait until the channel is set
-        _radio->getChannel();
+        // set new receive channel (waits until the channel is set)
+        _radio->SetChannel(rxChannel);
 
         // wait for signal
         bool signalDetected = false;
 
         for (int i = 0; i < 10; i++)
         {
-            if (_radio->testRPD() || _radio->available()) // is "_radio->available()" wise???
+            if (_radio->IsCarrierDetected() || _radio->IsPacketAvailable())
             {
                 signalDetected = true;
                 break;
@@ -567,163 +567,264 @@ void HoymilesHmDtu::SendRequestAndScanForResponses(std::vector <buffer_type> & r
         if (!signalDetected)
             continue;
 
-        // read packets on this channel
-        constexpr int maxScanTimePerPacketMs = 10;
-
-        auto startTime2 = steady_clock::now();
-        auto endTime2 = startTime2 + milliseconds(maxScanTimePerPacketMs);
+        // read packets on this channel, stay as long as further packets are expected
+        bool packetReceived = false;
+        auto lastPacketTime = steady_clock::now();
+        auto endTime2 = lastPacketTime + duration_cast<steady_clock::duration>(duration<double, milli>(GetRxDwellTimeAfterPacketMs(rxChannel)));
         while (steady_clock::now() < endTime2)
         {
-            if (!_radio->available())
+            if (!_radio->ReadPacket(packet))
                 continue;
-            
-            // auto rxtm = duration_cast<milliseconds>(steady_clock::now() - startTime1).count();
-            // cout << "      rxtm " << rxtm << " ms";
 
-            // read packet data
-            uint8_t packetLen = _radio->getDynamicPayloadSize();
-            // cout << "~~~ radio available rx channel " << rxChannel << " packet len " << (int)packetLen << endl;
+            _radio->FlushRx();
+
+            numberOfPackets++;
 
-            packet.resize(packetLen);
-            _radio->read(&(packet[0]), packetLen);
+            // learn the gap between the packets on this channel
+            auto now = steady_clock::now();
+            if (packetReceived)
+                UpdateRxChannelTiming(rxChannel, duration<double, milli>(now - lastPacketTime).count());
 
-            _radio->flush_rx();
+            packetReceived = true;
+            lastPacketTime = now;
 
-            // store raw packet data
-            responsePacketList.push_back(packet);
+            AddReceivedPacket(reassembler, packet, rxChannel);
+            if (AreAwaitedFramesReceived(reassembler, awaitedFrameNumber))
+                return numberOfPackets;
+
+            endTime2 = now + duration_cast<steady_clock::duration>(duration<double, milli>(GetRxDwellTimeAfterPacketMs(rxChannel)));
         }
     }
+
+    return numberOfPackets;
 }
 
-bool HoymilesHmDtu::EvaluateInverterInfoResponse(buffer_type & responseData, const std::vector<buffer_type> & responsePacketList,
-    const buffer_type & inverterRadioAddress, int inverterNumberOfChannels)
+int HoymilesHmDtu::ScanForResponsesIrq(FragmentReassembler & reassembler,
+    std::span<const int> rxChannelList, const Deadline & scanDeadline, int awaitedFrameNumber)
 {
-    responseData.clear();
-    int numberOfResponses = inverterNumberOfChannels + 1;
+    uint32_t rxChannelIndex = 0;
+    int numberOfPackets = 0;
+
+    // discard old interrupts
+    _radio->ClearReceiveInterrupts();
+
+    _radio->StartListening();
 
-    // did we get the right number of responses?
-    if ((int)responsePacketList.size() != numberOfResponses)
-        return false;
+    auto endTime = scanDeadline.GetTimePoint();
+    auto now = steady_clock::now();
 
-    for (int idx = 0; idx < numberOfResponses; idx++)
+    while (now < endTime)
     {
-        const auto & response = responsePacketList[idx];
+        int rxChannel = rxChannelList[rxChannelIndex];
+        rxChannelIndex++;
+        if (rxChannelIndex >= rxChannelList.size())
+            rxChannelIndex = 0;
 
-        if (response.size() < 12)
-            return false;
+        // set new receive channel
+        _radio->SetChannel(rxChannel);
 
-        // are the frame numbers valid?
-        int frameNumberResponse = response[9];
-        int frameNumberExpected = idx + 1;
-        if (frameNumberExpected == numberOfResponses) // is it the last frame?
-            frameNumberExpected |= 0x80;
+        // sleep until a packet is received or the dwell time on this channel is over
+        auto dwellEndTime = min(now + duration_cast<steady_clock::duration>(duration<double, milli>(RX_CHANNEL_DWELL_TIME_MS)), endTime);
 
-        if (frameNumberResponse != frameNumberExpected)
-            return false;
+        // timestamp of the previous packet on this channel (interrupt time in ns), 0 if none
+        uint64_t lastPacketTimestampNs = 0;
 
-        // are the receiver addresses valid?
-        if (!equal(inverterRadioAddress.begin(),  inverterRadioAddress.end(), response.begin() + 1))
-            return false;
+        while (now < dwellEndTime)
+        {
+            if (!_radio->WaitForReceiveInterrupt(duration<double>(dwellEndTime - now).count()))
+                break;
 
-        if (!equal(inverterRadioAddress.begin(),  inverterRadioAddress.end(), response.begin() + 5))
-            return false;
+            // acknowledge first, so a packet received while reading the FIFO creates a new interrupt
+            _radio->AcknowledgeReceiveInterrupts(_irqTimestampsNs);
 
-        // is the checksum valid?
-        if (!CheckPacketChecksum(response))
-            return false;
-        
-        // header is 10 bytes and last byte is the checksum
-        responseData.insert(responseData.end(), response.begin() + 10, response.end() - 1);
+            numberOfPackets += ReadReceivedPackets(reassembler, rxChannel);
+
+            // learn the gap between the packets on this channel from the interrupt timestamps
+            for (uint64_t timestampNs : _irqTimestampsNs)
+            {
+                if (lastPacketTimestampNs != 0)
+                    UpdateRxChannelTiming(rxChannel, (double)(timestampNs - lastPacketTimestampNs) / 1e6);
+
+                lastPacketTimestampNs = timestampNs;
+            }
+
+            if (AreAwaitedFramesReceived(reassembler, awaitedFrameNumber))
+                return numberOfPackets;
+
+            now = steady_clock::now();
+            dwellEndTime = min(now + duration_cast<steady_clock::duration>(duration<double, milli>(GetRxDwellTimeAfterPacketMs(rxChannel))), endTime);
+        }
+
+        now = steady_clock::now();
     }
 
-    return true;
+    return numberOfPackets;
 }
 
-bool HoymilesHmDtu::ExtractInverterReadings(Readings & readings, const buffer_type & responseData, int numberOfChannels)
+void HoymilesHmDtu::AddReceivedPacket(FragmentReassembler & reassembler, const RadioPacket & packet, int rxChannel)
 {
-    // check the checksum
-    uint16_t crc1 = GetUInt16(responseData, responseData.size() - 2);
-    uint16_t crc2 = CalculateCrc16(responseData, 0, responseData.size() - 2);
-    if (crc1 != crc2)
-        return false;
-    
-    try
+    // undo replace of special characters
+    auto unescapeResult = TryUnescapeData(_unescapedPacket, packet);
+    if (!unescapeResult)
     {
-        readings.ExtractReadings(numberOfChannels, responseData);
+        _errorCounters.Count(unescapeResult.GetErrorKind());
+        return;
     }
-    catch (const exception &)
+
+    // duplicates are not an error, they are received on several channels
+    auto addResult = reassembler.AddFragment(_unescapedPacket);
+    if (!addResult)
     {
-        return false;
+        _errorCounters.Count(addResult.GetErrorKind());
+        return;
     }
 
-    return true;
+    _channelModel.RecordRxFrame(rxChannel);
+}
+
+double HoymilesHmDtu::GetRxDwellTimeAfterPacketMs(int rxChannel) const
+{
+    const auto & timing = _rxChannelTimings.at(rxChannel);
+
+    // wait for the expected gap plus a safety margin, like a retransmission timeout
+    double dwellTimeMs = timing.PacketGapMeanMs + 4.0 * timing.PacketGapDeviationMs;
+    return clamp(dwellTimeMs, RX_DWELL_TIME_AFTER_PACKET_MIN_MS, RX_DWELL_TIME_AFTER_PACKET_MAX_MS);
 }
 
-void HoymilesHmDtu::UnescapedPacketList(std::vector <buffer_type> & dest, const std::vector <buffer_type> & src)
+void HoymilesHmDtu::UpdateRxChannelTiming(int rxChannel, double packetGapMs)
 {
-    dest.clear();
-    dest.reserve(src.size());
+    // gaps longer than the maximum dwell time are not caused by the packet sequence
+    if ((packetGapMs < 0.0) || (packetGapMs > RX_DWELL_TIME_AFTER_PACKET_MAX_MS))
+        return;
+
+    auto & timing = _rxChannelTimings.at(rxChannel);
 
-    buffer_type unescapedPacket;
+    timing.PacketGapDeviationMs += RX_PACKET_GAP_WEIGHT * (abs(packetGapMs - timing.PacketGapMeanMs) - timing.PacketGapDeviationMs);
+    timing.PacketGapMeanMs += RX_PACKET_GAP_WEIGHT * (packetGapMs - timing.PacketGapMeanMs);
+}
 
-    for (const auto & packet : src)
+int HoymilesHmDtu::ReadReceivedPackets(FragmentReassembler & reassembler, int rxChannel)
+{
+    int numberOfPackets = 0;
+    RadioPacket packet;
+
+    while (_radio->IsPacketAvailable())
     {
-        UnescapeData(unescapedPacket, packet);
-        dest.push_back(unescapedPacket);
+        // a corrupted packet flushes the FIFO
+        if (!_radio->ReadPacket(packet))
+            break;
+
+        numberOfPackets++;
+
+        AddReceivedPacket(reassembler, packet, rxChannel);
+    }
+
+    return numberOfPackets;
+}
+
+size_t HoymilesHmDtu::GetInfoResponseDataSize(int numberOfChannels)
+{
+    // the readings (see Readings::ExtractReadings) and the CRC16 checksum
+    switch (numberOfChannels)
+    {
+        case 1:
+            return 30 + 2;
+
+        case 2:
+            return 42 + 2;
+
+        case 4:
+            return 62 + 2;
+
+        default:
+            throw Error(format("GetInfoResponseDataSize: Invalid number of channels {}", numberOfChannels));
     }
 }
 
-bool HoymilesHmDtu::QueryInverterInfo(Readings & readings, int numberOfRetries, double waitBeforeRetry)
+Result<void> HoymilesHmDtu::ExtractInverterReadings(Readings & readings, const buffer_type & responseData, int numberOfChannels)
+{
+    if (responseData.size() < GetInfoResponseDataSize(numberOfChannels))
+        return Failure(EK_INCOMPLETE);
+
+    // check the checksum
+    uint16_t crc1 = GetUInt16(responseData, responseData.size() - 2);
+    uint16_t crc2 = Checksum::CalculateCrc16Modbus(span(responseData).first(responseData.size() - 2));
+    if (crc1 != crc2)
+        return Failure(EK_CHECKSUM_ERROR);
+    
+    readings.ExtractReadings(numberOfChannels, responseData);
+
+    return {};
+}
+
+bool HoymilesHmDtu::QueryInverterInfo(Readings & readings, const Deadline & deadline, int numberOfRetries, double waitBeforeRetry)
 {
     AssertCommunicationIsInitialized();
 
-    _radio->flush_tx();
-    _radio->flush_rx();
+    _radio->FlushTx();
+    _radio->FlushRx();
 
     // set power level to minimum at the end of the function
-    OnScopeExit onScopeExit( [&] { _radio->setPALevel(RF24_PA_MIN); } );
+    OnScopeExit onScopeExit( [&] { _radio->SetPowerLevel(RPL_MIN); } );
 
     // increase power level
-    _radio->setPALevel(RADIO_POWER_LEVEL);
+    _radio->SetPowerLevel(RADIO_POWER_LEVEL);
 
-    vector <uint8_t> txPacket;
-    vector <buffer_type> responsePacketList, unescapedPacketList;
-    buffer_type responseData;
+    // the fragments are kept over the retries, so partial responses are combined
+    _reassembler.Clear();
 
     for (int retryIndex = 0; retryIndex < numberOfRetries; retryIndex++)
     {
-        if (retryIndex > 0)
-            this_thread::sleep_for(milliseconds((int)(waitBeforeRetry * 1000.0)));
+        // no time left for another request
+        if ((retryIndex > 0) && !deadline.SleepFor(waitBeforeRetry))
+            break;
 
-        // create packet to send to the inverter
-        uint32_t tm = static_cast<uint32_t>(duration_cast<seconds>(system_clock::now().time_since_epoch()).count());
+        if (deadline.IsExpired())
+            break;
 
-        CreateRequestInfoPacket(txPacket, _inverterRadioAddress, _dtuRadioAddress, tm);
-        
-        // select a random channel for the request
-        int txChannelIndex = _randomTxChannel(_randomEngine);
-        int txChannel = TX_CHANNELS.at(txChannelIndex);
+        // select the channel for the request from the learned channel statistics
+        int txChannel = _channelModel.SelectTxChannel(_randomEngine);
 
-        auto rxChannelList = RX_CHANNEL_LISTS.find(txChannel);
-        if (rxChannelList == RX_CHANNEL_LISTS.end())
-            throw Error(format("Internal error: no RX channels for tx channel {}", txChannel));
+        // scan the best receive channels first
+        _orderedRxChannelList = GetRxChannelList(txChannel);
+        _channelModel.OrderRxChannels(_orderedRxChannelList);
 
         try
         {
+            // only the time and the checksums of the request packet change
+            uint32_t tm = static_cast<uint32_t>(duration_cast<seconds>(system_clock::now().time_since_epoch()).count());
+
+            SetRequestInfoPacketTime(_requestInfoPacket, tm);
+            EscapeData(_txPacket, _requestInfoPacket);
+
+            int numberOfFragments = _reassembler.GetNumberOfFragments();
+
             // send request and scan for responses
-            SendRequestAndScanForResponses(responsePacketList, txChannel, rxChannelList->second, txPacket);
+            SendRequestAndScanForResponses(_reassembler, txChannel, _orderedRxChannelList, _txPacket, deadline);
 
-            // undo replace of special characters
-            UnescapedPacketList(unescapedPacketList, responsePacketList);
+            // request only the missing fragments instead of repeating the whole request
+            RequestMissingFragments(_reassembler, txChannel, _orderedRxChannelList, deadline);
 
-            // did we get a valid response?
-            bool success = EvaluateInverterInfoResponse(responseData, unescapedPacketList, _inverterRadioAddress, _inverterNumberOfChannels);
-            if (success)
-            {
-                success = ExtractInverterReadings(readings, responseData, _inverterNumberOfChannels);
-                if (success)
-                    return true;
-            }
+            // the request succeeded if its own frames completed the response, fragments of earlier
+            // requests alone do not credit this TX channel
+            int framesReceived = _reassembler.GetNumberOfFragments() - numberOfFragments;
+            bool success = (framesReceived > 0) && _reassembler.IsComplete();
+
+            // a scan cut short by the deadline says nothing about the channel quality
+            if (success || !deadline.IsExpired())
+                RecordChannelStatistics(txChannel, success, framesReceived);
+
+            // did we get a valid response? (if the fragments do not belong together, the reassembler starts again)
+            auto result = _reassembler.Assemble(_responseData);
+
+            if (result)
+                result = ExtractInverterReadings(readings, _responseData, _inverterNumberOfChannels);
+
+            if (result)
+                return true;
+
+            // not successful, count the error and try again
+            _errorCounters.Count(result.GetErrorKind());
         }
         catch (const exception & exc)
         {
@@ -735,27 +836,71 @@ bool HoymilesHmDtu::QueryInverterInfo(Readings & readings, int numberOfRetries,
     return false;
 }
 
+void HoymilesHmDtu::RecordChannelStatistics(int txChannel, bool success, int framesReceived)
+{
+    _channelModel.RecordRequest(txChannel, success, framesReceived);
+
+    _requestsSinceChannelModelSave++;
+    if (_requestsSinceChannelModelSave < CHANNEL_MODEL_SAVE_INTERVAL)
+        return;
+
+    _requestsSinceChannelModelSave = 0;
+
+    try
+    {
+        SaveChannelModel();
+    }
+    catch (const exception & exc)
+    {
+        LOG_ERROR(exc);
+    }
+}
+
+void HoymilesHmDtu::RequestMissingFragments(FragmentReassembler & reassembler, int txChannel, std::span<const int> rxChannelList,
+    const Deadline & deadline)
+{
+    // if nothing was received, the inverter probably did not receive the request
+    if (reassembler.IsEmpty())
+        return;
+
+    for (int round = 0; round < MAX_RETRANSMIT_ROUNDS; round++)
+    {
+        uint32_t missingFrameMask = reassembler.GetMissingFrameMask();
+        if (missingFrameMask == 0)
+            return;
+
+        for (int frameNumber = 1; frameNumber <= FragmentReassembler::MAX_NUMBER_OF_FRAMES; frameNumber++)
+        {
+            if ((missingFrameMask & (1u << frameNumber)) == 0)
+                continue;
+
+            if (deadline.IsExpired())
+                return;
+
+            CreateRequestRetransmitPacket(_txPacket, _inverterRadioAddress, _dtuRadioAddress, frameNumber);
+            SendRequestAndScanForResponses(reassembler, txChannel, rxChannelList, _txPacket, deadline, RETRANSMIT_SCAN_TIME_MS, frameNumber);
+        }
+    }
+}
+
 void HoymilesHmDtu::TestInverterCommunication()
 {
     AssertCommunicationIsInitialized();
 
-    _radio->flush_tx();
-    _radio->flush_rx();
+    _radio->FlushTx();
+    _radio->FlushRx();
 
     // set power level to minimum at the end of the function
-    OnScopeExit onScopeExit( [&] { _radio->setPALevel(RF24_PA_MIN); } );
+    OnScopeExit onScopeExit( [&] { _radio->SetPowerLevel(RPL_MIN); } );
 
     // increase power level
-    _radio->setPALevel(RADIO_POWER_LEVEL);
-
-    vector <uint8_t> txPacket;
-    vector <buffer_type> responsePacketList, unescapedPacketList;
-    buffer_type responseData;
+    _radio->SetPowerLevel(RADIO_POWER_LEVEL);
 
     // create packet to send to the inverter
     uint32_t tm = static_cast<uint32_t>(duration_cast<seconds>(system_clock::now().time_since_epoch()).count());
 
-    CreateRequestInfoPacket(txPacket, _inverterRadioAddress, _dtuRadioAddress, tm);
+    SetRequestInfoPacketTime(_requestInfoPacket, tm);
+    EscapeData(_txPacket, _requestInfoPacket);
     
     try
     {
@@ -766,37 +911,28 @@ void HoymilesHmDtu::TestInverterCommunication()
 
             cout << "***** Using TX channel: " << txChannel << " *****" << endl;
 
-            auto rxChannelList = RX_CHANNEL_LISTS.find(txChannel);
-            if (rxChannelList == RX_CHANNEL_LISTS.end())
-                throw Error(format("Internal error: no RX channels for tx channel {}", txChannel));
+            const auto & rxChannelList = GetRxChannelList(txChannel);
 
             vector <size_t> rxPacketsCounts;
             
             for (int retries = 0; retries < 20; retries++)
             {
-                SendRequestAndScanForResponses(responsePacketList, txChannel, rxChannelList->second, txPacket);
-                rxPacketsCounts.push_back(responsePacketList.size());
+                _reassembler.Clear();
+                int numberOfPackets = SendRequestAndScanForResponses(_reassembler, txChannel, rxChannelList, _txPacket, Deadline::Never());
+                rxPacketsCounts.push_back(numberOfPackets);
 
-                if (responsePacketList.size() > 0)
+                if (numberOfPackets > 0)
                 {
                     cout << "      retry " << retries << "\t";
 
-                    // which packets were received?
-                    try
+                    // which frames were received?
+                    cout << " Frames: ";
+                    for (int frameNumber = 1; frameNumber <= FragmentReassembler::MAX_NUMBER_OF_FRAMES; frameNumber++)
                     {
-                        UnescapedPacketList(unescapedPacketList, responsePacketList);
-
-                        cout << " Frames: ";
-                        for (const auto & packet : unescapedPacketList)
-                        {
-                            cout << (int)(packet[9] & 0x7F) << " ";
-                        }
-                        cout << endl;
-                    }
-                    catch (const exception & exc)
-                    {
-                        cout << "         " << exc.what() << endl;
+                        if (_reassembler.HasFragment(frameNumber))
+                            cout << frameNumber << " ";
                     }
+                    cout << endl;
                 }
             }
 
@@ -819,6 +955,8 @@ void HoymilesHmDtu::TestInverterCommunication()
 
             cout << "      Avg rx packets count: " << avg << "\tRcv #1: " << count1 << "\tRcv #2: " << count2 << "\tRcv #3: " << count3 << endl;
         }
+
+        cout << "Channel statistics: " << _channelModel.ToString() << endl;
     }
     catch (const exception & exc)
     {
@@ -24,10 +24,18 @@ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
 IN THE SOFTWARE.
 */
 
-#include <RF24/RF24.h>
+#include "Result.h"
+#include "ErrorCounters.h"
+#include "Radio.h"
+#include "Deadline.h"
+#include "FragmentReassembler.h"
+#include "ChannelModel.h"
+#include "RadioPacket.h"
+#include "ReadingsRecord.h"
 
 #include <vector>
-#include <map>
+#include <array>
+#include <span>
 #include <cstdint>
 #include <format>
 #include <memory>
@@ -40,7 +48,7 @@ public:
     typedef std::vector <uint8_t> buffer_type;
     
     // the power level to send the request to the receiver
-    rf24_pa_dbm_e RADIO_POWER_LEVEL = RF24_PA_LOW;
+    RadioPowerLevel RADIO_POWER_LEVEL = RPL_LOW;
 
     /// @brief Hoymiles HM DTU error.
     class Error : public std::runtime_error
@@ -168,6 +176,10 @@ public:
         /// @param os The output stream.
         void Print(std::ostream & os) const;
 
+        /// @brief Returns the readings as readings record.
+        /// @param readings The readings record: the channel readings of the available channels and the AC readings.
+        void GetReadings(ReadingsRecord & readings) const;
+
         /// @brief Extracts the readings from the raw data.
         /// @param numberOfChannels The number of channels: 1, 2 or 4.
         /// @param data The raw data.
@@ -201,9 +213,10 @@ public:
 
     /// @brief Creates a new Hoymiles HM communication object.
     /// @param inverterSerialNumber The 12 digits inverter serial number. (As printed on the sticker on the inverter case.)
-    /// @param pinCSn The CSN pin as SPI device number (0 or 1), usually 0. Defaults to 0.
-    /// @param pinCE The GPIO pin connected to the NRF24L01 CE signal. Defaults to 24.
-    HoymilesHmDtu(const std::string & inverterSerialNumber, int pinCSn = 0, int pinCE = 24);
+    /// @param radio The radio used for the communication: the nRF24L01 module (Rf24Radio) or a simulation (SimulatedInverterRadio).
+    /// @param channelModelFilepath The file where the learned channel statistics are stored or an empty string if they shall not be stored.
+    HoymilesHmDtu(const std::string & inverterSerialNumber, std::shared_ptr<Radio> radio,
+        const std::string & channelModelFilepath = "");
     virtual ~HoymilesHmDtu();
 
     HoymilesHmDtu(const HoymilesHmDtu &) = delete;
@@ -221,35 +234,121 @@ public:
 
     /// @brief Requests info data from the inverter and returns the inverter response.
     /// @param readings The readings from the inverter.
+    /// @param deadline All scans and retries are stopped when the deadline is reached.
     /// @param numberOfRetries Number of requests before giving up.
     /// @param waitBeforeRetry Time (in s) to wait before a new request is sent to the inverter if the previous request was not successful.
     /// @return Success (true or false)
-    bool QueryInverterInfo(Readings & readings, int numberOfRetries = 20, double waitBeforeRetry = 1.0);
+    bool QueryInverterInfo(Readings & readings, const Deadline & deadline, int numberOfRetries = 20, double waitBeforeRetry = 1.0);
 
     /// @brief Tests the inverter communication.
     void TestInverterCommunication();
 
-private:
-    // the nRF24L01 receive pipeline
-    constexpr static int RX_PIPE_NUM = 1;
+    /// @brief Returns the counters of the errors that occurred while querying the inverter.
+    /// @return The error counters.
+    const ErrorCounters & GetErrorCounters() const { return _errorCounters; }
 
-    // the SPI communication frequency (in Hz)
-    constexpr static int SPI_FREQUENCY_HZ = 1000000;
+    /// @brief Returns the learned channel statistics.
+    /// @return The channel model.
+    const ChannelModel & GetChannelModel() const { return _channelModel; }
 
-    // maximum size of packets that can be sent with the nRF24L01 module
-    constexpr static int MAX_PACKET_SIZE = 32;
+    /// @brief Saves the learned channel statistics to the channel model file (if configured).
+    void SaveChannelModel() const;
 
     // list of channels where the inverter is listening for requests
-    static const std::vector <int> TX_CHANNELS;
+    constexpr static std::array <int, 5> TX_CHANNELS = { 3, 23, 40, 61, 75 };
+
+    typedef std::array <int, 3> rx_channel_list_type;
 
     // list of channels where the inverter sends the responses depending on the channel, where the request was received
-    static const std::map <int, std::vector <int>> RX_CHANNEL_LISTS;
+    // (in the order of TX_CHANNELS)
+    constexpr static std::array <rx_channel_list_type, 5> RX_CHANNEL_LISTS = {{
+        { 23, 40, 61 },
+        { 40, 61, 75 },
+        { 61, 75,  3 },
+        { 75,  3, 23 },
+        {  3, 23, 40 },
+    }};
+
+    /// @brief Returns the channels where the inverter sends the responses.
+    /// @param txChannel The channel where the request is sent.
+    /// @return The RX channel list.
+    static const rx_channel_list_type & GetRxChannelList(int txChannel);
+
+    /// @brief Replaces bytes with special meaning by escape sequences.
+    /// @param dest The destination packet with the escaped data.
+    /// @param src The source data.
+    static void EscapeData(RadioPacket & dest, std::span<const uint8_t> src);
+
+    /// @brief Remove escape sequences for bytes with special meanings.
+    /// @param dest The destination packet with the unescaped data.
+    /// @param src The source data.
+    static void UnescapeData(RadioPacket & dest, std::span<const uint8_t> src);
+
+    /// @brief Remove escape sequences for bytes with special meanings. Does not throw exceptions.
+    /// @param dest The destination packet with the unescaped data.
+    /// @param src The source data.
+    /// @return Success or EK_INVALID_ESCAPE_SEQUENCE, EK_BUFFER_OVERFLOW.
+    static Result<void> TryUnescapeData(RadioPacket & dest, std::span<const uint8_t> src);
+
+    /// @brief Returns the size of the info response data (including the checksum).
+    /// @param numberOfChannels Number of inverter channels: 1, 2 or 4.
+    /// @return The size of the response data in bytes.
+    static size_t GetInfoResponseDataSize(int numberOfChannels);
+
+private:
+    // the info request packet (unescaped): header (10 bytes), payload (14 bytes), payload checksum (2 bytes), packet checksum
+    constexpr static size_t REQUEST_INFO_PACKET_SIZE = 27;
+    constexpr static size_t REQUEST_INFO_PAYLOAD_POS = 10;
+    constexpr static size_t REQUEST_INFO_TIME_POS = 12;
+    constexpr static size_t REQUEST_INFO_PAYLOAD_CHECKSUM_POS = 24;
+
+    // all inverter responses should be received within this time (in ms)
+    constexpr static int MAX_SCAN_TIME_MS = 500;
+
+    // time to wait for a single fragment after a retransmit request (in ms)
+    constexpr static int RETRANSMIT_SCAN_TIME_MS = 60;
+
+    // how often missing fragments are requested before the whole info request is repeated
+    constexpr static int MAX_RETRANSMIT_ROUNDS = 2;
+
+    // the channel model is saved to file after this number of requests
+    constexpr static int CHANNEL_MODEL_SAVE_INTERVAL = 100;
+
+    // IRQ mode: time to wait on a receive channel for a packet before switching to the next channel (in ms)
+    constexpr static double RX_CHANNEL_DWELL_TIME_MS = 5.0;
+
+    // time to stay on a receive channel after a packet was received, further packets usually follow on the same channel (in ms)
+    // the dwell time is learned per receive channel from the gaps between the packets, these are the limits and the initial values
+    constexpr static double RX_DWELL_TIME_AFTER_PACKET_MIN_MS = 2.0;
+    constexpr static double RX_DWELL_TIME_AFTER_PACKET_MAX_MS = 20.0;
+    constexpr static double RX_PACKET_GAP_INITIAL_MEAN_MS = 4.0;
+    constexpr static double RX_PACKET_GAP_INITIAL_DEVIATION_MS = 1.5;
+
+    // weight of a new packet gap in the moving averages
+    constexpr static double RX_PACKET_GAP_WEIGHT = 0.125;
+
+    // number of nRF24L01 radio channels (0 ... 125)
+    constexpr static int NUMBER_OF_RADIO_CHANNELS = 126;
+
+    /// @brief The observed timing of the response packets on a receive channel.
+    struct RxChannelTiming
+    {
+        // moving average of the gap between two packets (in ms)
+        double PacketGapMeanMs = RX_PACKET_GAP_INITIAL_MEAN_MS;
+
+        // moving average of the deviation of the gap between two packets (in ms)
+        double PacketGapDeviationMs = RX_PACKET_GAP_INITIAL_DEVIATION_MS;
+    };
 
-    std::shared_ptr<RF24> _radio;
+    std::shared_ptr<Radio> _radio;
 
     std::string _inverterSerialNumber;
-    int _pinCSn;
-    int _pinCE;
+
+    // timestamps of the receive interrupts (only if the radio has receive interrupts)
+    std::vector <uint64_t> _irqTimestampsNs;
+
+    // packet timing per receive channel
+    std::array <RxChannelTiming, NUMBER_OF_RADIO_CHANNELS> _rxChannelTimings;
 
     std::vector<uint8_t> _dtuRadioAddress;
     std::vector<uint8_t> _inverterRadioAddress;
@@ -259,9 +358,23 @@ private:
 
     int _inverterNumberOfChannels;
 
+    ErrorCounters _errorCounters;
+
+    // the packets and buffers of the queries are allocated once
+    RadioPacket _requestInfoPacket;     // unescaped, only the time and the checksums are updated
+    RadioPacket _txPacket;              // escaped packet to be sent
+    RadioPacket _unescapedPacket;       // for unescaping the received packets while scanning
+    FragmentReassembler _reassembler;
+    buffer_type _responseData;
+
+    // learned channel statistics for the channel selection
+    ChannelModel _channelModel;
+    std::string _channelModelFilepath;
+    int _requestsSinceChannelModelSave = 0;
+    rx_channel_list_type _orderedRxChannelList;
+
     // needed for random numbers
     std::minstd_rand _randomEngine;
-    std::uniform_int_distribution<int> _randomTxChannel;
 
     /// @brief Generates a 4 byte DTU radio ID (data transfer unit, this device) from the system UUID. The radio ID is used to send and receive packets.
     /// @return The 4 bytes DTU radio ID.
@@ -280,86 +393,122 @@ private:
     /// @brief Throws an error if the communication is not intialized.
     void AssertCommunicationIsInitialized() const;
 
-    /// @brief Replaces bytes with special meaning by escape sequences.
-    /// @param dest The destination buffer with the escaped data.
-    /// @param src The source buffer.
-    static void EscapeData(buffer_type & dest, const buffer_type & src);
-
-    /// @brief Remove escape sequences for bytes with special meanings.
-    /// @param dest The destination buffer with the unescaped data.
-    /// @param src The source buffer.
-    static void UnescapeData(buffer_type & dest, const buffer_type & src);
-    
-    /// @brief Calculates CRC8 checksum for communication with hoymiles inverters. poly = 0x101; reversed = False; init-value = 0x00; XOR-out = 0x00; Check = 0x31
-    /// @param data The byte array on which the ckecksum is to be calculated.
-    /// @param startPos The start position. (index starts at 0)
-    /// @param endPos The end position. (The position after the last byte.)
-    /// @return The crc checksum.
-    static uint8_t CalculateCrc8(const buffer_type & data, size_t startPos, size_t endPos);
-
-    /// @brief Calculates CRC16 checksum for communication with hoymiles inverters. poly = 0x8005; reversed = True; init-value = 0xFFFF; XOR-out = 0x0000; Check = 0x4B37
-    /// @param data The byte array on which the ckecksum is to be calculated.
-    /// @param startPos The start position. (index starts at 0)
-    /// @param endPos The end position. (The position after the last byte.)
-    /// @return The crc checksum.
-    static uint16_t CalculateCrc16(const buffer_type & data, size_t startPos, size_t endPos);
-
-    /// @brief Checks the checksum of a packet.
-    /// @param packet The packet to be checked.
-    /// @return True if the checksum is valid.
-    static bool CheckPacketChecksum(const buffer_type & packet);
-
     /// @brief Creates the packet header.
-    /// @param packetHeader The created packet header. (This function does not clear the buffer.)
+    /// @param packetHeader The created packet header. (This function does not clear the packet.)
     /// @param command The packet command.
     /// @param receiverAddr The address of the receiver generated from the receiver (inverter) serial number. (4 bytes)
     /// @param senderAddr The address of the sender generated from the sender (DTU) serial number. (4 bytes)
     /// @param frame The frame number for message data.
-    static void CreatePacketHeader(buffer_type & packetHeader, uint8_t command,
+    static void CreatePacketHeader(RadioPacket & packetHeader, uint8_t command,
         const buffer_type & receiverAddr, const buffer_type & senderAddr, uint8_t frame);
     
-    /// @brief Creates payload data for info request filled with the time.
-    /// @param payload The payload data. (This function does not clear the buffer.)
-    /// @param currentTime The current time in seconds since the epoch.
-    static void CreateRequestInfoPayload(buffer_type & payload, uint32_t currentTime);
+    /// @brief Creates payload data for info request. The time is set by SetRequestInfoPacketTime().
+    /// @param payload The payload data. (This function does not clear the packet.)
+    static void CreateRequestInfoPayload(RadioPacket & payload);
 
-    /// @brief Creates the packet that can be sent to the inverter to request information.
-    /// @param packet The packet to be sent to the inverter. (This function clears the buffer first.)
+    /// @brief Creates the (unescaped) packet that can be sent to the inverter to request information.
+    /// The time must be set with SetRequestInfoPacketTime() and the packet escaped before it is sent.
+    /// @param packet The packet to be sent to the inverter. (This function clears the packet first.)
     /// @param receiverAddr The address of the receiver generated from the receiver (inverter) serial number. (4 bytes)
     /// @param senderAddr The address of the sender generated from the sender (DTU) serial number. (4 bytes)
+    static void CreateRequestInfoPacket(RadioPacket & packet, const buffer_type & receiverAddr, const buffer_type & senderAddr);
+
+    /// @brief Sets the time in the (unescaped) info request packet and updates the checksums.
+    /// @param packet The packet created by CreateRequestInfoPacket().
     /// @param currentTime The current time in seconds since the start of the epoch.
-    static void CreateRequestInfoPacket(buffer_type & packet,
-        const buffer_type & receiverAddr, const buffer_type & senderAddr, uint32_t currentTime);
+    static void SetRequestInfoPacketTime(RadioPacket & packet, uint32_t currentTime);
     
+    /// @brief Creates the packet that requests the retransmission of a single response fragment.
+    /// @param packet The packet to be sent to the inverter. (This function clears the buffer first.)
+    /// @param receiverAddr The address of the receiver generated from the receiver (inverter) serial number. (4 bytes)
+    /// @param senderAddr The address of the sender generated from the sender (DTU) serial number. (4 bytes)
+    /// @param frameNumber The number of the missing frame.
+    static void CreateRequestRetransmitPacket(RadioPacket & packet,
+        const buffer_type & receiverAddr, const buffer_type & senderAddr, int frameNumber);
+
     /// @brief Send a request to the inverter and scan receive channels for the response.
-    /// @param responsePacketList List of reponse packets.
+    /// @param reassembler The valid response packets are added to the reassembler.
     /// @param txChannel The channel where the request shall be sent.
     /// @param rxChannelList The channel list to scan for responses.
-    /// @param txPacket The request packet that shall be sent.
-    /// @param scanTimePerRxChannelMs Duration to scan per receive channel in milliseconds.
-    void SendRequestAndScanForResponses(std::vector <buffer_type> & responsePacketList,
-        int txChannel, const std::vector <int> & rxChannelList, const buffer_type & txPacket);
-    
-    /// @brief Checks if the responses are valid and returns the assembled data.
-    /// @param responseData The assembled response data.
-    /// @param responsePacketList List of received responses packets.
-    /// @param inverterRadioAddress The inverter radio address (4 bytes).
-    /// @param inverterNumberOfChannels The number of inverter channels.
-    /// @return True if all responses are valid.
-    static bool EvaluateInverterInfoResponse(buffer_type & responseData,
-        const std::vector <buffer_type> & responsePacketList,
-        const buffer_type & inverterRadioAddress, int inverterNumberOfChannels);
+    /// @param txPacket The (escaped) request packet that shall be sent.
+    /// @param deadline The scan ends at the latest when the deadline is reached.
+    /// @param scanTimeMs The maximum scan time in ms.
+    /// @param awaitedFrameNumber The scan ends as soon as this frame is received or if 0 as soon as the reassembler is complete.
+    /// @return The number of received packets.
+    int SendRequestAndScanForResponses(FragmentReassembler & reassembler,
+        int txChannel, std::span<const int> rxChannelList, const RadioPacket & txPacket, const Deadline & deadline,
+        int scanTimeMs = MAX_SCAN_TIME_MS, int awaitedFrameNumber = 0);
+
+    /// @brief Scans the receive channels for responses by polling the radio. Returns as soon as the awaited frames are received.
+    /// @param reassembler The reassembler where the valid response packets are added.
+    /// @param rxChannelList The channel list to scan for responses.
+    /// @param scanDeadline The end of the scan.
+    /// @param awaitedFrameNumber The awaited frame number or 0 if all frames are awaited.
+    /// @return The number of received packets.
+    int ScanForResponsesPolling(FragmentReassembler & reassembler,
+        std::span<const int> rxChannelList, const Deadline & scanDeadline, int awaitedFrameNumber);
+
+    /// @brief Scans the receive channels for responses, sleeps on the IRQ line while waiting for packets.
+    /// Returns as soon as the awaited frames are received.
+    /// @param reassembler The reassembler where the valid response packets are added.
+    /// @param rxChannelList The channel list to scan for responses.
+    /// @param scanDeadline The end of the scan.
+    /// @param awaitedFrameNumber The awaited frame number or 0 if all frames are awaited.
+    /// @return The number of received packets.
+    int ScanForResponsesIrq(FragmentReassembler & reassembler,
+        std::span<const int> rxChannelList, const Deadline & scanDeadline, int awaitedFrameNumber);
+
+    /// @brief Returns true if the awaited frames were received.
+    /// @param reassembler The reassembler.
+    /// @param awaitedFrameNumber The awaited frame number or 0 if all frames are awaited.
+    /// @return True if the scan can be finished.
+    static bool AreAwaitedFramesReceived(const FragmentReassembler & reassembler, int awaitedFrameNumber)
+    {
+        return (awaitedFrameNumber > 0) ? reassembler.HasFragment(awaitedFrameNumber) : reassembler.IsComplete();
+    }
+
+    /// @brief Records the result of a request in the channel model and saves the model from time to time.
+    /// @param txChannel The channel where the request was sent.
+    /// @param success True if the frames received for this request completed the response.
+    /// @param framesReceived Number of new frames received.
+    void RecordChannelStatistics(int txChannel, bool success, int framesReceived);
+
+    /// @brief Requests the missing fragments one by one from the inverter.
+    /// @param reassembler The reassembler with the already received fragments.
+    /// @param txChannel The channel where the requests shall be sent.
+    /// @param rxChannelList The channel list to scan for responses.
+    /// @param deadline No more fragments are requested when the deadline is reached.
+    void RequestMissingFragments(FragmentReassembler & reassembler, int txChannel, std::span<const int> rxChannelList,
+        const Deadline & deadline);
+
+    /// @brief Adds a received packet to the reassembler.
+    /// Packets with invalid address, escape sequence or checksum are counted as errors and ignored.
+    /// @param reassembler The reassembler.
+    /// @param packet The received packet (escaped).
+    /// @param rxChannel The channel where the packet was received.
+    void AddReceivedPacket(FragmentReassembler & reassembler, const RadioPacket & packet, int rxChannel);
+
+    /// @brief Returns the time to stay on a receive channel after a packet was received.
+    /// @param rxChannel The receive channel.
+    /// @return The dwell time in ms.
+    double GetRxDwellTimeAfterPacketMs(int rxChannel) const;
+
+    /// @brief Updates the packet timing of a receive channel with an observed gap between two packets.
+    /// @param rxChannel The receive channel.
+    /// @param packetGapMs The gap between the two packets in ms.
+    void UpdateRxChannelTiming(int rxChannel, double packetGapMs);
+
+    /// @brief Reads all packets from the receive FIFO and adds them to the reassembler.
+    /// @param reassembler The reassembler.
+    /// @param rxChannel The channel where the packets were received.
+    /// @return The number of received packets.
+    int ReadReceivedPackets(FragmentReassembler & reassembler, int rxChannel);
 
     /// @brief Extracts the inverter infos from the reponse data.
     /// @param readings The inverter readings.
     /// @param responseData The response data.
     /// @param numberOfChannels Number of inverter channels.
-    /// @return True if successfull
-    static bool ExtractInverterReadings(Readings & readings, const buffer_type & responseData, int numberOfChannels);
-
-    /// @brief Unescapes a list of packets.
-    /// @param dest The destination list with unescaped packets.
-    /// @param src The source list with escaped packets.
-    static void UnescapedPacketList(std::vector <buffer_type> & dest, const std::vector <buffer_type> & src);
+    /// @return Success or EK_INCOMPLETE, EK_CHECKSUM_ERROR.
+    static Result<void> ExtractInverterReadings(Readings & readings, const buffer_type & responseData, int numberOfChannels);
 };
 
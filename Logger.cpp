@@ -111,6 +111,8 @@ void Logger::LogError(const std::string & fileName, int lineNumber, const std::e
 
 void Logger::Log(const std::string & messageType, const std::string & fileName, int lineNumber, const std::string & message)
 {
+    lock_guard<mutex> lock(_mutex);
+
     ostream & os = GetLogStream();
 
     LogCurrentTime(os);
@@ -27,6 +27,7 @@ IN THE SOFTWARE.
 #include <fstream>
 #include <memory>
 #include <stdexcept>
+#include <mutex>
 
 /// @brief A class for logging.
 class Logger
@@ -93,6 +94,9 @@ private:
 
     ostream_ptr_type _logFile;
     std::ostream *_logStream;
+
+    // the workers log from several threads
+    std::mutex _mutex;
     
     Logger();
 
@@ -0,0 +1,112 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "ObisRegistry.h"
+
+#include <format>
+#include <sstream>
+#include <cmath>
+
+using namespace std;
+
+static_assert(ObisRegistry::FindBuiltin(PackObisCode(0x01, 0x00, 0x10, 0x07, 0x00, 0xFF)) == ObisRegistry::BR_POWER);
+static_assert(ObisRegistry::FindBuiltin(PackObisCode(0x01, 0x00, 0x20, 0x07, 0x00, 0xFF)) == -1);
+
+ObisRegistry::ObisRegistry()
+{
+}
+
+void ObisRegistry::Add(const AdditionalCode & additionalCode)
+{
+    uint64_t code = ParseObisCode(additionalCode.Code);
+
+    if (Find(code) != nullptr)
+        throw Error(format("OBIS code {} is already registered.", additionalCode.Code));
+
+    if (_additionalEntries.size() >= MAX_ADDITIONAL_READINGS)
+        throw Error(format("OBIS code {}: more than {} additional OBIS codes.", additionalCode.Code, MAX_ADDITIONAL_READINGS));
+
+    if (additionalCode.Name.empty())
+        throw Error(format("OBIS code {} has no name.", additionalCode.Code));
+
+    for (const auto & entry : BUILTIN_ENTRIES)
+    {
+        if (entry.Name == additionalCode.Name)
+            throw Error(format("OBIS code {}: name \"{}\" is already used.", additionalCode.Code, additionalCode.Name));
+    }
+
+    for (const auto & entry : _additionalEntries)
+    {
+        if (entry.Name == additionalCode.Name)
+            throw Error(format("OBIS code {}: name \"{}\" is already used.", additionalCode.Code, additionalCode.Name));
+    }
+
+    const string & name = _strings.emplace_back(additionalCode.Name);
+    const string & unit = _strings.emplace_back(additionalCode.Unit);
+
+    int readingIndex = NUMBER_OF_BUILTIN_READINGS + (int)_additionalEntries.size();
+
+    // divide by 10 instead of multiplying with 0.1, the result is correctly rounded like the built-in readings
+    double divisor = 1.0;
+    double scaler = additionalCode.Scaler;
+
+    if ((scaler > 0.0) && (scaler < 1.0) && (1.0 / round(1.0 / scaler) == scaler))
+    {
+        divisor = round(1.0 / scaler);
+        scaler = 1.0;
+    }
+
+    _additionalIndices[code] = _additionalEntries.size();
+    _additionalEntries.push_back({ code, readingIndex, divisor, scaler, additionalCode.IsSigned, name, unit });
+}
+
+uint64_t ObisRegistry::PackObjName(std::span<const uint8_t> objName)
+{
+    if (objName.size() != 6)
+        return INVALID_CODE;
+
+    return ::PackObisCode(objName[0], objName[1], objName[2], objName[3], objName[4], objName[5]);
+}
+
+uint64_t ObisRegistry::ParseObisCode(const std::string & code)
+{
+    istringstream is(code);
+    uint64_t packedCode = 0;
+    int numberOfBytes = 0;
+    unsigned int byte;
+
+    while (is >> hex >> byte)
+    {
+        if ((byte > 0xFF) || (numberOfBytes >= 6))
+            throw Error(format("Invalid OBIS code \"{}\", expected 6 hex bytes e.g. \"01 00 20 07 00 FF\".", code));
+
+        packedCode = (packedCode << 8) | byte;
+        numberOfBytes++;
+    }
+
+    if (!is.eof() || (numberOfBytes != 6))
+        throw Error(format("Invalid OBIS code \"{}\", expected 6 hex bytes e.g. \"01 00 20 07 00 FF\".", code));
+
+    return packedCode;
+}
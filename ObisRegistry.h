@@ -0,0 +1,205 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <array>
+#include <unordered_map>
+#include <stdexcept>
+#include <format>
+
+/// @brief Packs a 6 byte OBIS code (e.g. 01 00 01 08 00 FF) into an integer.
+/// @return The packed OBIS code.
+constexpr uint64_t PackObisCode(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint8_t e, uint8_t f)
+{
+    return ((uint64_t)a << 40) | ((uint64_t)b << 32) | ((uint64_t)c << 24) | ((uint64_t)d << 16) | ((uint64_t)e << 8) | (uint64_t)f;
+}
+
+/// @brief Registry of the OBIS codes that are extracted from the electricity meter data.
+/// The built-in codes are resolved at compile time, additional codes can be added from the configuration.
+class ObisRegistry
+{
+public:
+
+    /// @brief An OBIS code is not a 6 byte code.
+    constexpr static uint64_t INVALID_CODE = UINT64_MAX;
+
+    /// @brief Description of one OBIS code.
+    struct Entry
+    {
+        /// @brief The packed OBIS code.
+        uint64_t Code;
+
+        /// @brief The index of the reading (built-in readings: BuiltinReading, additional readings: NUMBER_OF_BUILTIN_READINGS + n).
+        int ReadingIndex;
+
+        /// @brief The raw value is divided by this divisor. (Dividing by 1E8 is correctly rounded, multiplying with 1E-8 is not.)
+        double Divisor;
+
+        /// @brief The divided value is multiplied with this factor.
+        double Scaler;
+
+        /// @brief True if the raw value is a SML integer, false if it is a SML unsigned.
+        bool IsSigned;
+
+        /// @brief The name of the reading (= database column).
+        std::string_view Name;
+
+        /// @brief The unit of the reading.
+        std::string_view Unit;
+    };
+
+    /// @brief The built-in readings.
+    enum BuiltinReading
+    {
+        BR_PLUS_A = 0,
+        BR_PLUS_A_T1,
+        BR_PLUS_A_T2,
+        BR_MINUS_A,
+        BR_POWER,
+        BR_POWER_L1,
+        BR_POWER_L2,
+        BR_POWER_L3,
+        NUMBER_OF_BUILTIN_READINGS
+    };
+
+    /// @brief The maximum number of additional OBIS codes (the readings records have a fixed size).
+    constexpr static int MAX_ADDITIONAL_READINGS = 8;
+
+    /// @brief The built-in OBIS codes of the eBZ DD3 electricity meter, indexed by BuiltinReading.
+    /// +A: Active energy, grid supplies to customer.
+    /// -A: Active energy, customer supplies to grid
+    constexpr static std::array<Entry, NUMBER_OF_BUILTIN_READINGS> BUILTIN_ENTRIES
+    {{
+        { PackObisCode(0x01, 0x00, 0x01, 0x08, 0x00, 0xFF), BR_PLUS_A,    1E8, 1.0, false, "+A",    "kWh" },
+        { PackObisCode(0x01, 0x00, 0x01, 0x08, 0x01, 0xFF), BR_PLUS_A_T1, 1E8, 1.0, false, "+A T1", "kWh" },
+        { PackObisCode(0x01, 0x00, 0x01, 0x08, 0x02, 0xFF), BR_PLUS_A_T2, 1E8, 1.0, false, "+A T2", "kWh" },
+        { PackObisCode(0x01, 0x00, 0x02, 0x08, 0x00, 0xFF), BR_MINUS_A,   1E8, 1.0, false, "-A",    "kWh" },
+        { PackObisCode(0x01, 0x00, 0x10, 0x07, 0x00, 0xFF), BR_POWER,     1E2, 1.0, true,  "P",     "W" },
+        { PackObisCode(0x01, 0x00, 0x24, 0x07, 0x00, 0xFF), BR_POWER_L1,  1E2, 1.0, true,  "P L1",  "W" },
+        { PackObisCode(0x01, 0x00, 0x38, 0x07, 0x00, 0xFF), BR_POWER_L2,  1E2, 1.0, true,  "P L2",  "W" },
+        { PackObisCode(0x01, 0x00, 0x4C, 0x07, 0x00, 0xFF), BR_POWER_L3,  1E2, 1.0, true,  "P L3",  "W" },
+    }};
+
+    /// @brief Configuration of an additional OBIS code.
+    struct AdditionalCode
+    {
+        /// @brief The OBIS code as hex bytes, e.g. "01 00 20 07 00 FF".
+        std::string Code;
+
+        /// @brief The name of the reading (= database column).
+        std::string Name;
+
+        /// @brief The raw value is multiplied with this factor. A factor which is the reciprocal of an integer (e.g. 0.1) is applied as division.
+        double Scaler = 1.0;
+
+        /// @brief True if the raw value is a SML integer, false if it is a SML unsigned.
+        bool IsSigned = false;
+
+        /// @brief The unit of the reading.
+        std::string Unit;
+    };
+
+    /// @brief ObisRegistry error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("ObisRegistry error: {}", errorMessage)) { }
+    };
+
+    /// @brief Constructor. The registry contains the built-in codes.
+    ObisRegistry();
+
+    ObisRegistry(const ObisRegistry &) = delete;
+    ObisRegistry & operator=(const ObisRegistry &) = delete;
+
+    /// @brief Adds an additional OBIS code.
+    /// @param additionalCode The OBIS code configuration.
+    void Add(const AdditionalCode & additionalCode);
+
+    /// @brief Looks up an OBIS code.
+    /// @param code The packed OBIS code.
+    /// @return The registry entry or nullptr if the code is unknown.
+    const Entry * Find(uint64_t code) const
+    {
+        int index = FindBuiltin(code);
+        if (index >= 0)
+            return &BUILTIN_ENTRIES[index];
+
+        if (_additionalIndices.empty())
+            return nullptr;
+
+        auto it = _additionalIndices.find(code);
+        if (it == _additionalIndices.end())
+            return nullptr;
+
+        return &_additionalEntries[it->second];
+    }
+
+    /// @brief Returns the additional OBIS codes.
+    /// @return The additional OBIS codes in the order they were added.
+    const std::vector <Entry> & GetAdditionalEntries() const { return _additionalEntries; }
+
+    /// @brief Packs the object name of a SML data set.
+    /// @param objName The object name (6 bytes).
+    /// @return The packed OBIS code or INVALID_CODE if the object name is not 6 bytes long.
+    static uint64_t PackObjName(std::span<const uint8_t> objName);
+
+    /// @brief Parses an OBIS code given as 6 hex bytes, e.g. "01 00 20 07 00 FF".
+    /// @param code The OBIS code string.
+    /// @return The packed OBIS code.
+    static uint64_t ParseObisCode(const std::string & code);
+
+    /// @brief Looks up a built-in OBIS code.
+    /// @param code The packed OBIS code.
+    /// @return The BuiltinReading or -1 if the code is not a built-in code.
+    constexpr static int FindBuiltin(uint64_t code)
+    {
+        switch (code)
+        {
+        case BUILTIN_ENTRIES[BR_PLUS_A].Code:       return BR_PLUS_A;
+        case BUILTIN_ENTRIES[BR_PLUS_A_T1].Code:    return BR_PLUS_A_T1;
+        case BUILTIN_ENTRIES[BR_PLUS_A_T2].Code:    return BR_PLUS_A_T2;
+        case BUILTIN_ENTRIES[BR_MINUS_A].Code:      return BR_MINUS_A;
+        case BUILTIN_ENTRIES[BR_POWER].Code:        return BR_POWER;
+        case BUILTIN_ENTRIES[BR_POWER_L1].Code:     return BR_POWER_L1;
+        case BUILTIN_ENTRIES[BR_POWER_L2].Code:     return BR_POWER_L2;
+        case BUILTIN_ENTRIES[BR_POWER_L3].Code:     return BR_POWER_L3;
+        default:                                    return -1;
+        }
+    }
+
+private:
+    std::vector <Entry> _additionalEntries;
+    std::unordered_map <uint64_t, size_t> _additionalIndices;
+
+    // storage for the names and units of the additional entries (list: the string_views stay valid)
+    std::list <std::string> _strings;
+};
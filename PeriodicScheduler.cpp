@@ -0,0 +1,211 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "PeriodicScheduler.h"
+
+#include <sys/timerfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace std::chrono;
+
+static int64_t GetRealtimeNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static timespec NsToTimespec(int64_t ns)
+{
+    return timespec { (time_t)(ns / 1000000000), (long)(ns % 1000000000) };
+}
+
+std::string PeriodicScheduler::Statistics::ToString() const
+{
+    return format("ticks {}, overruns {}, skipped {}, clock changes {}, jitter mean {:.2f} ms, deviation {:.2f} ms, max {:.2f} ms",
+        Ticks, Overruns, SkippedTicks, ClockChanges, JitterMeanMs, JitterDeviationMs, JitterMaxMs);
+}
+
+PeriodicScheduler::PeriodicScheduler(double periodSeconds, OverrunPolicy overrunPolicy)
+: _timerFd(-1)
+, _overrunPolicy(overrunPolicy)
+, _periodNs(llround(periodSeconds * 1000.0) * 1000000)
+{
+    if (_periodNs <= 0)
+        throw Error(format("invalid period {} s", periodSeconds));
+
+    _timerFd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (_timerFd < 0)
+        throw Error(format("can not create timer: error {} {}", errno, strerror(errno)));
+
+    try
+    {
+        StartTimer();
+    }
+    catch (...)
+    {
+        close(_timerFd);
+        throw;
+    }
+}
+
+PeriodicScheduler::~PeriodicScheduler()
+{
+    if (_timerFd >= 0)
+        close(_timerFd);
+}
+
+bool PeriodicScheduler::WaitForTick(double timeoutSeconds, const CancellationToken * cancellationToken)
+{
+    if (cancellationToken && cancellationToken->IsCancel())
+        return false;
+
+    // catch up the ticks that expired during an overrun
+    if (_tickIndex < _expiredTickIndex)
+    {
+        _tickIndex++;
+        _statistics.Ticks++;
+        return true;
+    }
+
+    pollfd pollFds[2] = {
+        { _timerFd, POLLIN, 0 },
+        { cancellationToken ? cancellationToken->GetEventFd() : -1, POLLIN, 0 } };
+
+    int timeoutMs = (int)ceil(max(timeoutSeconds, 0.0) * 1000.0);
+
+    int result = poll(pollFds, cancellationToken ? 2 : 1, timeoutMs);
+    if ((result == 0) || ((result > 0) && !(pollFds[0].revents & POLLIN)))
+        return false;
+
+    if (result < 0)
+    {
+        if (errno == EINTR)
+            return false;
+
+        throw Error(format("can not wait for timer: error {} {}", errno, strerror(errno)));
+    }
+
+    // number of ticks expired since the last read
+    uint64_t numberOfExpirations = 0;
+    if (read(_timerFd, &numberOfExpirations, sizeof(numberOfExpirations)) != sizeof(numberOfExpirations))
+    {
+        if ((errno == EAGAIN) || (errno == EINTR))
+            return false;
+
+        // the wall clock was set (e.g. a NTP step), without restart the timer would deliver all ticks
+        // between the old and the new time at once or stop for the time the clock went back
+        if (errno == ECANCELED)
+        {
+            _statistics.ClockChanges++;
+            StartTimer();
+            return false;
+        }
+
+        throw Error(format("can not read timer: error {} {}", errno, strerror(errno)));
+    }
+
+    if (numberOfExpirations == 0)
+        return false;
+
+    _expiredTickIndex += (int64_t)numberOfExpirations;
+
+    // the lateness of the wake up after the latest expired tick
+    RecordJitter((GetRealtimeNs() - (_firstTickNs + _expiredTickIndex * _periodNs)) / 1e6);
+
+    if (numberOfExpirations > 1)
+    {
+        _statistics.Overruns++;
+
+        if (_overrunPolicy == OP_SKIP)
+            _statistics.SkippedTicks += numberOfExpirations - 1;
+    }
+
+    if (_overrunPolicy == OP_SKIP)
+    {
+        _tickIndex = _expiredTickIndex;
+    }
+    else
+    {
+        // deliver at most MAX_CATCH_UP_TICKS late ticks, e.g. after a suspend of the system
+        int64_t numberOfLateTicks = _expiredTickIndex - _tickIndex;
+        if (numberOfLateTicks > MAX_CATCH_UP_TICKS)
+        {
+            _statistics.SkippedTicks += numberOfLateTicks - MAX_CATCH_UP_TICKS;
+            _tickIndex += numberOfLateTicks - MAX_CATCH_UP_TICKS;
+        }
+
+        _tickIndex++;
+    }
+
+    _statistics.Ticks++;
+    return true;
+}
+
+PeriodicScheduler::time_point_type PeriodicScheduler::GetTickTime() const
+{
+    int64_t tickNs = _firstTickNs + max(_tickIndex, (int64_t)0) * _periodNs;
+    return time_point_type(duration_cast<system_clock::duration>(nanoseconds(tickNs)));
+}
+
+void PeriodicScheduler::StartTimer()
+{
+    // the first tick is the next multiple of the period since the start of the epoch
+    _firstTickNs = (GetRealtimeNs() / _periodNs + 1) * _periodNs;
+    _tickIndex = -1;
+    _expiredTickIndex = -1;
+
+    itimerspec timerSpec;
+    timerSpec.it_value = NsToTimespec(_firstTickNs);
+    timerSpec.it_interval = NsToTimespec(_periodNs);
+
+    // a change of the wall clock cancels the timer, so it can be restarted at the new time
+    if (timerfd_settime(_timerFd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &timerSpec, nullptr) != 0)
+        throw Error(format("can not start timer: error {} {}", errno, strerror(errno)));
+}
+
+void PeriodicScheduler::RecordJitter(double jitterMs)
+{
+    jitterMs = max(jitterMs, 0.0);
+
+    _numberOfJitterSamples++;
+    _jitterSumMs += jitterMs;
+    _jitterSquareSumMs += jitterMs * jitterMs;
+
+    double mean = _jitterSumMs / _numberOfJitterSamples;
+    double variance = _jitterSquareSumMs / _numberOfJitterSamples - mean * mean;
+
+    _statistics.JitterMeanMs = mean;
+    _statistics.JitterDeviationMs = sqrt(max(variance, 0.0));
+    _statistics.JitterMaxMs = max(_statistics.JitterMaxMs, jitterMs);
+}
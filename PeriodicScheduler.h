@@ -0,0 +1,135 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "CancellationToken.h"
+
+#include <chrono>
+#include <string>
+#include <stdexcept>
+#include <format>
+#include <cstdint>
+
+/// @brief Creates ticks at wall clock multiples of a period (e.g. at :00 and :30 for a period of 30 s), so the samples
+/// of different devices share the same timestamps and the cycles do not drift with the runtime of the work.
+/// Uses a timerfd with absolute expiration times. Late ticks (overruns) are skipped or caught up, the lateness of the
+/// ticks is recorded as jitter statistics. If the wall clock is set (e.g. by NTP), the ticks restart at the new time.
+class PeriodicScheduler
+{
+public:
+    typedef std::chrono::system_clock::time_point time_point_type;
+
+    /// @brief Periodic scheduler error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("Periodic scheduler error: {}", errorMessage)) { }
+    };
+
+    /// @brief What happens with the ticks that expired while the work of the previous tick was still running.
+    enum OverrunPolicy
+    {
+        OP_SKIP,            // the expired ticks are skipped, the work continues at the latest tick
+        OP_CATCH_UP         // the expired ticks are delivered immediately one after the other
+    };
+
+    /// @brief Maximum number of late ticks delivered by OP_CATCH_UP, older ticks are skipped.
+    constexpr static int64_t MAX_CATCH_UP_TICKS = 3;
+
+    /// @brief The timing statistics of the ticks.
+    struct Statistics
+    {
+        // number of delivered ticks
+        uint64_t Ticks = 0;
+
+        // number of times the work took longer than the period
+        uint64_t Overruns = 0;
+
+        // number of ticks skipped because of overruns (OP_SKIP, OP_CATCH_UP beyond MAX_CATCH_UP_TICKS)
+        uint64_t SkippedTicks = 0;
+
+        // number of times the wall clock was set and the ticks were restarted at the new time
+        uint64_t ClockChanges = 0;
+
+        // lateness of the wake up after the scheduled tick time (in ms)
+        double JitterMeanMs = 0.0;
+        double JitterDeviationMs = 0.0;
+        double JitterMaxMs = 0.0;
+
+        /// @brief Returns the statistics as string.
+        /// @return The statistics string.
+        std::string ToString() const;
+    };
+
+    /// @brief Constructor. The first tick is the next wall clock multiple of the period.
+    /// @param periodSeconds The period in s (resolution 1 ms).
+    /// @param overrunPolicy What happens with ticks that expired during an overrun.
+    PeriodicScheduler(double periodSeconds, OverrunPolicy overrunPolicy = OP_SKIP);
+    ~PeriodicScheduler();
+
+    PeriodicScheduler(const PeriodicScheduler &) = delete;
+    PeriodicScheduler & operator=(const PeriodicScheduler &) = delete;
+
+    /// @brief Waits for the next tick.
+    /// @param timeoutSeconds Maximum time to wait in s.
+    /// @param cancellationToken Optional token, waiting is stopped on cancellation.
+    /// @return True if a tick occurred, false on timeout or cancellation.
+    bool WaitForTick(double timeoutSeconds, const CancellationToken * cancellationToken = nullptr);
+
+    /// @brief Returns the scheduled time of the current tick (the last tick returned by WaitForTick()).
+    /// @return The tick time.
+    time_point_type GetTickTime() const;
+
+    /// @brief Returns the period.
+    /// @return The period in s.
+    double GetPeriod() const { return _periodNs / 1e9; }
+
+    /// @brief Returns the timing statistics.
+    /// @return The statistics.
+    const Statistics & GetStatistics() const { return _statistics; }
+
+private:
+    int _timerFd;
+    OverrunPolicy _overrunPolicy;
+
+    int64_t _periodNs;
+    int64_t _firstTickNs;
+
+    // index of the current tick and of the latest expired tick (counted from the first tick)
+    int64_t _tickIndex = -1;
+    int64_t _expiredTickIndex = -1;
+
+    Statistics _statistics;
+    uint64_t _numberOfJitterSamples = 0;
+    double _jitterSumMs = 0.0;
+    double _jitterSquareSumMs = 0.0;
+
+    /// @brief Starts the timer at the next wall clock multiple of the period. The timer is cancelled when the wall clock is set.
+    void StartTimer();
+
+    /// @brief Records the lateness of a tick.
+    /// @param jitterMs The lateness in ms.
+    void RecordJitter(double jitterMs);
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "RadioPacket.h"
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/// @brief The power level of the radio transmitter.
+enum RadioPowerLevel
+{
+    RPL_MIN,
+    RPL_LOW,
+    RPL_HIGH,
+    RPL_MAX
+};
+
+/// @brief Interface of the radio used to communicate with the inverter. Covers only the functions the
+/// protocol needs, so the protocol can run on the nRF24L01 module (Rf24Radio) or on a simulation (SimulatedInverterRadio).
+class Radio
+{
+public:
+    // usual maximum number of timestamps returned by AcknowledgeReceiveInterrupts(), to reserve memory
+    constexpr static size_t RECEIVE_INTERRUPT_BUFFER_SIZE = 16;
+
+    virtual ~Radio() = default;
+
+    /// @brief Initializes the radio.
+    /// @param writingPipeAddress The address where the packets are sent to (5 bytes).
+    /// @param readingPipeAddress The address where packets are received (5 bytes).
+    virtual void Initialize(std::span<const uint8_t> writingPipeAddress, std::span<const uint8_t> readingPipeAddress) = 0;
+
+    /// @brief Terminates the radio. Does nothing if the radio is not initialized.
+    virtual void Terminate() = 0;
+
+    /// @brief Checks if the radio is initialized.
+    /// @return True if initialized.
+    virtual bool IsInitialized() const = 0;
+
+    /// @brief Returns information about the radio.
+    /// @return The information string.
+    virtual std::string GetDetails() = 0;
+
+    /// @brief Sets the power level of the transmitter.
+    /// @param powerLevel The power level.
+    virtual void SetPowerLevel(RadioPowerLevel powerLevel) = 0;
+
+    /// @brief Sets the radio channel. (Waits until the channel is set.)
+    /// @param channel The channel (0 ... 125).
+    virtual void SetChannel(int channel) = 0;
+
+    /// @brief Switches to receive mode.
+    virtual void StartListening() = 0;
+
+    /// @brief Switches to transmit mode.
+    virtual void StopListening() = 0;
+
+    /// @brief Discards the received packets.
+    virtual void FlushRx() = 0;
+
+    /// @brief Discards the packets to be sent.
+    virtual void FlushTx() = 0;
+
+    /// @brief Sends a packet.
+    /// @param packet The packet (up to 32 bytes).
+    /// @return True if the packet was acknowledged.
+    virtual bool Write(std::span<const uint8_t> packet) = 0;
+
+    /// @brief Checks if a received packet is available.
+    /// @return True if a packet can be read.
+    virtual bool IsPacketAvailable() = 0;
+
+    /// @brief Reads a received packet. If the packet is corrupted, all received packets are discarded.
+    /// @param packet The packet.
+    /// @return False if no valid packet was available.
+    virtual bool ReadPacket(RadioPacket & packet) = 0;
+
+    /// @brief Checks if a carrier was detected on the current channel.
+    /// @return True if a carrier was detected.
+    virtual bool IsCarrierDetected() = 0;
+
+    /// @brief Checks if the radio signals received packets by interrupt. Otherwise the radio must be polled.
+    /// @return True if the interrupt functions can be used.
+    virtual bool HasReceiveInterrupt() const = 0;
+
+    /// @brief Clears the pending receive interrupts.
+    virtual void ClearReceiveInterrupts() = 0;
+
+    /// @brief Sleeps until a receive interrupt occurs or the timeout is over.
+    /// @param timeoutSeconds The timeout in s.
+    /// @return True if a receive interrupt occurred, false on timeout.
+    virtual bool WaitForReceiveInterrupt(double timeoutSeconds) = 0;
+
+    /// @brief Acknowledges the pending receive interrupts and returns their timestamps.
+    /// @param timestampsNs The monotonic timestamps of the interrupts in ns. (This function clears the list first.)
+    virtual void AcknowledgeReceiveInterrupts(std::vector <uint64_t> & timestampsNs) = 0;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <array>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/// @brief A radio packet with the fixed capacity of a nRF24L01 payload. The packet data is stored
+/// in the object itself, so packets can be created, copied and stored without heap allocations.
+class RadioPacket
+{
+public:
+    // maximum size of packets that can be sent with the nRF24L01 module
+    constexpr static size_t CAPACITY = 32;
+
+    /// @brief Creates an empty packet.
+    RadioPacket() = default;
+
+    /// @brief Returns the size of the packet.
+    /// @return The size in bytes.
+    size_t size() const { return _size; }
+
+    /// @brief Returns the packet data.
+    /// @return Pointer to the first byte.
+    uint8_t * data() { return _data.data(); }
+    const uint8_t * data() const { return _data.data(); }
+
+    /// @brief Iterators over the packet data.
+    uint8_t * begin() { return _data.data(); }
+    uint8_t * end() { return _data.data() + _size; }
+    const uint8_t * begin() const { return _data.data(); }
+    const uint8_t * end() const { return _data.data() + _size; }
+
+    /// @brief Access to a byte of the packet (without range check).
+    uint8_t & operator[](size_t idx) { return _data[idx]; }
+    uint8_t operator[](size_t idx) const { return _data[idx]; }
+
+    /// @brief Checks if the packet is empty.
+    /// @return True if the packet contains no data.
+    bool IsEmpty() const { return _size == 0; }
+
+    /// @brief Checks if the packet is full.
+    /// @return True if no more bytes can be added.
+    bool IsFull() const { return _size == CAPACITY; }
+
+    /// @brief Removes all data.
+    void Clear() { _size = 0; }
+
+    /// @brief Sets the size of the packet. (E.g. after the data was written with data().)
+    /// @param size The new size.
+    /// @return False if the size exceeds the capacity.
+    bool Resize(size_t size)
+    {
+        if (size > CAPACITY)
+            return false;
+
+        _size = (uint8_t)size;
+        return true;
+    }
+
+    /// @brief Appends a byte.
+    /// @param b The byte.
+    /// @return False if the packet is full.
+    bool PushBack(uint8_t b)
+    {
+        if (_size >= CAPACITY)
+            return false;
+
+        _data[_size++] = b;
+        return true;
+    }
+
+    /// @brief Appends bytes.
+    /// @param bytes The bytes.
+    /// @return False if the bytes do not fit into the packet. (Nothing is appended.)
+    bool Append(std::span<const uint8_t> bytes)
+    {
+        if (bytes.size() > CAPACITY - _size)
+            return false;
+
+        std::copy(bytes.begin(), bytes.end(), _data.begin() + _size);
+        _size += (uint8_t)bytes.size();
+        return true;
+    }
+
+    /// @brief Replaces the packet data.
+    /// @param bytes The bytes.
+    /// @return False if the bytes do not fit into the packet. (The packet is cleared.)
+    bool Assign(std::span<const uint8_t> bytes)
+    {
+        Clear();
+        return Append(bytes);
+    }
+
+    /// @brief Compares the packet data.
+    bool operator==(const RadioPacket & other) const
+    {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    std::array<uint8_t, CAPACITY> _data;
+    uint8_t _size = 0;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <array>
+#include <limits>
+#include <cstddef>
+#include <algorithm>
+
+#include "ObisRegistry.h"
+
+/// @brief The readings of a device at a point in time with a fixed layout, a reading is addressed by its index.
+/// The electricity meter readings are indexed by the reading index of the OBIS registry (the built-in readings, then the
+/// additional readings), the inverter readings by InverterChannelIndex() and InverterIndex().
+/// The names of the readings are only needed to create the database tables, the samples are copied without allocations.
+struct ReadingsRecord
+{
+    /// @brief The inverter readings of a channel (= solar panel).
+    enum InverterChannelReading
+    {
+        ICR_DC_VOLTAGE = 0,
+        ICR_DC_CURRENT,
+        ICR_DC_POWER,
+        ICR_DC_ENERGY_DAY,
+        ICR_DC_ENERGY_TOTAL,
+        NUMBER_OF_INVERTER_CHANNEL_READINGS
+    };
+
+    /// @brief The inverter readings of the AC side.
+    enum InverterReading
+    {
+        IR_AC_VOLTAGE = 0,
+        IR_AC_CURRENT,
+        IR_AC_FREQUENCY,
+        IR_AC_POWER,
+        IR_AC_REACTIVE_POWER,
+        IR_AC_POWER_FACTOR,
+        IR_TEMPERATURE,
+        NUMBER_OF_INVERTER_READINGS
+    };
+
+    /// @brief The database column names of the channel readings (indexed by InverterChannelReading), e.g. "CH0 DC V".
+    constexpr static std::array<const char *, NUMBER_OF_INVERTER_CHANNEL_READINGS> INVERTER_CHANNEL_READING_NAMES
+        {{ "DC V", "DC I", "DC P", "DC E day", "DC E total" }};
+
+    /// @brief The database column names of the AC readings (indexed by InverterReading).
+    constexpr static std::array<const char *, NUMBER_OF_INVERTER_READINGS> INVERTER_READING_NAMES
+        {{ "AC V", "AC I", "AC F", "AC P", "AC Q", "AC PF", "T" }};
+
+    /// @brief The maximum number of inverter channels (HM-1200 and HM-1500 have 4 channels).
+    constexpr static int MAX_INVERTER_CHANNELS = 4;
+
+    constexpr static size_t NUMBER_OF_ELECTRICITY_METER_VALUES = ObisRegistry::NUMBER_OF_BUILTIN_READINGS + ObisRegistry::MAX_ADDITIONAL_READINGS;
+    constexpr static size_t NUMBER_OF_INVERTER_VALUES = MAX_INVERTER_CHANNELS * NUMBER_OF_INVERTER_CHANNEL_READINGS + NUMBER_OF_INVERTER_READINGS;
+
+    /// @brief The readings, NaN if a reading is not available.
+    std::array<double, std::max(NUMBER_OF_ELECTRICITY_METER_VALUES, NUMBER_OF_INVERTER_VALUES)> Values;
+
+    /// @brief Constructor. No reading is available.
+    ReadingsRecord() { Clear(); }
+
+    /// @brief Sets all readings to not available.
+    void Clear() { Values.fill(std::numeric_limits<double>::quiet_NaN()); }
+
+    /// @brief Returns the index of an inverter channel reading.
+    /// @param channel The channel (0 ... MAX_INVERTER_CHANNELS - 1).
+    /// @param reading The reading.
+    /// @return The index.
+    constexpr static size_t InverterChannelIndex(int channel, InverterChannelReading reading)
+    {
+        return (size_t)channel * NUMBER_OF_INVERTER_CHANNEL_READINGS + reading;
+    }
+
+    /// @brief Returns the index of an inverter AC reading.
+    /// @param reading The reading.
+    /// @return The index.
+    constexpr static size_t InverterIndex(InverterReading reading)
+    {
+        return MAX_INVERTER_CHANNELS * NUMBER_OF_INVERTER_CHANNEL_READINGS + reading;
+    }
+};
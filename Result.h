@@ -0,0 +1,149 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <optional>
+#include <utility>
+
+/// @brief The kinds of errors reported by the non-throwing ("Try...") functions.
+enum ErrorKind
+{
+    EK_NONE = 0,
+    EK_NOT_OPEN,
+    EK_TIMEOUT,
+    EK_IO_ERROR,
+    EK_BUFFER_OVERFLOW,
+    EK_OUT_OF_RANGE,
+    EK_INVALID_DATA,
+    EK_DATA_TYPE_MISMATCH,
+    EK_INVALID_FRAME,
+    EK_CHECKSUM_ERROR,
+    EK_INVALID_ESCAPE_SEQUENCE,
+    EK_INCOMPLETE,
+    EK_NOT_FOUND,
+    NUMBER_OF_ERROR_KINDS
+};
+
+/// @brief Returns the name of an error kind.
+/// @param errorKind The error kind.
+/// @return The name of the error kind.
+constexpr const char * GetErrorKindName(ErrorKind errorKind)
+{
+    switch (errorKind)
+    {
+    case EK_NONE:                       return "no error";
+    case EK_NOT_OPEN:                   return "not open";
+    case EK_TIMEOUT:                    return "timeout";
+    case EK_IO_ERROR:                   return "I/O error";
+    case EK_BUFFER_OVERFLOW:            return "buffer overflow";
+    case EK_OUT_OF_RANGE:               return "out of range";
+    case EK_INVALID_DATA:               return "invalid data";
+    case EK_DATA_TYPE_MISMATCH:         return "data type mismatch";
+    case EK_INVALID_FRAME:              return "invalid frame";
+    case EK_CHECKSUM_ERROR:             return "checksum error";
+    case EK_INVALID_ESCAPE_SEQUENCE:    return "invalid escape sequence";
+    case EK_INCOMPLETE:                 return "incomplete";
+    case EK_NOT_FOUND:                  return "not found";
+    default:                            return "unknown error";
+    }
+}
+
+/// @brief Marks a failed result, e.g. "return Failure(EK_TIMEOUT);".
+struct Failure
+{
+    explicit Failure(ErrorKind errorKind) : Kind(errorKind) { }
+
+    ErrorKind Kind;
+};
+
+/// @brief The result of a function that does not throw exceptions: either a value or an error kind.
+/// Creating and checking a result does not allocate memory.
+/// @tparam T The type of the value.
+template <typename T>
+class Result
+{
+public:
+    /// @brief Constructor. Successful result.
+    /// @param value The value.
+    Result(const T & value) : _value(value), _errorKind(EK_NONE) { }
+
+    /// @brief Constructor. Successful result.
+    /// @param value The value.
+    Result(T && value) : _value(std::move(value)), _errorKind(EK_NONE) { }
+
+    /// @brief Constructor. Failed result.
+    /// @param failure The error kind.
+    Result(Failure failure) : _errorKind(failure.Kind) { }
+
+    /// @brief Checks if the result is successful.
+    /// @return True if the result contains a value.
+    bool IsOk() const { return _errorKind == EK_NONE; }
+
+    explicit operator bool() const { return IsOk(); }
+
+    /// @brief Returns the error kind.
+    /// @return The error kind (EK_NONE if successful).
+    ErrorKind GetErrorKind() const { return _errorKind; }
+
+    /// @brief Returns the value. Must only be called if the result is successful.
+    /// @return The value.
+    const T & GetValue() const { return *_value; }
+    T & GetValue() { return *_value; }
+
+    const T & operator*() const { return *_value; }
+    T & operator*() { return *_value; }
+    const T * operator->() const { return &(*_value); }
+    T * operator->() { return &(*_value); }
+
+private:
+    std::optional<T> _value;
+    ErrorKind _errorKind;
+};
+
+/// @brief The result of a function without return value that does not throw exceptions.
+template <>
+class Result <void>
+{
+public:
+    /// @brief Constructor. Successful result.
+    Result() : _errorKind(EK_NONE) { }
+
+    /// @brief Constructor. Failed result.
+    /// @param failure The error kind.
+    Result(Failure failure) : _errorKind(failure.Kind) { }
+
+    /// @brief Checks if the result is successful.
+    /// @return True if successful.
+    bool IsOk() const { return _errorKind == EK_NONE; }
+
+    explicit operator bool() const { return IsOk(); }
+
+    /// @brief Returns the error kind.
+    /// @return The error kind (EK_NONE if successful).
+    ErrorKind GetErrorKind() const { return _errorKind; }
+
+private:
+    ErrorKind _errorKind;
+};
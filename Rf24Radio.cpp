@@ -0,0 +1,270 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "Rf24Radio.h"
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+using namespace std::chrono;
+
+Rf24Radio::Rf24Radio(int pinCSn, int pinCE, int pinIRQ)
+    : _pinCSn(pinCSn)
+    , _pinCE(pinCE)
+    , _pinIRQ(pinIRQ)
+{
+    _irqEvents.reserve(Gpio::EDGE_EVENT_BUFFER_SIZE);
+}
+
+Rf24Radio::~Rf24Radio()
+{
+    try
+    {
+        Terminate();
+    }
+    catch(const exception & exc)
+    {
+        cerr << exc.what() << endl;
+    }
+}
+
+void Rf24Radio::Initialize(std::span<const uint8_t> writingPipeAddress, std::span<const uint8_t> readingPipeAddress)
+{
+    Terminate();
+
+    if ((writingPipeAddress.size() != 5) || (readingPipeAddress.size() != 5))
+        throw Error("Initialize: the pipe addresses must have 5 bytes.");
+
+    auto radio = make_unique<RF24>(_pinCE, _pinCSn, SPI_FREQUENCY_HZ);
+
+    if (!radio->begin())
+        throw Error("Can not initialize RF24!");
+    
+    if (!radio->isChipConnected())
+        throw Error("Error chip is not connected!");
+
+    radio->stopListening();
+
+    radio->setDataRate(RF24_250KBPS);
+    radio->setPALevel(RF24_PA_MIN);
+    radio->setCRCLength(RF24_CRC_16);
+    radio->setAddressWidth(5);
+
+    radio->openWritingPipe(writingPipeAddress.data());
+    radio->openReadingPipe(RX_PIPE_NUM, readingPipeAddress.data());
+
+    radio->enableDynamicPayloads();
+    radio->setRetries(3, 10);
+    radio->setAutoAck(true);
+
+    if (_pinIRQ >= 0)
+    {
+        // the IRQ line goes low (falling edge) only if data was received
+        radio->maskIRQ(true, true, false);
+
+        auto gpio = make_unique<Gpio>("Rf24Radio");
+        gpio->InitializeEdgeEventLine(_pinIRQ, Gpio::GE_FALLING);
+        _gpio = std::move(gpio);
+    }
+
+    _radio = std::move(radio);
+}
+
+void Rf24Radio::Terminate()
+{
+    if (!_radio)
+        return;
+
+    // recommended idle behavior is TX mode
+    _radio->stopListening();
+
+    _radio.reset();
+    _gpio.reset();
+}
+
+std::string Rf24Radio::GetDetails()
+{
+    AssertIsInitialized();
+
+    vector <char> buffer(1024, '\0');
+    _radio->sprintfPrettyDetails(&(buffer[0]));
+
+    return string(&(buffer[0]));
+}
+
+void Rf24Radio::SetPowerLevel(RadioPowerLevel powerLevel)
+{
+    AssertIsInitialized();
+
+    switch (powerLevel)
+    {
+        case RPL_MIN:
+            _radio->setPALevel(RF24_PA_MIN);
+            break;
+
+        case RPL_LOW:
+            _radio->setPALevel(RF24_PA_LOW);
+            break;
+
+        case RPL_HIGH:
+            _radio->setPALevel(RF24_PA_HIGH);
+            break;
+
+        case RPL_MAX:
+            _radio->setPALevel(RF24_PA_MAX);
+            break;
+
+        default:
+            throw Error(format("SetPowerLevel: invalid power level {}", (int)powerLevel));
+    }
+}
+
+void Rf24Radio::SetChannel(int channel)
+{
+    AssertIsInitialized();
+
+    _radio->setChannel((uint8_t)channel);
+
+    // wait until the channel is set
+    _radio->getChannel();
+}
+
+void Rf24Radio::StartListening()
+{
+    AssertIsInitialized();
+    _radio->startListening();
+}
+
+void Rf24Radio::StopListening()
+{
+    AssertIsInitialized();
+    _radio->stopListening();
+}
+
+void Rf24Radio::FlushRx()
+{
+    AssertIsInitialized();
+    _radio->flush_rx();
+}
+
+void Rf24Radio::FlushTx()
+{
+    AssertIsInitialized();
+    _radio->flush_tx();
+}
+
+bool Rf24Radio::Write(std::span<const uint8_t> packet)
+{
+    AssertIsInitialized();
+
+    if (packet.size() > RadioPacket::CAPACITY)
+        throw Error(format("Write: packet size {} > {}", packet.size(), RadioPacket::CAPACITY));
+
+    // the channel was changed just before, give the PLL time to settle
+    this_thread::sleep_for(microseconds(150));
+
+    return _radio->write(packet.data(), (uint8_t)packet.size());
+}
+
+bool Rf24Radio::IsPacketAvailable()
+{
+    AssertIsInitialized();
+    return _radio->available();
+}
+
+bool Rf24Radio::ReadPacket(RadioPacket & packet)
+{
+    AssertIsInitialized();
+
+    if (!_radio->available())
+        return false;
+
+    uint8_t packetLen = _radio->getDynamicPayloadSize();
+
+    // invalid payload size (corrupted packet): the FIFO must be flushed
+    if (!packet.Resize(packetLen) || packet.IsEmpty())
+    {
+        _radio->flush_rx();
+        return false;
+    }
+
+    _radio->read(packet.data(), packetLen);
+
+    return true;
+}
+
+bool Rf24Radio::IsCarrierDetected()
+{
+    AssertIsInitialized();
+    return _radio->testRPD();
+}
+
+void Rf24Radio::ClearReceiveInterrupts()
+{
+    AssertIsInitialized();
+
+    // clear the radio status flags (releases the IRQ line) and discard old edge events
+    bool txOk, txFail, rxReady;
+    _radio->whatHappened(txOk, txFail, rxReady);
+
+    if (_gpio)
+        _gpio->ReadEdgeEvents(_pinIRQ, _irqEvents);
+}
+
+bool Rf24Radio::WaitForReceiveInterrupt(double timeoutSeconds)
+{
+    AssertIsInitialized();
+
+    if (!_gpio)
+        throw Error("WaitForReceiveInterrupt: the IRQ pin is not connected.");
+
+    return _gpio->WaitForEdgeEvent(_pinIRQ, timeoutSeconds);
+}
+
+void Rf24Radio::AcknowledgeReceiveInterrupts(std::vector <uint64_t> & timestampsNs)
+{
+    AssertIsInitialized();
+
+    timestampsNs.clear();
+
+    if (!_gpio)
+        throw Error("AcknowledgeReceiveInterrupts: the IRQ pin is not connected.");
+
+    _gpio->ReadEdgeEvents(_pinIRQ, _irqEvents);
+
+    for (const auto & irqEvent : _irqEvents)
+        timestampsNs.push_back(irqEvent.TimestampNs);
+
+    // clear the status flags, so a packet received while reading the FIFO creates a new edge
+    bool txOk, txFail, rxReady;
+    _radio->whatHappened(txOk, txFail, rxReady);
+}
+
+void Rf24Radio::AssertIsInitialized() const
+{
+    if (!_radio)
+        throw Error("Radio is not initialized!");
+}
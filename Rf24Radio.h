@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <RF24/RF24.h>
+
+#include "Radio.h"
+#include "Gpio.h"
+
+#include <memory>
+#include <format>
+#include <stdexcept>
+
+/// @brief The nRF24L01+ radio module connected via SPI (RF24 library).
+class Rf24Radio : public Radio
+{
+public:
+    /// @brief nRF24L01 radio error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("nRF24L01 radio error: {}", errorMessage)) { }
+    };
+
+    /// @brief Constructor.
+    /// @param pinCSn The CSN pin as SPI device number (0 or 1), usually 0.
+    /// @param pinCE The GPIO pin connected to the NRF24L01 CE signal.
+    /// @param pinIRQ The GPIO pin connected to the NRF24L01 IRQ signal or -1 if IRQ is not connected (the radio is polled).
+    Rf24Radio(int pinCSn = 0, int pinCE = 24, int pinIRQ = -1);
+    virtual ~Rf24Radio();
+
+    Rf24Radio(const Rf24Radio &) = delete;
+    Rf24Radio & operator=(const Rf24Radio &) = delete;
+
+    void Initialize(std::span<const uint8_t> writingPipeAddress, std::span<const uint8_t> readingPipeAddress) override;
+    void Terminate() override;
+    bool IsInitialized() const override { return (bool)_radio; }
+    std::string GetDetails() override;
+
+    void SetPowerLevel(RadioPowerLevel powerLevel) override;
+    void SetChannel(int channel) override;
+    void StartListening() override;
+    void StopListening() override;
+    void FlushRx() override;
+    void FlushTx() override;
+
+    bool Write(std::span<const uint8_t> packet) override;
+    bool IsPacketAvailable() override;
+    bool ReadPacket(RadioPacket & packet) override;
+    bool IsCarrierDetected() override;
+
+    bool HasReceiveInterrupt() const override { return (bool)_gpio; }
+    void ClearReceiveInterrupts() override;
+    bool WaitForReceiveInterrupt(double timeoutSeconds) override;
+    void AcknowledgeReceiveInterrupts(std::vector <uint64_t> & timestampsNs) override;
+
+private:
+    // the nRF24L01 receive pipeline
+    constexpr static int RX_PIPE_NUM = 1;
+
+    // the SPI communication frequency (in Hz)
+    constexpr static int SPI_FREQUENCY_HZ = 1000000;
+
+    int _pinCSn;
+    int _pinCE;
+    int _pinIRQ;
+
+    std::unique_ptr<RF24> _radio;
+
+    // the IRQ line (only if the IRQ pin is connected)
+    std::unique_ptr<Gpio> _gpio;
+    std::vector <Gpio::EdgeEvent> _irqEvents;
+
+    /// @brief Throws an error if the radio is not intialized.
+    void AssertIsInitialized() const;
+};
@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "RingBuffer.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <format>
+
+using namespace std;
+
+RingBuffer::RingBuffer(size_t capacity)
+: _buffer(capacity)
+, _readPosition(0)
+, _size(0)
+{
+    if (capacity == 0)
+        throw invalid_argument("RingBuffer: capacity must not be 0");
+}
+
+void RingBuffer::Clear()
+{
+    _readPosition = 0;
+    _size = 0;
+}
+
+std::span<const uint8_t> RingBuffer::GetReadableData() const
+{
+    size_t count = min(_size, _buffer.size() - _readPosition);
+    return span<const uint8_t>(_buffer.data() + _readPosition, count);
+}
+
+void RingBuffer::Consume(size_t count)
+{
+    if (count > _size)
+        throw out_of_range(format("RingBuffer: can not consume {} bytes, only {} bytes available", count, _size));
+
+    _readPosition = (_readPosition + count) % _buffer.size();
+    _size -= count;
+
+    // keep the data contiguous as long as possible
+    if (_size == 0)
+        _readPosition = 0;
+}
+
+void RingBuffer::GetWritableSegments(std::span<uint8_t> & first, std::span<uint8_t> & second)
+{
+    size_t capacity = _buffer.size();
+    size_t writePosition = (_readPosition + _size) % capacity;
+    size_t freeSpace = capacity - _size;
+
+    size_t firstCount = min(freeSpace, capacity - writePosition);
+
+    first = span<uint8_t>(_buffer.data() + writePosition, firstCount);
+    second = span<uint8_t>(_buffer.data(), freeSpace - firstCount);
+}
+
+void RingBuffer::Commit(size_t count)
+{
+    if (count > GetFreeSpace())
+        throw out_of_range(format("RingBuffer: can not commit {} bytes, only {} bytes free", count, GetFreeSpace()));
+
+    _size += count;
+}
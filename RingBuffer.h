@@ -0,0 +1,81 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+/// @brief Byte ring buffer with fixed capacity. Data is written and read in contiguous segments, so no data has to be copied.
+class RingBuffer
+{
+public:
+    /// @brief Constructor.
+    /// @param capacity The capacity in bytes.
+    RingBuffer(size_t capacity);
+
+    /// @brief Returns the capacity.
+    /// @return The capacity in bytes.
+    size_t GetCapacity() const { return _buffer.size(); }
+
+    /// @brief Returns the number of bytes that can be read.
+    /// @return The number of bytes in the buffer.
+    size_t GetSize() const { return _size; }
+
+    /// @brief Checks if the buffer is empty.
+    /// @return True if the buffer contains no data.
+    bool IsEmpty() const { return _size == 0; }
+
+    /// @brief Returns the number of bytes that can be written.
+    /// @return The free space in bytes.
+    size_t GetFreeSpace() const { return _buffer.size() - _size; }
+
+    /// @brief Discards all data.
+    void Clear();
+
+    /// @brief Returns the oldest contiguous part of the data in the buffer.
+    /// (If the data wraps around the end of the buffer, the rest is returned after Consume().)
+    /// @return The readable data.
+    std::span<const uint8_t> GetReadableData() const;
+
+    /// @brief Removes data from the buffer after it was read.
+    /// @param count The number of bytes to remove.
+    void Consume(size_t count);
+
+    /// @brief Returns the free space as up to two contiguous segments.
+    /// @param first The first segment to write.
+    /// @param second The second segment to write. (Empty if the free space does not wrap around.)
+    void GetWritableSegments(std::span<uint8_t> & first, std::span<uint8_t> & second);
+
+    /// @brief Adds data to the buffer after it was written into the writable segments.
+    /// @param count The number of bytes written.
+    void Commit(size_t count);
+
+private:
+    std::vector<uint8_t> _buffer;
+    size_t _readPosition;
+    size_t _size;
+};
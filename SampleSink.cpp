@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "SampleSink.h"
+
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+SampleSink::SampleSink(size_t capacity)
+: _capacity(capacity)
+{
+}
+
+void SampleSink::Publish(Sample && sample)
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        if (_samples.size() >= _capacity)
+        {
+            // the buffer is used as a ring, the oldest sample is overwritten instead of shifting all samples
+            _samples[_oldestSampleIndex] = std::move(sample);
+            _oldestSampleIndex = (_oldestSampleIndex + 1) % _samples.size();
+            _numberOfDroppedSamples++;
+        }
+        else
+        {
+            _samples.push_back(std::move(sample));
+        }
+        _maximumNumberOfWaitingSamples = max(_maximumNumberOfWaitingSamples, _samples.size());
+    }
+
+    _samplesAvailable.notify_one();
+}
+
+bool SampleSink::WaitAndTakeAll(std::vector <Sample> & samples, double timeoutSeconds, size_t minimumNumberOfSamples)
+{
+    samples.clear();
+
+    unique_lock<mutex> lock(_mutex);
+
+    _samplesAvailable.wait_for(lock, chrono::duration<double>(timeoutSeconds),
+        [&] { return (_samples.size() >= max(minimumNumberOfSamples, (size_t)1)) || _isInterrupted; });
+    _isInterrupted = false;
+
+    if (_samples.empty())
+        return false;
+
+    // only after dropped samples the ring is not in the order the samples were published
+    if (_oldestSampleIndex > 0)
+    {
+        rotate(_samples.begin(), _samples.begin() + _oldestSampleIndex, _samples.end());
+        _oldestSampleIndex = 0;
+    }
+
+    // the sample buffers are swapped, so no sample is copied
+    samples.swap(_samples);
+    return true;
+}
+
+void SampleSink::Interrupt()
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        _isInterrupted = true;
+    }
+
+    _samplesAvailable.notify_all();
+}
+
+uint64_t SampleSink::GetNumberOfDroppedSamples() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _numberOfDroppedSamples;
+}
+
+size_t SampleSink::GetMaximumNumberOfWaitingSamples() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _maximumNumberOfWaitingSamples;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "ReadingsRecord.h"
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <ctime>
+#include <cstdint>
+
+/// @brief The readings of a device at a point in time.
+struct Sample
+{
+    /// @brief The device that delivered the readings.
+    enum SampleSource
+    {
+        SS_ELECTRICITY_METER,
+        SS_INVERTER
+    };
+
+    SampleSource Source;
+
+    // the electricity meter number 0 or 1 (0 for the inverter)
+    int DeviceNumber;
+
+    // the time when the readings were taken (in s since the start of the epoch)
+    time_t Time;
+
+    ReadingsRecord Readings;
+};
+
+/// @brief Collects the samples of the device workers, so they can be stored by another thread.
+/// The samples can be published from any thread. If the consumer is too slow, the oldest samples are dropped.
+class SampleSink
+{
+public:
+    /// @brief Constructor.
+    /// @param capacity Maximum number of samples waiting to be taken.
+    SampleSink(size_t capacity = DEFAULT_CAPACITY);
+
+    SampleSink(const SampleSink &) = delete;
+    SampleSink & operator=(const SampleSink &) = delete;
+
+    /// @brief Publishes a sample. Wakes up the consumer.
+    /// @param sample The sample.
+    void Publish(Sample && sample);
+
+    /// @brief Waits until the minimum number of samples is available, the timeout is over or the wait is interrupted
+    /// and takes all samples.
+    /// @param samples The samples in the order they were published. (This function clears the list first.)
+    /// @param timeoutSeconds The timeout in s.
+    /// @param minimumNumberOfSamples The number of samples to wait for. (Less samples are taken on timeout.)
+    /// @return True if samples were taken.
+    bool WaitAndTakeAll(std::vector <Sample> & samples, double timeoutSeconds, size_t minimumNumberOfSamples = 1);
+
+    /// @brief Wakes up the consumer waiting in WaitAndTakeAll() (e.g. to stop it).
+    void Interrupt();
+
+    /// @brief Returns the number of samples dropped because the sink was full.
+    /// @return The number of dropped samples.
+    uint64_t GetNumberOfDroppedSamples() const;
+
+    /// @brief Returns the maximum number of samples that were waiting to be taken.
+    /// @return The maximum number of waiting samples.
+    size_t GetMaximumNumberOfWaitingSamples() const;
+
+private:
+    constexpr static size_t DEFAULT_CAPACITY = 1000;
+
+    size_t _capacity;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _samplesAvailable;
+    std::vector <Sample> _samples;
+
+    // the index of the oldest sample in _samples, it is not 0 after samples were dropped
+    size_t _oldestSampleIndex = 0;
+    uint64_t _numberOfDroppedSamples = 0;
+    size_t _maximumNumberOfWaitingSamples = 0;
+    bool _isInterrupted = false;
+};
@@ -32,11 +32,15 @@ IN THE SOFTWARE.
 #include <termios.h>
 #include <unistd.h>
 #include <string.h>
+#include <poll.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 
 using namespace std;
+using namespace std::chrono;
 
 SerialPort::SerialPort()
+: _receiveBuffer(RECEIVE_BUFFER_SIZE)
 {
 }
 
@@ -64,6 +68,7 @@ void SerialPort::ClosePort()
     close(_fileDescriptor);
     _fileDescriptor = -1;
     _serialPortName.clear();
+    _receiveBuffer.Clear();
 }
 
 void SerialPort::ConfigurePort(int baudrate, Parity parity, int dataBits, int stopBits,
@@ -225,9 +230,46 @@ size_t SerialPort::ReadData(void * data, size_t length, bool blocking) const
     return ReadDataNonBlocking(data, length);
 }
 
+void SerialPort::ThrowError(ErrorKind errorKind, const std::string & operation) const
+{
+    switch (errorKind)
+    {
+    case EK_NOT_OPEN:
+        throw Error("port is not open!");
+
+    case EK_TIMEOUT:
+        throw Timeout(format("{} port {}", operation, _serialPortName));
+
+    case EK_IO_ERROR:
+        throw Error(format("{} port {}: error {} {}", operation, _serialPortName, errno, strerror(errno)));
+
+    default:
+        throw Error(format("{} port {}: {}", operation, _serialPortName, GetErrorKindName(errorKind)));
+    }
+}
+
 size_t SerialPort::ReadDataBlocking(void * data, size_t length) const
 {
-    AssertPortIsOpen();
+    auto result = TryReadDataBlocking(data, length);
+    if (!result)
+        ThrowError(result.GetErrorKind(), format("reading {} bytes from", length));
+
+    return *result;
+}
+
+size_t SerialPort::ReadDataNonBlocking(void * data, size_t length) const
+{
+    auto result = TryReadDataNonBlocking(data, length);
+    if (!result)
+        ThrowError(result.GetErrorKind(), "can not read data from");
+
+    return *result;
+}
+
+Result<size_t> SerialPort::TryReadDataBlocking(void * data, size_t length) const
+{
+    if (_fileDescriptor < 0)
+        return Fail(EK_NOT_OPEN);
 
     size_t totalBytesRead = 0;
     uint8_t * dataPtr = static_cast<uint8_t *>(data);
@@ -237,39 +279,121 @@ size_t SerialPort::ReadDataBlocking(void * data, size_t length) const
         auto bytesRead = read(_fileDescriptor, dataPtr + totalBytesRead, length - totalBytesRead);
         if (bytesRead < 0)
         {
-            throw Error(format("can not read data from port {}: error {} {} ({} of {} bytes read)",
-                _serialPortName, errno, strerror(errno), totalBytesRead, length));
+            if (errno == EINTR)
+                continue;
+
+            return Fail(EK_IO_ERROR);
         }
         else if (bytesRead == 0)
         {
             // Timeout reached
-            break;
+            return Fail(EK_TIMEOUT);
         }
 
         totalBytesRead += bytesRead;
     }
 
-    if (totalBytesRead < length)
+    return totalBytesRead;
+}
+
+Result<size_t> SerialPort::TryReadDataNonBlocking(void * data, size_t length) const
+{
+    if (_fileDescriptor < 0)
+        return Fail(EK_NOT_OPEN);
+
+    auto bytesRead = read(_fileDescriptor, data, length);
+    if (bytesRead < 0)
     {
-        throw Timeout(format("reading data from port {}: only {} of {} bytes read",
-            _serialPortName, totalBytesRead, length));
+        if ((errno == EINTR) || (errno == EAGAIN))
+            return (size_t)0;
+
+        return Fail(EK_IO_ERROR);
     }
 
-    return totalBytesRead;
+    return (size_t)bytesRead;
 }
 
-size_t SerialPort::ReadDataNonBlocking(void * data, size_t length) const
+bool SerialPort::WaitForData(const time_point_type & deadline) const
 {
-    AssertPortIsOpen();
+    auto result = TryWaitForData(deadline);
+    if (!result && (result.GetErrorKind() != EK_TIMEOUT))
+        ThrowError(result.GetErrorKind(), "can not wait for data from");
 
-    auto bytesRead = read(_fileDescriptor, data, length);
+    return result.IsOk();
+}
+
+Result<void> SerialPort::TryWaitForData(const time_point_type & deadline) const
+{
+    if (_fileDescriptor < 0)
+        return Fail(EK_NOT_OPEN);
+
+    pollfd pollFd = { _fileDescriptor, POLLIN, 0 };
+
+    while (true)
+    {
+        auto now = steady_clock::now();
+        int timeoutMs = (deadline > now) ? (int)ceil<milliseconds>(deadline - now).count() : 0;
+
+        int result = poll(&pollFd, 1, timeoutMs);
+        if (result > 0)
+        {
+            if (pollFd.revents & (POLLERR | POLLNVAL))
+                return Fail(EK_IO_ERROR);
+
+            return {};
+        }
+
+        if (result == 0)
+            return Fail(EK_TIMEOUT);
+
+        if (errno != EINTR)
+            return Fail(EK_IO_ERROR);
+    }
+}
+
+size_t SerialPort::ReceiveData(const time_point_type & deadline)
+{
+    auto result = TryReceiveData(deadline);
+    if (!result)
+    {
+        if (result.GetErrorKind() == EK_TIMEOUT)
+            return 0;
+
+        ThrowError(result.GetErrorKind(), "can not receive data from");
+    }
+
+    return *result;
+}
+
+Result<size_t> SerialPort::TryReceiveData(const time_point_type & deadline)
+{
+    auto waitResult = TryWaitForData(deadline);
+    if (!waitResult)
+        return Failure(waitResult.GetErrorKind());
+
+    span<uint8_t> first, second;
+    _receiveBuffer.GetWritableSegments(first, second);
+
+    if (first.empty())
+        return Fail(EK_BUFFER_OVERFLOW);
+
+    iovec ioVectors[2] = {
+        { first.data(), first.size() },
+        { second.data(), second.size() }
+    };
+
+    auto bytesRead = readv(_fileDescriptor, ioVectors, second.empty() ? 1 : 2);
     if (bytesRead < 0)
     {
-        throw Error(format("can not read data from port {}: error {} {}",
-            _serialPortName, errno, strerror(errno)));
+        if ((errno == EINTR) || (errno == EAGAIN))
+            return (size_t)0;
+
+        return Fail(EK_IO_ERROR);
     }
 
-    return bytesRead;
+    _receiveBuffer.Commit(bytesRead);
+
+    return (size_t)bytesRead;
 }
 
 int SerialPort::GetNumberOfBytesAvailable() const
@@ -287,10 +411,12 @@ int SerialPort::GetNumberOfBytesAvailable() const
     return numberOfBytesAvailable;
 }
 
-void SerialPort::ClearInputBuffer() const
+void SerialPort::ClearInputBuffer()
 {
     AssertPortIsOpen();
 
+    _receiveBuffer.Clear();
+
     int result = tcflush(_fileDescriptor, TCIFLUSH);
     if (result == -1)
     {
@@ -29,10 +29,20 @@ IN THE SOFTWARE.
 #include <cstdint>
 #include <stdexcept>
 #include <format>
+#include <chrono>
+
+#include "RingBuffer.h"
+#include "Result.h"
+#include "ErrorCounters.h"
 
 class SerialPort
 {
 public:
+    typedef std::chrono::steady_clock::time_point time_point_type;
+
+    /// @brief Size of the receive buffer in bytes.
+    constexpr static size_t RECEIVE_BUFFER_SIZE = 4096;
+
     /// @brief Parity options for serial port configuration
     enum Parity { P_NONE, P_EVEN, P_ODD };
 
@@ -43,7 +53,7 @@ public:
         Error(const std::string & errorMessage) : std::runtime_error(std::format("Serial port error: {}", errorMessage)) { }
     };
 
-    /// @brief Database error.
+    /// @brief Timeout error.
     class Timeout : public Error
     {
     public:
@@ -114,17 +124,71 @@ public:
     /// @param length The number of bytes to read.
     /// @return The number of bytes actually read. (May be less than length or 0 if no data is available.)
     size_t ReadDataNonBlocking(void * data, size_t length) const;
+
+    /// @brief Reads data from the serial port in blocking mode. Does not throw exceptions.
+    /// @param data The buffer to read data into.
+    /// @param length The number of bytes to read.
+    /// @return The number of bytes read (exactly length bytes) or EK_TIMEOUT, EK_IO_ERROR, EK_NOT_OPEN.
+    Result<size_t> TryReadDataBlocking(void * data, size_t length) const;
+
+    /// @brief Reads data from the serial port in non-blocking mode. Does not throw exceptions.
+    /// @param data The buffer to read data into.
+    /// @param length The number of bytes to read.
+    /// @return The number of bytes read (may be 0) or EK_IO_ERROR, EK_NOT_OPEN.
+    Result<size_t> TryReadDataNonBlocking(void * data, size_t length) const;
     
+    /// @brief Waits until data is available or the deadline is reached. No exception is thrown on timeout.
+    /// @param deadline The point in time when waiting is stopped.
+    /// @return True if data is available, false if the deadline was reached.
+    bool WaitForData(const time_point_type & deadline) const;
+
+    /// @brief Waits until data is available or the deadline is reached. Does not throw exceptions.
+    /// @param deadline The point in time when waiting is stopped.
+    /// @return Success if data is available or EK_TIMEOUT, EK_IO_ERROR, EK_NOT_OPEN.
+    Result<void> TryWaitForData(const time_point_type & deadline) const;
+
+    /// @brief Waits until data is available or the deadline is reached and then reads all available data
+    /// with a single read call into the receive buffer. No exception is thrown on timeout.
+    /// @param deadline The point in time when waiting is stopped.
+    /// @return The number of bytes received. (0 if the deadline was reached.)
+    size_t ReceiveData(const time_point_type & deadline);
+
+    /// @brief Waits until data is available or the deadline is reached and then reads all available data
+    /// with a single read call into the receive buffer. Does not throw exceptions.
+    /// @param deadline The point in time when waiting is stopped.
+    /// @return The number of bytes received or EK_TIMEOUT, EK_IO_ERROR, EK_BUFFER_OVERFLOW, EK_NOT_OPEN.
+    Result<size_t> TryReceiveData(const time_point_type & deadline);
+
+    /// @brief Returns the receive buffer filled by ReceiveData(). The caller consumes the data from the buffer.
+    /// @return The receive buffer.
+    RingBuffer & GetReceiveBuffer() { return _receiveBuffer; }
+
     /// @brief Queries the number of bytes available in the receive buffer.
     /// @return The number of bytes available in the receive buffer.
     int GetNumberOfBytesAvailable() const;
     
-    /// @brief Discards all data that is in the input buffer.
-    void ClearInputBuffer() const;
+    /// @brief Discards all data that is in the input buffer and in the receive buffer.
+    void ClearInputBuffer();
+
+    /// @brief Returns the counters of the errors reported by the "Try..." functions.
+    /// @return The error counters.
+    const ErrorCounters & GetErrorCounters() const { return _errorCounters; }
 
 private:
     int _fileDescriptor = -1;
     std::string _serialPortName;
+    RingBuffer _receiveBuffer;
+    mutable ErrorCounters _errorCounters;
+
+    /// @brief Counts an error and returns it as failure.
+    /// @param errorKind The error kind.
+    /// @return The failure.
+    Failure Fail(ErrorKind errorKind) const { _errorCounters.Count(errorKind); return Failure(errorKind); }
+
+    /// @brief Throws an exception for a failed result of a "Try..." function.
+    /// @param errorKind The error kind.
+    /// @param operation Description of the failed operation.
+    [[noreturn]] void ThrowError(ErrorKind errorKind, const std::string & operation) const;
 
     /// @brief Asserts that the serial port is open.
     void AssertPortIsOpen() const;
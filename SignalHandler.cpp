@@ -0,0 +1,98 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "SignalHandler.h"
+#include "Logger.h"
+
+#include <sys/signalfd.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+using namespace std;
+
+SignalHandler::SignalHandler(CancellationToken & cancellationToken)
+: _cancellationToken(cancellationToken)
+{
+    sigset_t signalSet;
+    sigemptyset(&signalSet);
+    sigaddset(&signalSet, SIGTERM);
+    sigaddset(&signalSet, SIGINT);
+
+    // the signals are not delivered to a thread but to the signalfd
+    int error = pthread_sigmask(SIG_BLOCK, &signalSet, nullptr);
+    if (error != 0)
+        throw Error(format("can not block signals: error {} {}", error, strerror(error)));
+
+    _signalFd = signalfd(-1, &signalSet, SFD_CLOEXEC);
+    if (_signalFd < 0)
+        throw Error(format("can not create signalfd: error {} {}", errno, strerror(errno)));
+
+    _thread = thread([this] { ReceiveSignals(); });
+}
+
+SignalHandler::~SignalHandler()
+{
+    _stopReceiving.Cancel();
+    _thread.join();
+
+    close(_signalFd);
+}
+
+void SignalHandler::ReceiveSignals()
+{
+    while (!_stopReceiving.IsCancel())
+    {
+        pollfd pollFds[2] = {
+            { _signalFd, POLLIN, 0 },
+            { _stopReceiving.GetEventFd(), POLLIN, 0 } };
+
+        if (poll(pollFds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            LOG_ERROR(format("SignalHandler: poll failed with error {} {}", errno, strerror(errno)));
+            return;
+        }
+
+        if (!(pollFds[0].revents & POLLIN))
+            continue;
+
+        signalfd_siginfo signalInfo;
+        if (read(_signalFd, &signalInfo, sizeof(signalInfo)) != sizeof(signalInfo))
+            continue;
+
+        if (_cancellationToken.IsCancel())
+        {
+            LOG_INFO(format("Received signal {} ({}), already stopping", signalInfo.ssi_signo, strsignal(signalInfo.ssi_signo)));
+            continue;
+        }
+
+        LOG_INFO(format("Received signal {} ({}), stopping", signalInfo.ssi_signo, strsignal(signalInfo.ssi_signo)));
+        _cancellationToken.Cancel();
+    }
+}
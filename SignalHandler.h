@@ -0,0 +1,66 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "CancellationToken.h"
+
+#include <thread>
+#include <stdexcept>
+#include <format>
+#include <string>
+
+/// @brief Cancels a token when the process receives SIGTERM or SIGINT, so the program can stop gracefully
+/// (e.g. the pending samples are stored) instead of being killed.
+/// The signals are blocked and received by a thread with a signalfd. The signal handler must be created
+/// before any other thread, so all threads inherit the blocked signals.
+class SignalHandler
+{
+public:
+    /// @brief Signal handler error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("Signal handler error: {}", errorMessage)) { }
+    };
+
+    /// @brief Constructor. Starts receiving the signals.
+    /// @param cancellationToken The token that is cancelled when a signal is received.
+    SignalHandler(CancellationToken & cancellationToken);
+    ~SignalHandler();
+
+    SignalHandler(const SignalHandler &) = delete;
+    SignalHandler & operator=(const SignalHandler &) = delete;
+
+private:
+    CancellationToken & _cancellationToken;
+    int _signalFd;
+
+    // stops the thread that receives the signals
+    CancellationToken _stopReceiving;
+    std::thread _thread;
+
+    /// @brief Receives the signals until the handler is destroyed.
+    void ReceiveSignals();
+};
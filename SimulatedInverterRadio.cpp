@@ -0,0 +1,351 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "SimulatedInverterRadio.h"
+
+#include "HoymilesHmDtu.h"
+#include "Checksum.h"
+#include "Utils.h"
+
+#include <thread>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace std::chrono;
+using namespace Utils;
+
+SimulatedInverterRadio::SimulatedInverterRadio(const Parameters & parameters)
+    : _parameters(parameters)
+    , _responseRxChannels { 0, 0, 0 }
+    , _randomEngine(parameters.Seed)
+    , _randomProbability(0.0, 1.0)
+    , _randomPower(300.0, 20.0)
+{
+    // throws if the number of channels is invalid
+    HoymilesHmDtu::GetInfoResponseDataSize(_parameters.NumberOfChannels);
+
+    _transmissions.reserve(64);
+    _interruptTimestampsNs.reserve(64);
+}
+
+void SimulatedInverterRadio::Initialize(std::span<const uint8_t> writingPipeAddress, std::span<const uint8_t> readingPipeAddress)
+{
+    if ((writingPipeAddress.size() != 5) || (readingPipeAddress.size() != 5))
+        throw Error("Initialize: the pipe addresses must have 5 bytes.");
+
+    // the inverter listens on the writing pipe address of the DTU
+    _inverterAddress.assign(writingPipeAddress.begin() + 1, writingPipeAddress.end());
+
+    _transmissions.clear();
+    _rxFifoSize = 0;
+    _interruptTimestampsNs.clear();
+    _isListening = false;
+    _isInitialized = true;
+}
+
+void SimulatedInverterRadio::Terminate()
+{
+    _isInitialized = false;
+}
+
+std::string SimulatedInverterRadio::GetDetails()
+{
+    return format("Simulated inverter: {} channels, packet loss {}, duplication {}, latency {} ms, packet gap {} ms, seed {}, IRQ {}",
+        _parameters.NumberOfChannels, _parameters.PacketLossProbability, _parameters.PacketDuplicationProbability,
+        _parameters.ResponseLatencyMs, _parameters.PacketGapMs, _parameters.Seed, _parameters.HasReceiveInterrupt);
+}
+
+void SimulatedInverterRadio::SetPowerLevel(RadioPowerLevel)
+{
+}
+
+void SimulatedInverterRadio::SetChannel(int channel)
+{
+    Update();
+    _channel = channel;
+}
+
+void SimulatedInverterRadio::StartListening()
+{
+    Update();
+    _isListening = true;
+}
+
+void SimulatedInverterRadio::StopListening()
+{
+    Update();
+    _isListening = false;
+}
+
+void SimulatedInverterRadio::FlushRx()
+{
+    Update();
+    _rxFifoSize = 0;
+}
+
+void SimulatedInverterRadio::FlushTx()
+{
+}
+
+bool SimulatedInverterRadio::Write(std::span<const uint8_t> packet)
+{
+    Update();
+
+    if (_isListening)
+        throw Error("Write: the radio is in receive mode.");
+
+    // the request was lost, there is no acknowledge
+    if (_randomProbability(_randomEngine) < _parameters.PacketLossProbability)
+        return false;
+
+    RadioPacket unescapedPacket;
+    if (!HoymilesHmDtu::TryUnescapeData(unescapedPacket, packet))
+        return true;
+
+    EvaluateRequest(unescapedPacket);
+
+    return true;
+}
+
+bool SimulatedInverterRadio::IsPacketAvailable()
+{
+    Update();
+    return _rxFifoSize > 0;
+}
+
+bool SimulatedInverterRadio::ReadPacket(RadioPacket & packet)
+{
+    Update();
+
+    if (_rxFifoSize == 0)
+        return false;
+
+    packet = _rxFifo[_rxFifoReadIdx];
+    _rxFifoReadIdx = (_rxFifoReadIdx + 1) % RX_FIFO_SIZE;
+    _rxFifoSize--;
+
+    return true;
+}
+
+bool SimulatedInverterRadio::IsCarrierDetected()
+{
+    Update();
+
+    if (_rxFifoSize > 0)
+        return true;
+
+    // is the inverter sending on this channel right now?
+    auto now = clock_type::now();
+    for (const auto & transmission : _transmissions)
+    {
+        if ((transmission.Channel == _channel) && (transmission.Time - now < milliseconds(1)))
+            return true;
+    }
+
+    return false;
+}
+
+void SimulatedInverterRadio::ClearReceiveInterrupts()
+{
+    Update();
+    _interruptTimestampsNs.clear();
+}
+
+bool SimulatedInverterRadio::WaitForReceiveInterrupt(double timeoutSeconds)
+{
+    auto endTime = clock_type::now() + duration_cast<clock_type::duration>(duration<double>(timeoutSeconds));
+
+    while (true)
+    {
+        Update();
+
+        if (!_interruptTimestampsNs.empty())
+            return true;
+
+        auto now = clock_type::now();
+        if (now >= endTime)
+            return false;
+
+        // sleep until the next transmission or the timeout
+        auto wakeUpTime = endTime;
+        if (!_transmissions.empty())
+            wakeUpTime = min(wakeUpTime, _transmissions.front().Time);
+
+        this_thread::sleep_until(wakeUpTime);
+    }
+}
+
+void SimulatedInverterRadio::AcknowledgeReceiveInterrupts(std::vector <uint64_t> & timestampsNs)
+{
+    Update();
+
+    timestampsNs.assign(_interruptTimestampsNs.begin(), _interruptTimestampsNs.end());
+    _interruptTimestampsNs.clear();
+}
+
+void SimulatedInverterRadio::Update()
+{
+    auto now = clock_type::now();
+
+    // the transmissions are sorted by time
+    size_t numberOfDueTransmissions = 0;
+
+    for (const auto & transmission : _transmissions)
+    {
+        if (transmission.Time > now)
+            break;
+
+        numberOfDueTransmissions++;
+
+        // received only if the radio listens on the channel and the FIFO is not full
+        if (!_isListening || (transmission.Channel != _channel) || (_rxFifoSize >= RX_FIFO_SIZE))
+            continue;
+
+        _rxFifo[(_rxFifoReadIdx + _rxFifoSize) % RX_FIFO_SIZE] = transmission.Packet;
+        _rxFifoSize++;
+
+        _interruptTimestampsNs.push_back(duration_cast<nanoseconds>(transmission.Time.time_since_epoch()).count());
+        _statistics.PacketsReceived++;
+    }
+
+    _transmissions.erase(_transmissions.begin(), _transmissions.begin() + numberOfDueTransmissions);
+}
+
+void SimulatedInverterRadio::EvaluateRequest(const RadioPacket & packet)
+{
+    // header (10 bytes) and checksum
+    if (packet.size() < 11)
+        return;
+
+    // is the request for this inverter and valid?
+    if ((packet[0] != 0x15) || !equal(_inverterAddress.begin(), _inverterAddress.end(), packet.begin() + 1))
+        return;
+
+    uint8_t checksum = Checksum::CalculateCrc8Hoymiles(span(packet.begin(), packet.end() - 1));
+    if (checksum != packet[packet.size() - 1])
+        return;
+
+    // the inverter listens only on the TX channels
+    const auto & txChannels = HoymilesHmDtu::TX_CHANNELS;
+    if (find(txChannels.begin(), txChannels.end(), _channel) == txChannels.end())
+        return;
+
+    int frame = packet[9];
+    auto startTime = clock_type::now() + duration_cast<clock_type::duration>(duration<double, milli>(_parameters.ResponseLatencyMs));
+    auto packetGap = duration_cast<clock_type::duration>(duration<double, milli>(_parameters.PacketGapMs));
+
+    if ((frame == 0x80) && (packet.size() > 11) && (packet[10] == 0x0B))
+    {
+        // info request: send all fragments
+        _statistics.InfoRequests++;
+
+        _responseRxChannels = HoymilesHmDtu::GetRxChannelList(_channel);
+        CreateResponseData();
+
+        _transmissions.clear();
+        for (int frameNumber = 1; frameNumber <= GetNumberOfFrames(); frameNumber++)
+            ScheduleFragment(frameNumber, startTime + (frameNumber - 1) * packetGap, frameNumber - 1);
+    }
+    else if (((frame & 0x80) != 0) && (packet.size() == 11) && !_responseData.empty())
+    {
+        // retransmit request: send the requested fragment
+        _statistics.RetransmitRequests++;
+
+        int frameNumber = frame & 0x7F;
+        if ((frameNumber >= 1) && (frameNumber <= GetNumberOfFrames()))
+            ScheduleFragment(frameNumber, startTime, 0);
+    }
+}
+
+void SimulatedInverterRadio::CreateResponseData()
+{
+    size_t dataSize = HoymilesHmDtu::GetInfoResponseDataSize(_parameters.NumberOfChannels);
+
+    // the DC readings are simple patterns, the AC readings are the last 16 bytes before the checksum
+    _responseData.assign(dataSize - 2, 0);
+    for (size_t idx = 2; idx < dataSize - 2 - 16; idx += 2)
+        _responseData[idx + 1] = (uint8_t)(idx * 3);
+
+    double power = max(_randomPower(_randomEngine), 0.0);
+    double voltage = 230.0;
+
+    const array<uint16_t, 8> acReadings = {
+        (uint16_t)(voltage * 10.0),                         // voltage in 0.1 V
+        5000,                                               // frequency in 0.01 Hz
+        (uint16_t)lround(power * 10.0),                     // power in 0.1 W
+        0,                                                  // reactive power in 0.1 var
+        (uint16_t)lround(power / voltage * 100.0),          // current in 0.01 A
+        1000,                                               // power factor in 0.001
+        350,                                                // temperature in 0.1 °C
+        0 };                                                // EVT
+
+    size_t pos = dataSize - 2 - 16;
+    for (uint16_t value : acReadings)
+    {
+        _responseData[pos++] = (uint8_t)(value >> 8);
+        _responseData[pos++] = (uint8_t)(value >> 0);
+    }
+
+    uint16_t crc = Checksum::CalculateCrc16Modbus(_responseData);
+    UInt16ToBytes(_responseData, crc, true);
+}
+
+void SimulatedInverterRadio::ScheduleFragment(int frameNumber, clock_type::time_point time, int hopIdx)
+{
+    int numberOfFrames = GetNumberOfFrames();
+    size_t fragmentSize = (_responseData.size() + numberOfFrames - 1) / numberOfFrames;
+    size_t fragmentPos = (frameNumber - 1) * fragmentSize;
+    size_t fragmentEnd = min(fragmentPos + fragmentSize, _responseData.size());
+
+    RadioPacket unescapedPacket;
+    unescapedPacket.PushBack(0x95);
+    unescapedPacket.Append(_inverterAddress);
+    unescapedPacket.Append(_inverterAddress);
+    unescapedPacket.PushBack((uint8_t)((frameNumber == numberOfFrames) ? (0x80 | frameNumber) : frameNumber));
+    unescapedPacket.Append(span(_responseData).subspan(fragmentPos, fragmentEnd - fragmentPos));
+    unescapedPacket.PushBack(Checksum::CalculateCrc8Hoymiles(unescapedPacket));
+
+    Transmission transmission;
+    HoymilesHmDtu::EscapeData(transmission.Packet, unescapedPacket);
+
+    // the packet may be sent twice (on the next channel), each transmission may be lost
+    int numberOfTransmissions = (_randomProbability(_randomEngine) < _parameters.PacketDuplicationProbability) ? 2 : 1;
+    auto packetGap = duration_cast<clock_type::duration>(duration<double, milli>(_parameters.PacketGapMs));
+
+    for (int idx = 0; idx < numberOfTransmissions; idx++)
+    {
+        _statistics.PacketsSent++;
+
+        if (_randomProbability(_randomEngine) < _parameters.PacketLossProbability)
+            continue;
+
+        transmission.Time = time + idx * packetGap / 2;
+        transmission.Channel = _responseRxChannels[(hopIdx + idx) % _responseRxChannels.size()];
+
+        auto insertPos = upper_bound(_transmissions.begin(), _transmissions.end(), transmission.Time,
+            [](clock_type::time_point time, const Transmission & other) { return time < other.Time; });
+        _transmissions.insert(insertPos, transmission);
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "Radio.h"
+
+#include <vector>
+#include <array>
+#include <chrono>
+#include <random>
+#include <format>
+#include <stdexcept>
+
+/// @brief A radio that simulates a Hoymiles HM inverter, so the protocol, timing and retry strategies can be
+/// run and benchmarked without nRF24L01 module and inverter. The simulated inverter answers info requests (0x15/0x0B)
+/// and retransmit requests with escaped fragments with valid checksums on the receive channels of the hop pattern.
+/// Packet loss, duplication and latency can be configured, the random numbers are reproducible by the seed.
+class SimulatedInverterRadio : public Radio
+{
+public:
+    /// @brief Simulated inverter radio error.
+    class Error : public std::runtime_error
+    {
+    public:
+        Error(const std::string & errorMessage) : std::runtime_error(std::format("Simulated inverter radio error: {}", errorMessage)) { }
+    };
+
+    /// @brief The parameters of the simulation.
+    struct Parameters
+    {
+        // number of inverter channels: 1, 2 or 4
+        int NumberOfChannels = 2;
+
+        // probability that a packet (request or response) is lost
+        double PacketLossProbability = 0.0;
+
+        // probability that a response packet is sent twice (the second time on the next receive channel)
+        double PacketDuplicationProbability = 0.0;
+
+        // time from the request to the first response packet (in ms)
+        double ResponseLatencyMs = 5.0;
+
+        // time between two response packets (in ms)
+        double PacketGapMs = 3.0;
+
+        // seed of the random number generator
+        uint32_t Seed = 1;
+
+        // true if the simulation signals received packets by interrupt (like the nRF24L01 with connected IRQ pin)
+        bool HasReceiveInterrupt = true;
+    };
+
+    /// @brief Statistics of the simulation.
+    struct Statistics
+    {
+        uint64_t InfoRequests = 0;
+        uint64_t RetransmitRequests = 0;
+        uint64_t PacketsSent = 0;
+        uint64_t PacketsReceived = 0;
+    };
+
+    /// @brief Constructor.
+    /// @param parameters The parameters of the simulation.
+    SimulatedInverterRadio(const Parameters & parameters);
+
+    SimulatedInverterRadio(const SimulatedInverterRadio &) = delete;
+    SimulatedInverterRadio & operator=(const SimulatedInverterRadio &) = delete;
+
+    void Initialize(std::span<const uint8_t> writingPipeAddress, std::span<const uint8_t> readingPipeAddress) override;
+    void Terminate() override;
+    bool IsInitialized() const override { return _isInitialized; }
+    std::string GetDetails() override;
+
+    void SetPowerLevel(RadioPowerLevel powerLevel) override;
+    void SetChannel(int channel) override;
+    void StartListening() override;
+    void StopListening() override;
+    void FlushRx() override;
+    void FlushTx() override;
+
+    bool Write(std::span<const uint8_t> packet) override;
+    bool IsPacketAvailable() override;
+    bool ReadPacket(RadioPacket & packet) override;
+    bool IsCarrierDetected() override;
+
+    bool HasReceiveInterrupt() const override { return _parameters.HasReceiveInterrupt; }
+    void ClearReceiveInterrupts() override;
+    bool WaitForReceiveInterrupt(double timeoutSeconds) override;
+    void AcknowledgeReceiveInterrupts(std::vector <uint64_t> & timestampsNs) override;
+
+    /// @brief Returns the statistics of the simulation.
+    /// @return The statistics.
+    const Statistics & GetStatistics() const { return _statistics; }
+
+private:
+    typedef std::chrono::steady_clock clock_type;
+
+    // the receive FIFO of the nRF24L01 has 3 levels
+    constexpr static size_t RX_FIFO_SIZE = 3;
+
+    /// @brief A packet sent by the simulated inverter.
+    struct Transmission
+    {
+        clock_type::time_point Time;
+        int Channel;
+        RadioPacket Packet;
+    };
+
+    Parameters _parameters;
+    Statistics _statistics;
+
+    bool _isInitialized = false;
+    bool _isListening = false;
+    int _channel = 0;
+
+    std::vector <uint8_t> _inverterAddress;
+
+    // the packets sent by the inverter that are not received yet, sorted by time
+    std::vector <Transmission> _transmissions;
+
+    std::array <RadioPacket, RX_FIFO_SIZE> _rxFifo;
+    size_t _rxFifoReadIdx = 0;
+    size_t _rxFifoSize = 0;
+
+    std::vector <uint64_t> _interruptTimestampsNs;
+
+    // the data of the last response (for retransmit requests)
+    std::vector <uint8_t> _responseData;
+    std::array <int, 3> _responseRxChannels;
+
+    std::minstd_rand _randomEngine;
+    std::uniform_real_distribution<double> _randomProbability;
+    std::normal_distribution<double> _randomPower;
+
+    /// @brief Moves the transmissions that are due to the receive FIFO, if the radio listens on their channel.
+    void Update();
+
+    /// @brief Evaluates a request and schedules the response.
+    /// @param packet The request (unescaped).
+    void EvaluateRequest(const RadioPacket & packet);
+
+    /// @brief Creates the response data with the current readings.
+    void CreateResponseData();
+
+    /// @brief Schedules a fragment of the response data.
+    /// @param frameNumber The frame number (1 ... number of frames).
+    /// @param time The time when the fragment is sent.
+    /// @param hopIdx Index of the receive channel in the hop pattern.
+    void ScheduleFragment(int frameNumber, clock_type::time_point time, int hopIdx);
+
+    /// @brief Returns the number of response frames.
+    /// @return The number of frames.
+    int GetNumberOfFrames() const { return _parameters.NumberOfChannels + 1; }
+};
@@ -23,6 +23,7 @@ IN THE SOFTWARE.
 */
 
 #include "SmlDecoder.h"
+#include "Checksum.h"
 
 #include <format>
 #include <stdexcept>
@@ -31,40 +32,6 @@ IN THE SOFTWARE.
 
 using namespace std;
 
-static const uint16_t CRC16_X25_TABLE[] = {
-    0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD,	0x6536, 0x74BF,
-    0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
-    0x1081, 0x0108,	0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E,
-    0x9CC9, 0x8D40, 0xBFDB, 0xAE52, 0xDAED, 0xCB64,	0xF9FF, 0xE876,
-    0x2102, 0x308B, 0x0210, 0x1399,	0x6726, 0x76AF, 0x4434, 0x55BD,
-    0xAD4A, 0xBCC3,	0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5,
-    0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E,	0x54B5, 0x453C,
-    0xBDCB, 0xAC42, 0x9ED9, 0x8F50,	0xFBEF, 0xEA66, 0xD8FD, 0xC974,
-    0x4204, 0x538D,	0x6116, 0x709F, 0x0420, 0x15A9, 0x2732, 0x36BB,
-    0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1,	0xAB7A, 0xBAF3,
-    0x5285, 0x430C, 0x7197, 0x601E,	0x14A1, 0x0528, 0x37B3, 0x263A,
-    0xDECD, 0xCF44,	0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72,
-    0x6306, 0x728F, 0x4014, 0x519D, 0x2522, 0x34AB,	0x0630, 0x17B9,
-    0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5,	0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
-    0x7387, 0x620E,	0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738,
-    0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862,	0x9AF9, 0x8B70,
-    0x8408, 0x9581, 0xA71A, 0xB693,	0xC22C, 0xD3A5, 0xE13E, 0xF0B7,
-    0x0840, 0x19C9,	0x2B52, 0x3ADB, 0x4E64, 0x5FED, 0x6D76, 0x7CFF,
-    0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324,	0xF1BF, 0xE036,
-    0x18C1, 0x0948, 0x3BD3, 0x2A5A,	0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E,
-    0xA50A, 0xB483,	0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
-    0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF,	0x4C74, 0x5DFD,
-    0xB58B, 0xA402, 0x9699, 0x8710,	0xF3AF, 0xE226, 0xD0BD, 0xC134,
-    0x39C3, 0x284A,	0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C,
-    0xC60C, 0xD785, 0xE51E, 0xF497, 0x8028, 0x91A1,	0xA33A, 0xB2B3,
-    0x4A44, 0x5BCD, 0x6956, 0x78DF,	0x0C60, 0x1DE9, 0x2F72, 0x3EFB,
-    0xD68D, 0xC704,	0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232,
-    0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68,	0x3FF3, 0x2E7A,
-    0xE70E, 0xF687, 0xC41C, 0xD595,	0xA12A, 0xB0A3, 0x8238, 0x93B1,
-    0x6B46, 0x7ACF,	0x4854, 0x59DD, 0x2D62, 0x3CEB, 0x0E70, 0x1FF9,
-    0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022,	0x92B9, 0x8330,
-    0x7BC7, 0x6A4E, 0x58D5, 0x495C,	0x3DE3, 0x2C6A, 0x1EF1, 0x0F78 };
-
 static const SmlData::byte_array_type ESCAPE_SEQUENCE = { 0x1B, 0x1B, 0x1B, 0x1B };
 
 static const SmlData::byte_array_type SML_START = { 0x01, 0x01, 0x01, 0x01 };
@@ -73,17 +40,9 @@ static const SmlData::byte_array_type SML_START = { 0x01, 0x01, 0x01, 0x01 };
 /// @param data The byte array on which the ckecksum is to be calculated.
 /// @param dataLen Number of bytes to be used to calculate the checksum.
 /// @return The CRC16 checksum of the byte array.
-static uint16_t CalculateSmlCrc16(const SmlData::byte_array_type & data, int dataLen)
+static uint16_t CalculateSmlCrc16(std::span<const uint8_t> data, int dataLen)
 {
-    uint16_t crcsum = 0xFFFF;
-
-    for (int idx = 0; idx < dataLen; idx++)
-    {
-        crcsum = CRC16_X25_TABLE[(data[idx] ^ crcsum) & 0xff] ^ (crcsum >> 8 & 0xff);
-    }
-
-    crcsum ^= 0xffff;
-    return crcsum;
+    return Checksum::CalculateCrc16X25(data.first(dataLen));
 }
 
 /// @brief Decodes an unsigned integer from the byte array (big endian).
@@ -91,7 +50,7 @@ static uint16_t CalculateSmlCrc16(const SmlData::byte_array_type & data, int dat
 /// @param position The position to start decoding.
 /// @param length The number of bytes to decode (1 .. 8).
 /// @return The decoded unsigned integer.
-static uint64_t DecodeUnsignedBigEndian(const SmlData::byte_array_type & data, int position, int length)
+static uint64_t DecodeUnsignedBigEndian(std::span<const uint8_t> data, int position, int length)
 {
     if ((length < 1) || (length > 8))
         throw SmlData::Error(format("DecodeUnsigned: length {} is out of range (1 .. 8).", length));
@@ -112,7 +71,7 @@ static uint64_t DecodeUnsignedBigEndian(const SmlData::byte_array_type & data, i
 /// @param position The position to start decoding.
 /// @param length The number of bytes to decode (1 .. 8).
 /// @return The decoded signed integer.
-static int64_t DecodeIntegerBigEndian(const SmlData::byte_array_type & data, int position, int length)
+static int64_t DecodeIntegerBigEndian(std::span<const uint8_t> data, int position, int length)
 {
     if ((length < 1) || (length > 8))
         throw SmlData::Error(format("DecodeInteger: length {} is out of range (1 .. 8).", length));
@@ -134,7 +93,7 @@ static int64_t DecodeIntegerBigEndian(const SmlData::byte_array_type & data, int
 /// @param position The position to start decoding.
 /// @param length The number of bytes to decode (1 .. 8).
 /// @return The decoded unsigned integer.
-static uint16_t DecodeUnsigned16LittleEndian(const SmlData::byte_array_type & data, int position)
+static uint16_t DecodeUnsigned16LittleEndian(std::span<const uint8_t> data, int position)
 {
     uint16_t value = data[position + 1];
     value <<= 8;
@@ -233,7 +192,7 @@ void SmlData::PrintValue(std::ostream & os, int indent) const
     }
 }
 
-void SmlData::DecodeTypeLengthField(const byte_array_type & data, int position,
+bool SmlData::DecodeTypeLengthField(std::span<const uint8_t> data, int position,
         int & tlFieldSize, DataType & dataType, int & dataLen)
 {
     tlFieldSize = 1;
@@ -246,11 +205,17 @@ void SmlData::DecodeTypeLengthField(const byte_array_type & data, int position,
     {
         position += 1;
         tlFieldSize += 1;
+
+        if (position >= (int)data.size())
+            return false;
+
         tlField = data[position];
 
         dataLen <<= 4;
         dataLen |= tlField & 0x0F;
     }
+
+    return true;
 }
 
 SmlData SmlData::DecodeValue(const byte_array_type & data, int position,
@@ -259,7 +224,8 @@ SmlData SmlData::DecodeValue(const byte_array_type & data, int position,
     int tlFieldSize, dataLen;
     DataType dataType;
 
-    DecodeTypeLengthField(data, position, tlFieldSize, dataType, dataLen);
+    if (!DecodeTypeLengthField(data, position, tlFieldSize, dataType, dataLen))
+        throw Error(format("Type length field exceeds the data at position {}", position));
 
     int valueStartPos = position + tlFieldSize;
     valueEndPos = position + dataLen;
@@ -312,36 +278,67 @@ SmlData SmlData::DecodeValue(const byte_array_type & data, int position,
     return value;
 }
 
-SmlData::list_type DecodeSmlMessages(const SmlData::byte_array_type & data)
+/// @brief Checks the escape sequences and the checksum of the SML frame. Does not throw exceptions.
+/// @param data The raw byte data of the SML messages.
+/// @param checkChecksum False if the checksum was already checked.
+/// @return The position after the last message body or EK_INVALID_FRAME, EK_CHECKSUM_ERROR.
+static Result<size_t> TryCheckSmlFrame(std::span<const uint8_t> data, bool checkChecksum)
 {
+    size_t count = data.size();
+
+    if (count < 16)
+        return Failure(EK_INVALID_FRAME);
+
     // check for escape sequence
     if (!equal(ESCAPE_SEQUENCE.begin(), ESCAPE_SEQUENCE.end(), data.begin()))
-        throw SmlData::Error("DecodeSmlMessages: missing escape sequence at position 0");
+        return Failure(EK_INVALID_FRAME);
 
     // check version
     if (!equal(SML_START.begin(), SML_START.end(), data.begin() + 4))
-        throw SmlData::Error("DecodeSmlMessages: missing SML start sequence at position 4");
+        return Failure(EK_INVALID_FRAME);
 
     // check for second escape sequence
-    size_t count = data.size();
-
     if (!equal(ESCAPE_SEQUENCE.begin(), ESCAPE_SEQUENCE.end(), data.begin() + count - 8))
-        throw SmlData::Error(format("DecodeSmlMessages: missing second escape sequence at position {}", count - 8));
+        return Failure(EK_INVALID_FRAME);
 
     if (data[count - 4] != 0x1A)
-        throw SmlData::Error(format("DecodeSmlMessages: missing 0x1A at position {}", count - 4));
+        return Failure(EK_INVALID_FRAME);
 
     // get number of fill bytes
-    int numberOfFillBytes = data[count - 3];
-    int lastMsgBodyIndex = count - 8 - numberOfFillBytes;
+    size_t numberOfFillBytes = data[count - 3];
+    if (numberOfFillBytes > count - 16)
+        return Failure(EK_INVALID_FRAME);
 
     // check checksum
-    uint16_t checkSum1 = DecodeUnsigned16LittleEndian(data, count - 2);
-    uint16_t checkSum2 = CalculateSmlCrc16(data, count - 2);
+    if (checkChecksum)
+    {
+        uint16_t checkSum1 = DecodeUnsigned16LittleEndian(data, count - 2);
+        uint16_t checkSum2 = CalculateSmlCrc16(data, count - 2);
+
+        if (checkSum1 != checkSum2)
+            return Failure(EK_CHECKSUM_ERROR);
+    }
+
+    return count - 8 - numberOfFillBytes;
+}
+
+/// @brief Checks the escape sequences and the checksum of the SML frame.
+/// @param data The raw byte data of the SML messages.
+/// @param checkChecksum False if the checksum was already checked.
+/// @return The position after the last message body.
+static size_t CheckSmlFrame(std::span<const uint8_t> data, bool checkChecksum = true)
+{
+    auto result = TryCheckSmlFrame(data, checkChecksum);
+    if (!result)
+        throw SmlData::Error(format("DecodeSmlMessages: {} ({} bytes)", GetErrorKindName(result.GetErrorKind()), data.size()));
+
+    return *result;
+}
+
+SmlData::list_type DecodeSmlMessages(const SmlData::byte_array_type & data)
+{
+    int lastMsgBodyIndex = (int)CheckSmlFrame(data);
 
-    if (checkSum1 != checkSum2)
-        throw SmlData::Error(format("DecodeSmlMessages: Checksum error: found {:04X} calculated {:04X}", checkSum1, checkSum2));
-    
     SmlData::list_type messageList;
     int position = 8;
 
@@ -359,4 +356,419 @@ SmlData::list_type DecodeSmlMessages(const SmlData::byte_array_type & data)
     return messageList;
 }
 
+SmlView::SmlView()
+: _position(0)
+, _valueStartPos(0)
+, _dataLen(0)
+, _dataType(SmlData::DT_STRING)
+, _endOfMsg(false)
+{
+}
+
+SmlView::SmlView(span_type data, size_t position)
+: SmlView()
+{
+    ErrorKind errorKind = Decode(data, position);
+    if (errorKind != EK_NONE)
+        throw SmlData::Error(format("SmlView: {} at position {} (data size {})", GetErrorKindName(errorKind), position, data.size()));
+}
+
+Result<SmlView> SmlView::TryCreate(span_type data, size_t position)
+{
+    SmlView view;
+
+    ErrorKind errorKind = view.Decode(data, position);
+    if (errorKind != EK_NONE)
+        return Failure(errorKind);
+
+    return view;
+}
+
+ErrorKind SmlView::Decode(span_type data, size_t position)
+{
+    _data = data;
+    _position = position;
+    _valueStartPos = position + 1;
+
+    if (position >= data.size())
+        return EK_OUT_OF_RANGE;
+
+    if (data[position] == 0)
+    {
+        _endOfMsg = true;
+        return EK_NONE;
+    }
+
+    int tlFieldSize, dataLen;
+    if (!SmlData::DecodeTypeLengthField(data, (int)position, tlFieldSize, _dataType, dataLen))
+        return EK_OUT_OF_RANGE;
+
+    _valueStartPos = position + tlFieldSize;
+    _dataLen = dataLen;
+
+    if (_dataType == SmlData::DT_LIST)
+        return EK_NONE;
+
+    bool isValid = false;
+
+    switch (_dataType)
+    {
+    case SmlData::DT_STRING:
+        isValid = (dataLen >= tlFieldSize);
+        break;
+
+    case SmlData::DT_BOOL:
+        isValid = (dataLen == 2);
+        break;
+
+    case SmlData::DT_INTEGER:
+    case SmlData::DT_UNSIGNED:
+        isValid = (dataLen >= 2) && (dataLen <= 9) && (dataLen > tlFieldSize);
+        break;
+
+    default:
+        break;
+    }
+
+    if (!isValid)
+        return EK_INVALID_DATA;
+
+    if (position + _dataLen > data.size())
+        return EK_OUT_OF_RANGE;
+
+    return EK_NONE;
+}
+
+void SmlView::AssertIsDataType(SmlData::DataType expectedDataType) const
+{
+    if (_endOfMsg)
+    {
+        throw SmlData::Error(format("SmlView: data type expexted {} but is end of message.",
+            SmlData::DataTypeToString(expectedDataType)));
+    }
+
+    if (_dataType != expectedDataType)
+    {
+        throw SmlData::Error(format("SmlView: data type expexted {} but is {}.",
+            SmlData::DataTypeToString(expectedDataType), SmlData::DataTypeToString(_dataType)));
+    }
+}
+
+SmlView::span_type SmlView::GetString() const
+{
+    AssertIsDataType(SmlData::DT_STRING);
+    return _data.subspan(_valueStartPos, _position + _dataLen - _valueStartPos);
+}
+
+bool SmlView::GetBool() const
+{
+    AssertIsDataType(SmlData::DT_BOOL);
+    return _data[_valueStartPos] != 0;
+}
+
+int64_t SmlView::GetInteger() const
+{
+    AssertIsDataType(SmlData::DT_INTEGER);
+    return DecodeIntegerBigEndian(_data, (int)_valueStartPos, (int)(_position + _dataLen - _valueStartPos));
+}
+
+uint64_t SmlView::GetUnsigned() const
+{
+    AssertIsDataType(SmlData::DT_UNSIGNED);
+    return DecodeUnsignedBigEndian(_data, (int)_valueStartPos, (int)(_position + _dataLen - _valueStartPos));
+}
+
+Result<SmlView::span_type> SmlView::TryGetString() const
+{
+    if (!IsString())
+        return Failure(EK_DATA_TYPE_MISMATCH);
+
+    return _data.subspan(_valueStartPos, _position + _dataLen - _valueStartPos);
+}
+
+Result<int64_t> SmlView::TryGetInteger() const
+{
+    if (!IsInteger())
+        return Failure(EK_DATA_TYPE_MISMATCH);
+
+    return DecodeIntegerBigEndian(_data, (int)_valueStartPos, (int)(_position + _dataLen - _valueStartPos));
+}
+
+Result<uint64_t> SmlView::TryGetUnsigned() const
+{
+    if (!IsUnsigned())
+        return Failure(EK_DATA_TYPE_MISMATCH);
+
+    return DecodeUnsignedBigEndian(_data, (int)_valueStartPos, (int)(_position + _dataLen - _valueStartPos));
+}
+
+SmlView SmlView::GetListItem(size_t index) const
+{
+    AssertIsDataType(SmlData::DT_LIST);
+
+    if (index >= _dataLen)
+        throw SmlData::Error(format("SmlView: list index {} is out of range (list size {})", index, _dataLen));
+
+    auto item = TryGetListItem(index);
+    if (!item)
+        throw SmlData::Error(format("SmlView: list item {}: {}", index, GetErrorKindName(item.GetErrorKind())));
+
+    return *item;
+}
+
+Result<SmlView> SmlView::TryGetListItem(size_t index) const
+{
+    if (!IsList())
+        return Failure(EK_DATA_TYPE_MISMATCH);
+
+    if (index >= _dataLen)
+        return Failure(EK_OUT_OF_RANGE);
+
+    size_t position = _valueStartPos;
+
+    for (size_t idx = 0; idx < index; idx++)
+    {
+        auto item = TryCreate(_data, position);
+        if (!item)
+            return item;
+
+        auto endPosition = item->TryGetEndPosition();
+        if (!endPosition)
+            return Failure(endPosition.GetErrorKind());
+
+        position = *endPosition;
+    }
+
+    return TryCreate(_data, position);
+}
+
+SmlView SmlView::Select(const SmlPath & path) const
+{
+    SmlView item = *this;
+
+    for (size_t level = 0; level < path.GetDepth(); level++)
+        item = item.GetListItem(path[level]);
+
+    return item;
+}
+
+Result<SmlView> SmlView::TrySelect(const SmlPath & path) const
+{
+    Result<SmlView> item = *this;
+
+    for (size_t level = 0; (level < path.GetDepth()) && item; level++)
+        item = item->TryGetListItem(path[level]);
+
+    return item;
+}
+
+SmlView::Iterator SmlView::begin() const
+{
+    AssertIsDataType(SmlData::DT_LIST);
+    return Iterator(_data, _valueStartPos, _data.size(), _dataLen);
+}
+
+SmlView::Iterator SmlView::end() const
+{
+    return Iterator();
+}
+
+size_t SmlView::GetEndPosition() const
+{
+    auto endPosition = TryGetEndPosition();
+    if (!endPosition)
+        throw SmlData::Error(format("SmlView: {} in list at position {}", GetErrorKindName(endPosition.GetErrorKind()), _position));
+
+    return *endPosition;
+}
+
+Result<size_t> SmlView::TryGetEndPosition() const
+{
+    if (_endOfMsg)
+        return _position + 1;
+
+    if (_dataType != SmlData::DT_LIST)
+        return _position + _dataLen;
+
+    size_t position = _valueStartPos;
+
+    for (size_t idx = 0; idx < _dataLen; idx++)
+    {
+        auto item = TryCreate(_data, position);
+        if (!item)
+            return Failure(item.GetErrorKind());
+
+        auto endPosition = item->TryGetEndPosition();
+        if (!endPosition)
+            return endPosition;
+
+        position = *endPosition;
+    }
+
+    return position;
+}
+
+SmlView::Iterator::Iterator()
+: _endPosition(0)
+, _remainingItems(0)
+{
+}
+
+SmlView::Iterator::Iterator(span_type data, size_t position, size_t endPosition, size_t numberOfItems)
+: _data(data)
+, _endPosition(endPosition)
+, _remainingItems(numberOfItems)
+{
+    if (position >= _endPosition)
+        _remainingItems = 0;
+
+    if (_remainingItems > 0)
+        _item = SmlView(_data, position);
+}
+
+SmlView::Iterator & SmlView::Iterator::operator++()
+{
+    if (IsEnd())
+        return *this;
+
+    size_t position = _item.GetEndPosition();
+    _remainingItems--;
+
+    if (position >= _endPosition)
+        _remainingItems = 0;
+
+    if (!IsEnd())
+        _item = SmlView(_data, position);
+
+    return *this;
+}
+
+SmlFrameView::SmlFrameView()
+: _lastMsgBodyIndex(0)
+{
+}
 
+SmlFrameView::SmlFrameView(SmlView::span_type data, bool checkChecksum)
+: _data(data)
+, _lastMsgBodyIndex(CheckSmlFrame(data, checkChecksum))
+{
+}
+
+Result<SmlFrameView> SmlFrameView::TryCreate(SmlView::span_type data, bool checkChecksum)
+{
+    auto lastMsgBodyIndex = TryCheckSmlFrame(data, checkChecksum);
+    if (!lastMsgBodyIndex)
+        return Failure(lastMsgBodyIndex.GetErrorKind());
+
+    SmlFrameView frame;
+    frame._data = data;
+    frame._lastMsgBodyIndex = *lastMsgBodyIndex;
+
+    return frame;
+}
+
+SmlView SmlFrameView::GetMessage(size_t index) const
+{
+    size_t idx = 0;
+
+    for (const SmlView & message : *this)
+    {
+        if (idx == index)
+            return message;
+
+        idx++;
+    }
+
+    throw SmlData::Error(format("SmlFrameView: message index {} is out of range ({} messages)", index, idx));
+}
+
+Result<SmlView> SmlFrameView::TryGetMessage(size_t index) const
+{
+    size_t position = 8;
+
+    for (size_t idx = 0; position < _lastMsgBodyIndex; idx++)
+    {
+        auto message = SmlView::TryCreate(_data, position);
+        if (!message || (idx == index))
+            return message;
+
+        auto endPosition = message->TryGetEndPosition();
+        if (!endPosition)
+            return Failure(endPosition.GetErrorKind());
+
+        position = *endPosition;
+    }
+
+    return Failure(EK_NOT_FOUND);
+}
+
+SmlView SmlFrameView::Select(const SmlPath & path) const
+{
+    if (path.GetDepth() == 0)
+        throw SmlData::Error("SmlFrameView: empty path");
+
+    SmlView item = GetMessage(path[0]);
+
+    for (size_t level = 1; level < path.GetDepth(); level++)
+        item = item.GetListItem(path[level]);
+
+    return item;
+}
+
+SmlView SmlFrameView::FindMessage(uint64_t messageBodyTag) const
+{
+    return FindMessage([messageBodyTag](const SmlView & message) { return GetMessageBodyTag(message) == messageBodyTag; });
+}
+
+Result<SmlView> SmlFrameView::TryFindMessage(uint64_t messageBodyTag) const
+{
+    size_t position = 8;
+
+    while (position < _lastMsgBodyIndex)
+    {
+        auto message = SmlView::TryCreate(_data, position);
+        if (!message)
+            return message;
+
+        auto tag = TryGetMessageBodyTag(*message);
+        if (tag && (*tag == messageBodyTag))
+            return message;
+
+        auto endPosition = message->TryGetEndPosition();
+        if (!endPosition)
+            return Failure(endPosition.GetErrorKind());
+
+        position = *endPosition;
+    }
+
+    return Failure(EK_NOT_FOUND);
+}
+
+uint64_t SmlFrameView::GetMessageBodyTag(const SmlView & message)
+{
+    // message: transaction ID, group number, abort on error, message body (tag, content), CRC, end of message
+    return message.GetListItem(3).GetListItem(0).GetUnsigned();
+}
+
+Result<uint64_t> SmlFrameView::TryGetMessageBodyTag(const SmlView & message)
+{
+    auto messageBody = message.TryGetListItem(3);
+    if (!messageBody)
+        return Failure(messageBody.GetErrorKind());
+
+    auto tag = messageBody->TryGetListItem(0);
+    if (!tag)
+        return Failure(tag.GetErrorKind());
+
+    return tag->TryGetUnsigned();
+}
+
+SmlView::Iterator SmlFrameView::begin() const
+{
+    return SmlView::Iterator(_data, 8, _lastMsgBodyIndex, SIZE_MAX);
+}
+
+SmlView::Iterator SmlFrameView::end() const
+{
+    return SmlView::Iterator();
+}
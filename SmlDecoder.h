@@ -28,9 +28,17 @@ IN THE SOFTWARE.
 #include <string>
 #include <memory>
 #include <cstdint>
+#include <cstddef>
 #include <ostream>
 #include <stdexcept>
 #include <format>
+#include <span>
+#include <iterator>
+#include <array>
+#include <string_view>
+#include <initializer_list>
+
+#include "Result.h"
 
 /// @brief Represents the decoded SML data.
 class SmlData
@@ -111,8 +119,11 @@ private:
     /// @param tlFieldSize The number of type length field read.
     /// @param dataType The decoded data type.
     /// @param dataLen The decoded data length.
-    static void DecodeTypeLengthField(const byte_array_type & data, int position,
+    /// @return False if the type length field exceeds the data.
+    static bool DecodeTypeLengthField(std::span<const uint8_t> data, int position,
         int & tlFieldSize, DataType & dataType, int & dataLen);
+
+    friend class SmlView;
 };
 
 /// @brief Checks if the check sum of the SML message is valid.
@@ -124,3 +135,333 @@ bool CheckIfSmlIsValid(const SmlData::byte_array_type & data);
 /// @param data The raw byte data of the SML messages.
 /// @return The list of decoded messages.
 SmlData::list_type DecodeSmlMessages(const SmlData::byte_array_type & data);
+
+/// @brief A compiled path to a value inside the SML data, e.g. "1.3.1.4" (message 1, list item 3, list item 1, list item 4).
+/// All values which are not on the path are skipped but not decoded.
+class SmlPath
+{
+public:
+    /// @brief The maximum number of path elements.
+    constexpr static size_t MAX_DEPTH = 12;
+
+    /// @brief Constructor.
+    /// @param indices The list indices.
+    constexpr SmlPath(std::initializer_list<size_t> indices)
+    : _indices{}
+    , _depth(0)
+    {
+        if (indices.size() > MAX_DEPTH)
+            throw SmlData::Error("SmlPath: too many path elements");
+
+        for (size_t index : indices)
+            _indices[_depth++] = index;
+    }
+
+    /// @brief Constructor. Parses a path of dot separated list indices, e.g. "1.3.1.4".
+    /// @param path The path.
+    constexpr explicit SmlPath(std::string_view path)
+    : _indices{}
+    , _depth(0)
+    {
+        bool hasDigit = false;
+
+        for (char c : path)
+        {
+            if ((c >= '0') && (c <= '9'))
+            {
+                if (_depth >= MAX_DEPTH)
+                    throw SmlData::Error("SmlPath: too many path elements");
+
+                _indices[_depth] = _indices[_depth] * 10 + (size_t)(c - '0');
+                hasDigit = true;
+            }
+            else if ((c == '.') && hasDigit)
+            {
+                _depth++;
+                hasDigit = false;
+            }
+            else
+            {
+                throw SmlData::Error("SmlPath: invalid path");
+            }
+        }
+
+        if (!hasDigit)
+            throw SmlData::Error("SmlPath: invalid path");
+
+        _depth++;
+    }
+
+    /// @brief Returns the number of path elements.
+    /// @return The number of path elements.
+    constexpr size_t GetDepth() const { return _depth; }
+
+    /// @brief Returns a path element.
+    /// @param level The level of the path element.
+    /// @return The list index at this level.
+    constexpr size_t operator[](size_t level) const { return _indices[level]; }
+
+private:
+    std::array<size_t, MAX_DEPTH> _indices;
+    size_t _depth;
+};
+
+/// @brief Read-only view of one SML value inside the raw SML data.
+/// Nothing is copied, strings refer to the raw data and lists are decoded lazily while iterating.
+/// The raw data must outlive the view.
+class SmlView
+{
+public:
+
+    typedef std::span<const uint8_t> span_type;
+
+    class Iterator;
+
+    /// @brief Constructor. Creates an empty view.
+    SmlView();
+
+    /// @brief Constructor. Decodes the type length field of the value at the specified position.
+    /// @param data The raw SML binary data.
+    /// @param position The position of the value.
+    SmlView(span_type data, size_t position);
+
+    /// @brief Decodes the type length field of the value at the specified position. Does not throw exceptions.
+    /// @param data The raw SML binary data.
+    /// @param position The position of the value.
+    /// @return The view or EK_OUT_OF_RANGE, EK_INVALID_DATA.
+    static Result<SmlView> TryCreate(span_type data, size_t position);
+
+    /// @brief Returns the data type.
+    /// @return The data type.
+    SmlData::DataType GetDataType() const { return _dataType; }
+
+    /// @brief Checks if this is the end of message marker (0x00).
+    /// @return True if this is the end of message marker.
+    bool IsEndOfMessage() const { return _endOfMsg; }
+
+    bool IsBool() const { return !_endOfMsg && _dataType == SmlData::DT_BOOL; }
+    bool IsInteger() const { return !_endOfMsg && _dataType == SmlData::DT_INTEGER; }
+    bool IsUnsigned() const { return !_endOfMsg && _dataType == SmlData::DT_UNSIGNED; }
+    bool IsString() const { return !_endOfMsg && _dataType == SmlData::DT_STRING; }
+    bool IsList() const { return !_endOfMsg && _dataType == SmlData::DT_LIST; }
+
+    /// @brief Returns the octet string. The returned span refers to the raw data.
+    /// @return The octet string.
+    span_type GetString() const;
+
+    bool GetBool() const;
+    int64_t GetInteger() const;
+    uint64_t GetUnsigned() const;
+
+    // non-throwing getters, they return EK_DATA_TYPE_MISMATCH if the data type does not match
+    Result<span_type> TryGetString() const;
+    Result<int64_t> TryGetInteger() const;
+    Result<uint64_t> TryGetUnsigned() const;
+
+    /// @brief Returns the number of list items (including an end of message marker).
+    /// @return The number of list items.
+    size_t GetListSize() const { AssertIsDataType(SmlData::DT_LIST); return _dataLen; }
+
+    /// @brief Returns a list item. All previous items are skipped but not decoded.
+    /// @param index The index of the list item.
+    /// @return The list item.
+    SmlView GetListItem(size_t index) const;
+
+    /// @brief Returns a list item. All previous items are skipped but not decoded. Does not throw exceptions.
+    /// @param index The index of the list item.
+    /// @return The list item or EK_DATA_TYPE_MISMATCH, EK_OUT_OF_RANGE, EK_INVALID_DATA.
+    Result<SmlView> TryGetListItem(size_t index) const;
+
+    /// @brief Returns the value at the end of a path relative to this value. Values which are not on the path are skipped but not decoded.
+    /// @param path The path, each element is a list index.
+    /// @return The value.
+    SmlView Select(const SmlPath & path) const;
+
+    /// @brief Returns the value at the end of a path relative to this value. Does not throw exceptions.
+    /// @param path The path, each element is a list index.
+    /// @return The value or EK_DATA_TYPE_MISMATCH, EK_OUT_OF_RANGE, EK_INVALID_DATA.
+    Result<SmlView> TrySelect(const SmlPath & path) const;
+
+    /// @brief Calls a function for each list item (except an end of message marker). Does not throw exceptions.
+    /// @tparam Function Callable void(const SmlView & item).
+    /// @param function The function.
+    /// @return Success or EK_DATA_TYPE_MISMATCH, EK_OUT_OF_RANGE, EK_INVALID_DATA.
+    template <typename Function>
+    Result<void> TryForEachListItem(Function function) const
+    {
+        if (!IsList())
+            return Failure(EK_DATA_TYPE_MISMATCH);
+
+        size_t position = _valueStartPos;
+
+        for (size_t idx = 0; idx < _dataLen; idx++)
+        {
+            auto item = TryCreate(_data, position);
+            if (!item)
+                return Failure(item.GetErrorKind());
+
+            if (item->IsEndOfMessage())
+                break;
+
+            function(*item);
+
+            auto endPosition = item->TryGetEndPosition();
+            if (!endPosition)
+                return Failure(endPosition.GetErrorKind());
+
+            position = *endPosition;
+        }
+
+        return {};
+    }
+
+    Iterator begin() const;
+    Iterator end() const;
+
+    /// @brief Returns the position of the value in the raw data.
+    /// @return The position of the type length field.
+    size_t GetPosition() const { return _position; }
+
+    /// @brief Returns the position after the value. For lists all items are skipped.
+    /// @return The position after the value.
+    size_t GetEndPosition() const;
+
+    /// @brief Returns the position after the value. For lists all items are skipped. Does not throw exceptions.
+    /// @return The position after the value or EK_OUT_OF_RANGE, EK_INVALID_DATA.
+    Result<size_t> TryGetEndPosition() const;
+
+private:
+    span_type _data;
+    size_t _position;
+    size_t _valueStartPos;
+    size_t _dataLen;
+    SmlData::DataType _dataType;
+    bool _endOfMsg;
+
+    /// @brief Decodes the type length field of the value at the specified position.
+    /// @param data The raw SML binary data.
+    /// @param position The position of the value.
+    /// @return EK_NONE if successful.
+    ErrorKind Decode(span_type data, size_t position);
+
+    void AssertIsDataType(SmlData::DataType expectedDataType) const;
+};
+
+/// @brief Iterates the items of a list (or the messages of a frame) without decoding them in advance.
+class SmlView::Iterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef SmlView value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const SmlView * pointer;
+    typedef const SmlView & reference;
+
+    /// @brief Constructor. Creates the end iterator.
+    Iterator();
+
+    /// @brief Constructor.
+    /// @param data The raw SML binary data.
+    /// @param position The position of the first item.
+    /// @param endPosition The position after the last item.
+    /// @param numberOfItems The maximum number of items.
+    Iterator(span_type data, size_t position, size_t endPosition, size_t numberOfItems);
+
+    reference operator*() const { return _item; }
+    pointer operator->() const { return &_item; }
+
+    Iterator & operator++();
+    Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+
+    bool operator==(const Iterator & other) const { return IsEnd() == other.IsEnd() && (IsEnd() || _item.GetPosition() == other._item.GetPosition()); }
+
+private:
+    span_type _data;
+    size_t _endPosition;
+    size_t _remainingItems;
+    SmlView _item;
+
+    bool IsEnd() const { return _remainingItems == 0; }
+};
+
+/// @brief Read-only view of a complete SML frame. The escape sequences and the checksum are checked on construction.
+/// The raw data must outlive the view.
+class SmlFrameView
+{
+public:
+
+    /// @brief SML message body tag of the GetList response.
+    constexpr static uint64_t GET_LIST_RESPONSE = 0x0701;
+
+    /// @brief Constructor. Checks the SML frame.
+    /// @param data The raw byte data of the SML messages.
+    /// @param checkChecksum False if the checksum was already checked (e.g. by the SmlFramer).
+    SmlFrameView(SmlView::span_type data, bool checkChecksum = true);
+
+    /// @brief Checks the SML frame. Does not throw exceptions.
+    /// @param data The raw byte data of the SML messages.
+    /// @param checkChecksum False if the checksum was already checked (e.g. by the SmlFramer).
+    /// @return The frame view or EK_INVALID_FRAME, EK_CHECKSUM_ERROR.
+    static Result<SmlFrameView> TryCreate(SmlView::span_type data, bool checkChecksum = true);
+
+    /// @brief Returns a message. All previous messages are skipped but not decoded.
+    /// @param index The index of the message.
+    /// @return The message.
+    SmlView GetMessage(size_t index) const;
+
+    /// @brief Returns a message. All previous messages are skipped but not decoded. Does not throw exceptions.
+    /// @param index The index of the message.
+    /// @return The message or EK_NOT_FOUND, EK_OUT_OF_RANGE, EK_INVALID_DATA.
+    Result<SmlView> TryGetMessage(size_t index) const;
+
+    /// @brief Returns the value at the end of a path. The first path element is the message index.
+    /// Values which are not on the path are skipped but not decoded.
+    /// @param path The path.
+    /// @return The value.
+    SmlView Select(const SmlPath & path) const;
+
+    /// @brief Returns the first message matching a predicate.
+    /// @tparam Predicate Callable bool(const SmlView & message).
+    /// @param predicate The predicate.
+    /// @return The message.
+    template <typename Predicate>
+    SmlView FindMessage(Predicate predicate) const
+    {
+        for (const SmlView & message : *this)
+        {
+            if (predicate(message))
+                return message;
+        }
+
+        throw SmlData::Error("SmlFrameView: no matching message found");
+    }
+
+    /// @brief Returns the first message with the specified message body tag.
+    /// @param messageBodyTag The message body tag, e.g. GET_LIST_RESPONSE.
+    /// @return The message.
+    SmlView FindMessage(uint64_t messageBodyTag) const;
+
+    /// @brief Returns the first message with the specified message body tag. Does not throw exceptions.
+    /// @param messageBodyTag The message body tag, e.g. GET_LIST_RESPONSE.
+    /// @return The message or EK_NOT_FOUND, EK_DATA_TYPE_MISMATCH, EK_OUT_OF_RANGE, EK_INVALID_DATA.
+    Result<SmlView> TryFindMessage(uint64_t messageBodyTag) const;
+
+    /// @brief Returns the message body tag of a message.
+    /// @param message The message.
+    /// @return The message body tag.
+    static uint64_t GetMessageBodyTag(const SmlView & message);
+
+    /// @brief Returns the message body tag of a message. Does not throw exceptions.
+    /// @param message The message.
+    /// @return The message body tag or EK_DATA_TYPE_MISMATCH, EK_OUT_OF_RANGE, EK_INVALID_DATA.
+    static Result<uint64_t> TryGetMessageBodyTag(const SmlView & message);
+
+    SmlView::Iterator begin() const;
+    SmlView::Iterator end() const;
+
+private:
+    SmlView::span_type _data;
+    size_t _lastMsgBodyIndex;
+
+    SmlFrameView();
+};
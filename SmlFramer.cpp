@@ -0,0 +1,200 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "SmlFramer.h"
+#include "Checksum.h"
+
+#include <algorithm>
+
+using namespace std;
+
+static const uint8_t ESCAPE_SEQUENCE[] = { 0x1B, 0x1B, 0x1B, 0x1B };
+
+static const uint8_t START_SEQUENCE[] = { 0x1B, 0x1B, 0x1B, 0x1B, 0x01, 0x01, 0x01, 0x01 };
+
+static const uint8_t START_BLOCK[] = { 0x01, 0x01, 0x01, 0x01 };
+
+constexpr static uint8_t SML_END = 0x1A;
+
+SmlFramer::SmlFramer()
+: _state(S_SEARCH_START)
+, _startSequencePosition(0)
+, _blockSize(0)
+, _crc(Checksum::CRC16_X25_START_VALUE)
+, _numberOfDiscardedFrames(0)
+{
+    _frame.reserve(MAX_FRAME_SIZE);
+}
+
+void SmlFramer::Reset()
+{
+    _state = S_SEARCH_START;
+    _frame.clear();
+    _startSequencePosition = 0;
+    _blockSize = 0;
+    _crc = Checksum::CRC16_X25_START_VALUE;
+}
+
+std::span<const uint8_t> SmlFramer::GetFrame() const
+{
+    if (_state != S_COMPLETE)
+        return span<const uint8_t>();
+
+    return _frame;
+}
+
+size_t SmlFramer::Feed(std::span<const uint8_t> data)
+{
+    if (_state == S_COMPLETE)
+        Reset();
+
+    for (size_t idx = 0; idx < data.size(); idx++)
+    {
+        ProcessByte(data[idx]);
+
+        if (_state == S_COMPLETE)
+            return idx + 1;
+    }
+
+    return data.size();
+}
+
+void SmlFramer::ProcessByte(uint8_t b)
+{
+    if (_state == S_SEARCH_START)
+    {
+        // the start of a frame is not aligned to the received data, search it byte by byte
+        if (b == START_SEQUENCE[_startSequencePosition])
+        {
+            _startSequencePosition++;
+        }
+        else if (b == ESCAPE_SEQUENCE[0])
+        {
+            // after 1B1B1B1B another 1B still leaves four escape bytes in a row
+            _startSequencePosition = (_startSequencePosition == 4) ? 4 : 1;
+        }
+        else
+        {
+            _startSequencePosition = 0;
+        }
+
+        if (_startSequencePosition == sizeof(START_SEQUENCE))
+            StartFrame();
+
+        return;
+    }
+
+    // after the start sequence the frame consists of 4 byte blocks, a start sequence within
+    // the frame is only recognized at a block boundary (escape block followed by 01010101)
+    _block[_blockSize++] = b;
+    if (_blockSize == sizeof(_block))
+    {
+        ProcessBlock();
+        _blockSize = 0;
+    }
+}
+
+void SmlFramer::ProcessBlock()
+{
+    span<const uint8_t> block(_block, sizeof(_block));
+
+    if (_frame.size() + 2 * sizeof(_block) > MAX_FRAME_SIZE)
+    {
+        DiscardFrame();
+        return;
+    }
+
+    if (_state == S_DATA)
+    {
+        if (equal(block.begin(), block.end(), begin(ESCAPE_SEQUENCE)))
+            _state = S_ESCAPE;
+        else
+            AppendToFrame(block);
+
+        return;
+    }
+
+    // the block after an escape sequence
+    if (equal(block.begin(), block.end(), begin(ESCAPE_SEQUENCE)))
+    {
+        // escaped 1B1B1B1B within the message data
+        AppendToFrame(ESCAPE_SEQUENCE);
+        AppendToFrame(block);
+        _state = S_DATA;
+    }
+    else if (equal(block.begin(), block.end(), begin(START_BLOCK)))
+    {
+        // start sequence of the next frame, the current frame was truncated
+        _numberOfDiscardedFrames++;
+        StartFrame();
+    }
+    else if (block[0] == SML_END)
+    {
+        // end sequence: 1A, number of fill bytes, checksum (little endian)
+        AppendToFrame(ESCAPE_SEQUENCE);
+        AppendToFrame(block.first(2));
+
+        uint16_t checkSum1 = block[2] | (block[3] << 8);
+        uint16_t checkSum2 = _crc ^ 0xFFFF;
+
+        _frame.insert(_frame.end(), block.begin() + 2, block.end());
+
+        if (checkSum1 == checkSum2)
+            _state = S_COMPLETE;
+        else
+            DiscardFrame();
+    }
+    else
+    {
+        DiscardFrame();
+    }
+}
+
+void SmlFramer::StartFrame()
+{
+    _frame.clear();
+    _crc = Checksum::CRC16_X25_START_VALUE;
+    _blockSize = 0;
+    _startSequencePosition = 0;
+
+    AppendToFrame(START_SEQUENCE);
+
+    _state = S_DATA;
+}
+
+void SmlFramer::AppendToFrame(std::span<const uint8_t> data)
+{
+    _frame.insert(_frame.end(), data.begin(), data.end());
+    _crc = Checksum::UpdateCrc16X25(_crc, data);
+}
+
+void SmlFramer::DiscardFrame()
+{
+    _numberOfDiscardedFrames++;
+
+    _state = S_SEARCH_START;
+    _frame.clear();
+    _startSequencePosition = 0;
+    _blockSize = 0;
+}
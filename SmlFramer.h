@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+/// @brief Push style framer for SML frames. Received bytes can be fed in arbitrary chunks.
+/// The framer searches the start sequence (1B1B1B1B 01010101), follows the escape sequences,
+/// updates the checksum while receiving and detects the end sequence (1B1B1B1B 1A).
+/// A complete frame is available as soon as its last byte was fed. Within a frame the start sequence is
+/// only recognized at a 4 byte block boundary, so escaped data (1B1B1B1B 1B1B1B1B 01010101) does not restart it.
+class SmlFramer
+{
+public:
+    /// @brief Frames larger than this are discarded.
+    constexpr static size_t MAX_FRAME_SIZE = 4096;
+
+    /// @brief Constructor.
+    SmlFramer();
+
+    SmlFramer(const SmlFramer &) = delete;
+    SmlFramer & operator=(const SmlFramer &) = delete;
+
+    /// @brief Discards all received data and starts searching for a new frame.
+    void Reset();
+
+    /// @brief Feeds received bytes into the framer. Stops after a complete frame was found.
+    /// If the previous frame was complete, the search for a new frame is started first.
+    /// @param data The received bytes.
+    /// @return The number of bytes consumed. (Less than the data size if a frame was completed.)
+    size_t Feed(std::span<const uint8_t> data);
+
+    /// @brief Checks if a complete frame with valid checksum was received.
+    /// @return True if the frame is complete.
+    bool IsFrameComplete() const { return _state == S_COMPLETE; }
+
+    /// @brief Returns the complete frame (including escape sequences and checksum).
+    /// @return The frame, empty if the frame is not complete.
+    std::span<const uint8_t> GetFrame() const;
+
+    /// @brief Returns the number of frames discarded because of checksum errors, invalid escape sequences or size.
+    /// @return The number of discarded frames.
+    size_t GetNumberOfDiscardedFrames() const { return _numberOfDiscardedFrames; }
+
+private:
+    enum State
+    {
+        S_SEARCH_START,
+        S_DATA,
+        S_ESCAPE,
+        S_COMPLETE
+    };
+
+    State _state;
+    std::vector<uint8_t> _frame;
+    size_t _startSequencePosition;
+    uint8_t _block[4];
+    size_t _blockSize;
+    uint16_t _crc;
+    size_t _numberOfDiscardedFrames;
+
+    /// @brief Processes one received byte.
+    /// @param b The received byte.
+    void ProcessByte(uint8_t b);
+
+    /// @brief Processes a complete 4 byte block of the frame.
+    void ProcessBlock();
+
+    /// @brief Starts a new frame after the start sequence was received.
+    void StartFrame();
+
+    /// @brief Appends data to the frame and updates the checksum.
+    /// @param data The data to append.
+    void AppendToFrame(std::span<const uint8_t> data);
+
+    /// @brief Discards the current frame and starts searching for a new frame.
+    void DiscardFrame();
+};
@@ -0,0 +1,128 @@
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include "SolarPosition.h"
+
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+
+using namespace std;
+using namespace std::chrono;
+
+// minutes per day
+constexpr static double MINUTES_PER_DAY = 1440.0;
+
+static double DegToRad(double deg)
+{
+    return deg * numbers::pi / 180.0;
+}
+
+static double RadToDeg(double rad)
+{
+    return rad * 180.0 / numbers::pi;
+}
+
+SolarPosition::SolarPosition(double latitude, double longitude)
+: _latitude(latitude)
+, _longitude(longitude)
+{
+}
+
+SolarPosition::SunParameters SolarPosition::GetSunParameters(const time_point_type & time)
+{
+    // julian centuries since J2000.0 (the unix epoch is julian day 2440587.5)
+    double julianDay = duration<double>(time.time_since_epoch()).count() / 86400.0 + 2440587.5;
+    double t = (julianDay - 2451545.0) / 36525.0;
+
+    // geometric mean longitude, mean anomaly and orbit eccentricity
+    double meanLongitude = fmod(280.46646 + t * (36000.76983 + t * 0.0003032), 360.0);
+    double meanAnomaly = 357.52911 + t * (35999.05029 - 0.0001537 * t);
+    double eccentricity = 0.016708634 - t * (0.000042037 + 0.0000001267 * t);
+
+    double m = DegToRad(meanAnomaly);
+    double equationOfCenter = sin(m) * (1.914602 - t * (0.004817 + 0.000014 * t))
+        + sin(2.0 * m) * (0.019993 - 0.000101 * t)
+        + sin(3.0 * m) * 0.000289;
+
+    // apparent longitude of the sun
+    double omega = DegToRad(125.04 - 1934.136 * t);
+    double apparentLongitude = DegToRad(meanLongitude + equationOfCenter - 0.00569 - 0.00478 * sin(omega));
+
+    // obliquity of the ecliptic
+    double meanObliquity = 23.0 + (26.0 + (21.448 - t * (46.815 + t * (0.00059 - t * 0.001813))) / 60.0) / 60.0;
+    double obliquity = DegToRad(meanObliquity + 0.00256 * cos(omega));
+
+    SunParameters parameters;
+    parameters.Declination = asin(sin(obliquity) * sin(apparentLongitude));
+
+    double y = tan(obliquity / 2.0) * tan(obliquity / 2.0);
+    double l0 = DegToRad(meanLongitude);
+
+    parameters.EquationOfTime = 4.0 * RadToDeg(y * sin(2.0 * l0)
+        - 2.0 * eccentricity * sin(m)
+        + 4.0 * eccentricity * y * sin(m) * cos(2.0 * l0)
+        - 0.5 * y * y * sin(4.0 * l0)
+        - 1.25 * eccentricity * eccentricity * sin(2.0 * m));
+
+    return parameters;
+}
+
+double SolarPosition::GetElevation(const time_point_type & time) const
+{
+    auto sun = GetSunParameters(time);
+
+    // true solar time and hour angle
+    double minutesOfDay = fmod(duration<double, ratio<60>>(time.time_since_epoch()).count(), MINUTES_PER_DAY);
+    double trueSolarTime = fmod(minutesOfDay + sun.EquationOfTime + 4.0 * _longitude + MINUTES_PER_DAY, MINUTES_PER_DAY);
+    double hourAngle = DegToRad(trueSolarTime / 4.0 - 180.0);
+
+    double latitude = DegToRad(_latitude);
+    double cosZenith = sin(latitude) * sin(sun.Declination) + cos(latitude) * cos(sun.Declination) * cos(hourAngle);
+
+    return 90.0 - RadToDeg(acos(clamp(cosZenith, -1.0, 1.0)));
+}
+
+bool SolarPosition::GetSunriseSunset(const time_point_type & time, time_point_type & sunrise, time_point_type & sunset) const
+{
+    // start of the UTC day, the sun parameters are taken at noon
+    auto dayStart = floor<days>(time);
+    auto sun = GetSunParameters(dayStart + hours(12));
+
+    double latitude = DegToRad(_latitude);
+    double cosHourAngle = (cos(DegToRad(90.0 - SUNRISE_ELEVATION)) - sin(latitude) * sin(sun.Declination))
+        / (cos(latitude) * cos(sun.Declination));
+
+    // polar night or midnight sun
+    if ((cosHourAngle < -1.0) || (cosHourAngle > 1.0))
+        return false;
+
+    double hourAngle = RadToDeg(acos(cosHourAngle));
+    double solarNoonMinutes = 720.0 - 4.0 * _longitude - sun.EquationOfTime;
+
+    sunrise = dayStart + duration_cast<system_clock::duration>(duration<double, ratio<60>>(solarNoonMinutes - 4.0 * hourAngle));
+    sunset = dayStart + duration_cast<system_clock::duration>(duration<double, ratio<60>>(solarNoonMinutes + 4.0 * hourAngle));
+
+    return true;
+}
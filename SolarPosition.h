@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+Copyright (C) 2025  Torsten Brischalle
+email: torsten@brischalle.de
+web: http://www.aaabbb.de
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to
+deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+*/
+
+#include <chrono>
+
+/// @brief Computes the position of the sun and the sunrise and sunset times at a location
+/// with the NOAA solar calculation formulas. (Accurate to about one minute, no network needed.)
+class SolarPosition
+{
+public:
+    typedef std::chrono::system_clock::time_point time_point_type;
+
+    // the elevation of the sun center at sunrise and sunset: refraction and sun radius (in °)
+    constexpr static double SUNRISE_ELEVATION = -0.833;
+
+    /// @brief Constructor.
+    /// @param latitude The latitude of the location in ° (north positive).
+    /// @param longitude The longitude of the location in ° (east positive).
+    SolarPosition(double latitude, double longitude);
+
+    /// @brief Returns the elevation of the sun above the horizon (without refraction).
+    /// @param time The point in time.
+    /// @return The elevation in ° (negative if the sun is below the horizon).
+    double GetElevation(const time_point_type & time) const;
+
+    /// @brief Returns the sunrise and sunset times of the (UTC) day of the given point in time.
+    /// @param time A point in time of the day.
+    /// @param sunrise The sunrise time.
+    /// @param sunset The sunset time.
+    /// @return False if the sun does not rise or set on this day (polar night or midnight sun).
+    bool GetSunriseSunset(const time_point_type & time, time_point_type & sunrise, time_point_type & sunset) const;
+
+private:
+    double _latitude;
+    double _longitude;
+
+    /// @brief The position of the sun on the ecliptic at a point in time.
+    struct SunParameters
+    {
+        // declination of the sun (in rad)
+        double Declination;
+
+        // equation of time: true solar time minus mean solar time (in min)
+        double EquationOfTime;
+    };
+
+    /// @brief Computes the declination and the equation of time.
+    /// @param time The point in time.
+    /// @return The sun parameters.
+    static SunParameters GetSunParameters(const time_point_type & time);
+};
@@ -24,7 +24,7 @@ IN THE SOFTWARE.
 
 #include <iostream>
 #include <chrono>
-#include <thread>
+#include <cmath>
 #include <sys/resource.h>
 
 #include "Logger.h"
@@ -33,6 +33,7 @@ IN THE SOFTWARE.
 #include "ElectricityMonitor.h"
 #include "Configuration.h"
 #include "CancellationToken.h"
+#include "SignalHandler.h"
 
 using namespace std;
 
@@ -49,24 +50,143 @@ void ChangeProcessPriority(int newPriority)
     }
 }
 
+/// @brief Returns the additional electricity meter readings of the configuration.
+/// @param configuration The configuration.
+/// @return The names of the additional readings.
+vector <string> GetAdditionalElectricityMeterColumns(const Configuration & configuration)
+{
+    vector <string> additionalElectricityMeterColumns;
+    for (const auto & obisCode : configuration.GetElectricityMeterAdditionalObisCodes())
+        additionalElectricityMeterColumns.push_back(obisCode.Name);
+
+    return additionalElectricityMeterColumns;
+}
+
+/// @brief Rebuilds the rollup tables of the database from the stored readings.
+/// @param configuration The configuration.
+void RebuildRollups(const Configuration & configuration)
+{
+    Database database(configuration.GetDatabaseFilepath(), configuration.GetInverterNumberOfChannels(), GetAdditionalElectricityMeterColumns(configuration),
+        configuration.GetDatabaseCompactStorage());
+
+    LOG_INFO(format("Rebuild the rollup tables of database {}", configuration.GetDatabaseFilepath()));
+    database.RebuildRollups();
+}
+
+/// @brief Writes the readings of a readings table in a time range as CSV to the standard output, including the archived readings.
+/// @param configuration The configuration.
+/// @param tableName The readings table: ElectricityMeter0, ElectricityMeter1 or Inverter.
+/// @param fromTime The start of the time range (in s since the start of the epoch).
+/// @param toTime The end of the time range (in s since the start of the epoch, excluded).
+void ExportReadings(const Configuration & configuration, const string & tableName, const string & fromTime, const string & toTime)
+{
+    Database database(configuration.GetDatabaseFilepath(), configuration.GetInverterNumberOfChannels(), GetAdditionalElectricityMeterColumns(configuration),
+        configuration.GetDatabaseCompactStorage());
+
+    cout << "time";
+    for (const auto & column : database.GetReadingsColumns(tableName))
+        cout << "," << column;
+    cout << "\n";
+
+    database.ReadReadings(tableName, stoll(fromTime), stoll(toTime), [](time_t time, const vector <double> & values)
+    {
+        cout << time;
+
+        // NULL readings are empty
+        for (double value : values)
+            cout << "," << (isnan(value) ? string() : format("{}", value));
+
+        cout << "\n";
+    });
+
+    cout.flush();
+}
+
+/// @brief Runs the electricity monitor and restarts it after an error, until it fails too often or is cancelled.
+/// @param configuration The configuration.
+/// @param cancellationToken Token to stop the electricity monitor.
+void RunElectricityMonitor(Configuration & configuration, const CancellationToken & cancellationToken)
+{
+    int retryCount = 0;
+
+    while (!cancellationToken.IsCancel())
+    {
+        auto startTime = chrono::system_clock::now();
+
+        try
+        {
+            ElectricityMonitor electricityMonitor;
+
+            LOG_INFO("Start electricity monitor");
+            electricityMonitor.Run(configuration, cancellationToken);
+        }
+        catch(const exception& e)
+        {
+            LOG_ERROR(e);
+        }
+        LOG_INFO("Electricity monitor stopped");
+
+        if (cancellationToken.IsCancel())
+            break;
+
+        auto endTime = chrono::system_clock::now();
+        int elapsedTimeMinutes = chrono::duration_cast<chrono::minutes>(endTime - startTime).count();
+        
+        if (elapsedTimeMinutes < 10)
+        {
+            retryCount++;
+            if (retryCount > 3)
+                break;
+        }
+        else
+        {
+            retryCount = 0;
+        }
+
+        LOG_INFO(format("try to restart in {} seconds", RESTART_DELAY));
+
+        if (cancellationToken.WaitFor(RESTART_DELAY))
+            break;
+    }
+}
+
 /// @brief The main entry point of the program.
 /// @param argc The number of command line arguments.
 /// @param argv The command line arguments.
 /// @return The exit code.
 int main(int argc, char **argv)
 {
-    string configurationFile;
-    if (argc > 1)
-        configurationFile = argv[1];
-    else
-        configurationFile = "configuration.json";
+    // usage: MyElectricityMonitor [--rebuild-rollups | --export-readings TABLE FROM TO] [configuration file]
+    string configurationFile = "configuration.json";
+    bool isRebuildRollups = false;
+    vector <string> exportArguments;
+
+    for (int argIdx = 1; argIdx < argc; argIdx++)
+    {
+        string arg = argv[argIdx];
+
+        if (arg == "--rebuild-rollups")
+        {
+            isRebuildRollups = true;
+        }
+        else if ((arg == "--export-readings") && (argIdx + 3 < argc))
+        {
+            exportArguments.assign(argv + argIdx + 1, argv + argIdx + 4);
+            argIdx += 3;
+        }
+        else
+        {
+            configurationFile = arg;
+        }
+    }
 
     try
     {
         // string logFile = Utils::CreateUnixLogFilepath("MyElectricityMonitor");
         // Logger::Instance().OpenLogFile(logFile);
 
-        Logger::Instance().SetOutputStream(cout);
+        // the exported readings are written to the standard output
+        Logger::Instance().SetOutputStream(exportArguments.empty() ? cout : cerr);
 
         LOG_INFO("********************************");
         LOG_INFO("*** PROGRAM STARTET          ***");
@@ -80,43 +200,22 @@ int main(int argc, char **argv)
             Configuration configuration;
             configuration.Load(configurationFile);
 
-            int retryCount = 0;
-            CancellationToken cancellationToken;
-
-            while (true)
+            if (!exportArguments.empty())
+            {
+                ExportReadings(configuration, exportArguments[0], exportArguments[1], exportArguments[2]);
+            }
+            else if (isRebuildRollups)
             {
-                auto startTime = chrono::system_clock::now();
-
-                try
-                {
-                    ElectricityMonitor electricityMonitor;
-
-                    LOG_INFO("Start electricity monitor");
-                    electricityMonitor.Run(configuration, cancellationToken);
-                }
-                catch(const exception& e)
-                {
-                    LOG_ERROR(e);
-                }
-                LOG_INFO("Electricity monitor stopped");
-
-                auto endTime = chrono::system_clock::now();
-                int elapsedTimeMinutes = chrono::duration_cast<chrono::minutes>(endTime - startTime).count();
-                
-                if (elapsedTimeMinutes < 10)
-                {
-                    retryCount++;
-                    if (retryCount > 3)
-                        break;
-                }
-                else
-                {
-                    retryCount = 0;
-                }
-
-                LOG_INFO(format("try to restart in {} seconds", RESTART_DELAY));
-
-                this_thread::sleep_for(chrono::seconds(RESTART_DELAY));
+                // a rebuild stopped by a signal is rolled back by SQLite
+                RebuildRollups(configuration);
+            }
+            else
+            {
+                // SIGTERM and SIGINT stop the program gracefully (created before any thread, so all threads block the signals)
+                CancellationToken cancellationToken;
+                SignalHandler signalHandler(cancellationToken);
+
+                RunElectricityMonitor(configuration, cancellationToken);
             }
         }
         catch(const exception & exc)